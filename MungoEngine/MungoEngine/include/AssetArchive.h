@@ -0,0 +1,178 @@
+#pragma once
+#include "Prerequisites.h"
+#include <mutex>
+
+/**
+ * @brief Bytes of one archive entry, valid while its archive stays open.
+ */
+struct
+	AssetBlob {
+	const void* data = nullptr;
+	size_t size = 0;
+
+	explicit operator bool() const { return data != nullptr; }
+};
+
+/**
+ * @class AssetArchive
+ * @brief Read-only pack file that replaces loose asset files.
+ *
+ * The whole archive is memory-mapped on open(): finding an entry is a
+ * binary search over its sorted table of contents and the returned bytes
+ * point straight into the mapping, so SFML decodes from the page cache
+ * with no file opens and no intermediate copies. Entries stored compressed
+ * (LZ4 block format) are decompressed once, on first use, into a buffer
+ * owned by the archive.
+ *
+ * Entry names are the relative paths given to AssetArchiveBuilder, with
+ * '/' as separator; '\' is accepted in lookups.
+ */
+class
+	AssetArchive {
+public:
+	AssetArchive() = default;
+
+	/**
+	 * @brief Unmaps the archive.
+	 */
+	~AssetArchive();
+
+	AssetArchive(const AssetArchive&) = delete;
+	AssetArchive& operator=(const AssetArchive&) = delete;
+
+	/**
+	 * @brief Maps an archive, closing the previous one.
+	 * @return False if the file is missing or not a valid archive.
+	 */
+	bool
+		open(const std::string& path);
+
+	/**
+	 * @brief Unmaps the archive; blobs returned before are no longer valid.
+	 */
+	void
+		close();
+
+	bool
+		isOpen() const { return m_data != nullptr; }
+
+	const std::string&
+		getPath() const { return m_path; }
+
+	size_t
+		getEntryCount() const { return m_entryCount; }
+
+	/**
+	 * @brief Checks whether the archive has an entry, without reading it.
+	 */
+	bool
+		contains(const std::string& name) const;
+
+	/**
+	 * @brief Returns the bytes of an entry.
+	 *
+	 * Thread safe; uncompressed entries cost only the lookup.
+	 *
+	 * @return Empty blob if there is no such entry or it is corrupt.
+	 */
+	AssetBlob
+		find(const std::string& name) const;
+
+	/**
+	 * @brief Loads a resource from an entry through its loadFromMemory().
+	 *
+	 * Works with Texture, sf::Texture, sf::Image, sf::Font and
+	 * sf::SoundBuffer. sf::Font keeps reading the bytes after loading, so
+	 * the archive must outlive the font.
+	 *
+	 * @return False if the entry is missing or the resource rejects it.
+	 */
+	template<typename T>
+	bool
+		load(const std::string& name, T& resource) const {
+		AssetBlob blob = find(name);
+		return blob && resource.loadFromMemory(blob.data, blob.size);
+	}
+
+private:
+	/**
+	 * @brief Index of an entry in the table of contents, -1 if absent.
+	 */
+	ptrdiff_t
+		findIndex(const std::string& name) const;
+
+	std::string m_path;
+	const char* m_data = nullptr;   ///< Start of the mapping.
+	size_t m_size = 0;              ///< Bytes mapped.
+	const char* m_toc = nullptr;    ///< Table of contents inside the mapping.
+	const char* m_names = nullptr;  ///< Name table inside the mapping.
+	size_t m_entryCount = 0;
+	void* m_file = nullptr;         ///< Windows file handle.
+	void* m_mapping = nullptr;      ///< Windows file mapping handle.
+
+	mutable std::mutex m_decompressMutex;                      ///< Guards m_decompressed.
+	mutable std::vector<std::unique_ptr<char[]>> m_decompressed; ///< Per entry, once used.
+};
+
+/**
+ * @class AssetArchiveBuilder
+ * @brief Writes the pack files read by AssetArchive.
+ *
+ * Layout: header, entry data (each blob aligned), table of contents sorted
+ * by name, and the name table. Integers are little endian.
+ */
+class
+	AssetArchiveBuilder {
+public:
+	/**
+	 * @brief Alignment of every blob in the file (power of two, default 64).
+	 */
+	void
+		setAlignment(uint32_t bytes);
+
+	/**
+	 * @brief Stores entries LZ4 compressed when that saves space. Off by
+	 * default: compressed entries cost a copy when first read, and image
+	 * formats are already compressed.
+	 */
+	void
+		setCompression(bool enabled) { m_compress = enabled; }
+
+	/**
+	 * @brief Adds the contents of a file; a name added again is replaced.
+	 * @param name Name used to find the entry (e.g. "Textures/tile.png").
+	 * @param filePath File to read now.
+	 * @return False if the file could not be read.
+	 */
+	bool
+		addFile(const std::string& name, const std::string& filePath);
+
+	/**
+	 * @brief Adds every file under a directory, named by its path as the
+	 * game opens it (e.g. "Textures" adds "Textures/tile.png").
+	 * @return Number of files added.
+	 */
+	size_t
+		addDirectory(const std::string& directory);
+
+	/**
+	 * @brief Adds bytes from memory; a name added again is replaced.
+	 */
+	void
+		addData(const std::string& name, const void* data, size_t size);
+
+	size_t
+		getEntryCount() const { return m_sources.size(); }
+
+	/**
+	 * @brief Writes the archive.
+	 * @return False if the file could not be written.
+	 */
+	bool
+		write(const std::string& archivePath) const;
+
+private:
+	std::map<std::string, std::vector<char>> m_sources; ///< Sorted by name.
+	uint32_t m_alignment = 64;
+	bool m_compress = false;
+};
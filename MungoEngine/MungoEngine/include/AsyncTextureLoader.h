@@ -0,0 +1,133 @@
+#pragma once
+#include "Prerequisites.h"
+#include "JobSystem.h"
+#include "ResourceManager.h"
+#include "ESC/Texture.h"
+#include <atomic>
+
+/**
+ * @class AsyncTextureLoader
+ * @brief Loads textures without stalling the frame.
+ *
+ * request() returns a Texture handle at once. The file is read and decoded
+ * into an sf::Image by a JobSystem background job, which only the workers
+ * run, so waits inside the frame never decode. The pixels are then copied to
+ * the GPU by processUploads() on the render thread, in bands of rows, only
+ * while the frame has upload time left. The handle becomes ready when the
+ * last band is uploaded, and shapes bound to it start drawing it then
+ * (see CShape::setTexture()).
+ *
+ * Finished textures are added to the ResourceManager, and a path requested
+ * again, while loading or later, gets the same texture. Paths found in the
+ * cache's AssetArchive are decoded from the archive instead of a file.
+ */
+class
+	AsyncTextureLoader {
+public:
+	using Handle = EngineUtilities::TSharedPointer<Texture>;
+
+	/**
+	 * @brief Constructor.
+	 * @param jobs Workers that decode the images.
+	 * @param cache Cache that receives the finished textures.
+	 */
+	AsyncTextureLoader(JobSystem& jobs, ResourceManager<Texture>& cache)
+		: m_jobs(jobs), m_cache(cache) {}
+
+	/**
+	 * @brief Waits for the decode jobs still running.
+	 */
+	~AsyncTextureLoader();
+
+	AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+	AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+	/**
+	 * @brief Starts loading a texture in the background.
+	 * @param path Image file.
+	 * @return Texture handle; not ready (Texture::isReady()) until uploaded.
+	 * If the file cannot be loaded it never becomes ready.
+	 */
+	Handle
+		request(const std::string& path);
+
+	/**
+	 * @brief Blocks until every decode job has finished.
+	 *
+	 * Decode jobs read through the mounted archive; call this before
+	 * closing or remounting it.
+	 */
+	void
+		waitForDecodes() { m_jobs.wait(m_decodeJobs); }
+
+	/**
+	 * @brief Uploads decoded images to the GPU until the time budget runs out.
+	 *
+	 * Call once per frame from the render thread. At least one band of rows
+	 * is uploaded per call, so loading always progresses.
+	 *
+	 * @param budgetMilliseconds Time the uploads may take this frame.
+	 * @return Number of textures that became ready.
+	 */
+	size_t
+		processUploads(float budgetMilliseconds);
+
+	/**
+	 * @brief Textures requested and not yet ready (or failed).
+	 */
+	size_t
+		getPendingCount() const { return m_loads.size(); }
+
+	/**
+	 * @brief Rows copied to the GPU per upload step.
+	 */
+	void
+		setRowsPerStep(unsigned int rows) { m_rowsPerStep = rows > 0 ? rows : 1; }
+
+private:
+	/**
+	 * @brief Progress of a load.
+	 */
+	enum
+		LoadState {
+		LOAD_QUEUED = 0,    ///< Waiting for a worker.
+		LOAD_DECODED = 1,   ///< The image is in memory.
+		LOAD_FAILED = 2,    ///< The file could not be decoded.
+		LOAD_UPLOADING = 3  ///< Some rows are on the GPU.
+	};
+
+	/**
+	 * @brief One texture being loaded.
+	 *
+	 * Workers only touch path, archive, image and state; the texture handle is used
+	 * on the render thread only, as its reference count is not atomic.
+	 */
+	struct
+		PendingLoad {
+		std::string path;
+		const AssetArchive* archive = nullptr; ///< Archive of the cache at request time.
+		Handle texture;
+		sf::Image image;
+		std::atomic<int> state{ LOAD_QUEUED };
+		unsigned int uploadedRows = 0;
+	};
+
+	/**
+	 * @brief Reads and decodes the image of a load (any thread).
+	 */
+	static void
+		decode(PendingLoad& load);
+
+	/**
+	 * @brief Uploads one band of rows of a decoded load.
+	 * @return True if the texture is now complete.
+	 */
+	bool
+		uploadStep(PendingLoad& load);
+
+	JobSystem& m_jobs;
+	ResourceManager<Texture>& m_cache;
+	JobCounter m_decodeJobs;                          ///< Decode jobs still running.
+	std::vector<std::unique_ptr<PendingLoad>> m_loads; ///< In request order.
+	unsigned int m_rowsPerStep = 64;
+};
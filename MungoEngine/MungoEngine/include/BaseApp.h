@@ -4,7 +4,28 @@
 #include "Window.h"
 #include "CShape.h"
 #include <vector> 
+#include <functional>
 #include <ESC/Actor.h>
+#include "JobSystem.h"
+#include "SpatialHashGrid.h"
+#include "LooseQuadtree.h"
+#include "CollisionSystem.h"
+#include "TransformHierarchy.h"
+#include "ResourceManager.h"
+#include "AsyncTextureLoader.h"
+#include <ESC/ParticleEmitter.h>
+#include <ESC/PathFollower.h>
+#include "PathfindingService.h"
+
+/**
+ * @enum AppBackend
+ * @brief Selects how the application presents its frames.
+ */
+enum
+	AppBackend {
+	WINDOWED = 0, ///< Regular SFML window with rendering.
+	HEADLESS = 1  ///< No window or GL context; only the simulation runs.
+};
 
 /**
  * @class BaseApp
@@ -24,6 +45,22 @@ public:
 	 */
 	BaseApp() = default;
 
+	/**
+	 * @brief Constructs the application with the given backend.
+	 * @param backend WINDOWED for normal runs, HEADLESS for simulation only.
+	 */
+	explicit
+		BaseApp(AppBackend backend) : m_backend(backend) {}
+
+	/**
+	 * @brief Constructs the application with a fixed number of threads.
+	 * @param backend WINDOWED for normal runs, HEADLESS for simulation only.
+	 * @param threadCount Threads of the job system, including the main one
+	 * (0 = one per hardware core).
+	 */
+	BaseApp(AppBackend backend, unsigned int threadCount)
+		: m_jobSystem(threadCount), m_backend(backend) {}
+
 	/**
 	 * @brief Destructor.
 	 *
@@ -34,8 +71,10 @@ public:
 	/**
 	 * @brief Runs the main application loop.
 	 *
-	 * This function controls the primary execution of the application,
-	 * usually containing the loop that handles updates and rendering.
+	 * Simulation advances in fixed steps driven by an accumulator of real
+	 * frame time, so results do not depend on the frame rate. After the
+	 * steps, the frame is rendered interpolating between the last two
+	 * simulated states.
 	 *
 	 * @return Exit code (typically 0 if successful).
 	 */
@@ -53,20 +92,25 @@ public:
 		init();
 
 	/**
-	 * @brief Updates the logic of the application.
+	 * @brief Advances the simulation by one fixed step.
+	 *
+	 * Called zero or more times per frame by run() to update entities and game state.
 	 *
-	 * Typically called every frame within the main loop to update entities and game state.
+	 * @param deltaTime Fixed simulation step, in seconds.
 	 */
 	void
-		update();
+		update(float deltaTime);
 
 	/**
 	 * @brief Renders the scene or graphical content.
 	 *
 	 * Called every frame to draw visual elements onto the window.
+	 *
+	 * @param alpha Fraction of a step elapsed since the last simulated state,
+	 * used to interpolate transforms (0 = previous step, 1 = current step).
 	 */
 	void
-		render();
+		render(float alpha);
 
 	/**
 	 * @brief Cleans up resources used by the application.
@@ -76,7 +120,217 @@ public:
 	void
 		destroy();
 
+	/**
+	 * @brief Sets how many simulation steps run per second.
+	 * @param stepsPerSecond Simulation rate in Hz (default 60).
+	 */
+	void
+		setSimulationRate(float stepsPerSecond);
+
+	/**
+	 * @brief Sets the maximum fixed steps run in one frame.
+	 *
+	 * When a frame takes longer than this many steps, the extra time is
+	 * dropped instead of letting the simulation fall further behind.
+	 *
+	 * @param maxSteps Maximum catch-up steps per frame (default 5).
+	 */
+	void
+		setMaxCatchUpSteps(int maxSteps);
+
+	/**
+	 * @brief Uncaps rendering and synchronizes it with the monitor instead.
+	 *
+	 * Only the presentation rate changes; the simulation keeps its fixed rate.
+	 *
+	 * @param enabled True to use vsync, false for the default 60 FPS limit.
+	 */
+	void
+		setVSync(bool enabled);
+
+	/**
+	 * @brief Sets game logic to run at the start of every fixed step.
+	 * @param callback Called with the step duration in seconds (empty = none).
+	 */
+	void
+		setStepCallback(std::function<void(float)> callback) { m_stepCallback = std::move(callback); }
+
+	/**
+	 * @brief Sets how many frames a headless run simulates before exiting.
+	 * @param frameCount Number of simulated frames (default 10000).
+	 */
+	void
+		setHeadlessFrameCount(uint64_t frameCount) { m_headlessFrameCount = frameCount; }
+
+	/**
+	 * @brief Wall-clock seconds the last headless run took to simulate its
+	 * frames (0 before the first run).
+	 */
+	float
+		getHeadlessSeconds() const { return m_headlessSeconds; }
+
+	/**
+	 * @brief Writes the profiler zones as a Chrome trace when the app closes.
+	 *
+	 * The file opens in about://tracing or ui.perfetto.dev. The per-zone
+	 * summary is printed on exit either way.
+	 *
+	 * @param path Output JSON file (empty = no trace).
+	 */
+	void
+		setTraceOutput(const std::string& path) { m_tracePath = path; }
+
+	/**
+	 * @brief Finds the shape under a window pixel (e.g. the mouse cursor).
+	 *
+	 * Uses the shape quadtree, so the cost grows with the tree depth and not
+	 * with the number of actors.
+	 *
+	 * @param pixel Pixel position inside the window.
+	 * @param entity Receives the entity of the topmost shape.
+	 * @return True if a shape was found.
+	 */
+	bool
+		pick(const sf::Vector2i& pixel, EntityID& entity) const;
+
+	/**
+	 * @brief Entities and components of the scene.
+	 */
+	World&
+		getWorld() { return m_world; }
+
+	/**
+	 * @brief Worker threads shared by the engine systems.
+	 */
+	JobSystem&
+		getJobSystem() { return m_jobSystem; }
+
+	/**
+	 * @brief Overlap tests run after every fixed step; register contact
+	 * listeners on it.
+	 */
+	CollisionSystem&
+		getCollisionSystem() { return m_collisionSystem; }
+
+	/**
+	 * @brief Shared texture cache; load actor textures through it.
+	 */
+	ResourceManager<Texture>&
+		getTextures() { return m_textures; }
+
+	/**
+	 * @brief Loads textures from a pack file instead of loose files.
+	 *
+	 * Paths missing from the archive still load from disk. Waits for the
+	 * background decodes reading the current archive before replacing it.
+	 *
+	 * @param path Archive written by AssetArchiveBuilder (--pack).
+	 * @return False if the archive could not be opened.
+	 */
+	bool
+		mountArchive(const std::string& path);
+
+	/**
+	 * @brief Mounted pack file (closed if none); read fonts and sounds from
+	 * it with AssetArchive::load().
+	 */
+	const AssetArchive&
+		getAssets() const { return m_assets; }
+
+	/**
+	 * @brief Background texture loader; textures it returns can be bound
+	 * to shapes right away and appear once uploaded.
+	 */
+	AsyncTextureLoader&
+		getTextureLoader() { return m_textureLoader; }
+
+	/**
+	 * @brief Sets the time render() may spend per frame uploading textures.
+	 * @param milliseconds Upload budget per frame (default 2 ms).
+	 */
+	void
+		setTextureUploadBudget(float milliseconds) { m_textureUploadBudget = milliseconds; }
+
+	/**
+	 * @brief Walkable cells of the scene (16-unit cells over the window).
+	 *
+	 * Call getPathfinding().flush() before changing it.
+	 */
+	NavigationGrid&
+		getNavigationGrid() { return m_navigationGrid; }
+
+	/**
+	 * @brief Path searches for entities with a PathFollower.
+	 */
+	PathfindingService&
+		getPathfinding() { return m_pathfinding; }
+
 private:
+	/**
+	 * @brief Mapped pack file. Declared before the caches that read from it.
+	 */
+	AssetArchive m_assets;
+
+	/**
+	 * @brief Textures shared by path, so each file is loaded once.
+	 */
+	ResourceManager<Texture> m_textures;
+
+	/**
+	 * @brief Archetype storage holding the components of every actor.
+	 *
+	 * Declared before the actors that reference it, so it outlives them,
+	 * and after the texture caches, so the shapes release their textures
+	 * before the caches go away.
+	 */
+	World m_world;
+
+	/**
+	 * @brief Worker threads used to update the world in parallel.
+	 */
+	JobSystem m_jobSystem;
+
+	/**
+	 * @brief Entity positions bucketed by cell, rebuilt after every fixed
+	 * step for proximity queries.
+	 */
+	SpatialHashGrid m_spatialGrid;
+
+	/**
+	 * @brief Shape bounds indexed for view culling and picking.
+	 */
+	LooseQuadtree m_shapeTree{ sf::FloatRect(-8192.f, -8192.f, 16384.f, 16384.f) };
+
+	/**
+	 * @brief Detects overlaps between colliders after every fixed step.
+	 */
+	CollisionSystem m_collisionSystem;
+
+	/**
+	 * @brief Parent-child links between actor transforms.
+	 */
+	TransformHierarchy m_hierarchy;
+
+	/**
+	 * @brief Decodes textures on the workers and uploads them in render().
+	 *
+	 * Declared after the job system and the cache it uses.
+	 */
+	AsyncTextureLoader m_textureLoader{ m_jobSystem, m_textures };
+
+	/**
+	 * @brief Walkable cells searched by m_pathfinding.
+	 */
+	NavigationGrid m_navigationGrid;
+
+	/**
+	 * @brief Runs path requests on the workers and delivers them to the
+	 * PathFollower components.
+	 *
+	 * Declared after the job system and the grid it uses.
+	 */
+	PathfindingService m_pathfinding{ m_jobSystem };
+
 	/**
 	 * @brief Shared pointer to the main application window.
 	 */
@@ -94,7 +348,25 @@ private:
 	 */
 	EngineUtilities::TSharedPointer<Actor> m_ACircle;
 
-	std::vector<sf::Vector2f> m_waypoints;     ///< Lista de puntos a seguir
-	size_t m_currentWaypointIndex = 0;
+	float m_fixedTimeStep = 1.f / 60.f; ///< Duration of one simulation step, in seconds.
+	int m_maxCatchUpSteps = 5;          ///< Maximum simulation steps per frame.
+	float m_accumulator = 0.f;          ///< Real time not yet simulated, in seconds.
+	bool m_vsync = false;               ///< Render with vsync instead of a frame limit.
+	float m_textureUploadBudget = 2.f;  ///< Texture upload time per frame, in milliseconds.
+
+	AppBackend m_backend = WINDOWED;     ///< Presentation backend chosen at startup.
+	uint64_t m_headlessFrameCount = 10000; ///< Frames simulated by a headless run.
+	float m_headlessSeconds = 0.f;         ///< Duration of the last headless run.
+	std::string m_tracePath;               ///< Chrome trace written on exit, if set.
+	std::function<void(float)> m_stepCallback; ///< Game logic run every fixed step.
+
+	/**
+	 * @brief Main loop for the headless backend.
+	 *
+	 * Runs update() with a synthetic clock that advances exactly one fixed
+	 * step per frame, as fast as possible, and reports the throughput.
+	 */
+	int
+		runHeadless();
 
 };
\ No newline at end of file
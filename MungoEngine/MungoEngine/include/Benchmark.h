@@ -0,0 +1,111 @@
+#pragma once
+#include "Prerequisites.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+/**
+ * @class Benchmark
+ * @brief Named performance measurements, run with --bench <name>.
+ *
+ * Each benchmark lives next to the others in src/Benchmarks and registers
+ * itself with the BENCHMARK macro. It builds its own data, times it and
+ * prints one line per measurement to stdout, apart from the log on
+ * std::cerr, so the results can be redirected to a file and compared.
+ *
+ * @code
+ * BENCHMARK(example, "What it measures") {
+ *     double ms = bench.time([]() { work(); });
+ *     bench.report("work", ms, "ms");
+ * }
+ * @endcode
+ */
+class
+	Benchmark {
+public:
+	/**
+	 * @brief Body of a benchmark.
+	 */
+	using Function = void (*)(Benchmark& bench);
+
+	/**
+	 * @brief Registers a benchmark (used by the BENCHMARK macro).
+	 * @return Always true, so it can initialize a static.
+	 */
+	static bool
+		add(const char* name, const char* description, Function function);
+
+	/**
+	 * @brief Runs a benchmark by name, "all" for every one, or "list".
+	 * @return Process exit code (1 if the name is unknown).
+	 */
+	static int
+		run(const std::string& name);
+
+	/**
+	 * @brief Wall-clock time of one call, in milliseconds.
+	 */
+	template<typename Func>
+	static double
+		time(Func&& func) {
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	/**
+	 * @brief Best of @p repetitions calls, in milliseconds (filters out
+	 * scheduling noise).
+	 */
+	template<typename Func>
+	static double
+		best(int repetitions, Func&& func) {
+		double shortest = time(func);
+		for (int i = 1; i < repetitions; ++i) {
+			shortest = std::min(shortest, time(func));
+		}
+		return shortest;
+	}
+
+	/**
+	 * @brief Prints one measurement of the running benchmark.
+	 * @param label What was measured.
+	 * @param value Measured value.
+	 * @param unit Unit of @p value.
+	 */
+	void
+		report(const std::string& label, double value, const std::string& unit);
+
+private:
+	/**
+	 * @brief Registered benchmark.
+	 */
+	struct
+		Entry {
+		const char* name;
+		const char* description;
+		Function function;
+	};
+
+	/**
+	 * @brief Every registered benchmark, filled before main() runs.
+	 */
+	static std::vector<Entry>&
+		getEntries();
+
+	explicit
+		Benchmark(const char* name) : m_name(name) {}
+
+	const char* m_name; ///< Benchmark being run.
+};
+
+/**
+ * @brief Defines and registers a benchmark; the body receives `bench`.
+ * @param name Identifier passed to --bench.
+ * @param description One line shown by --bench list.
+ */
+#define BENCHMARK(name, description)                                        \
+	static void benchmark_##name(Benchmark& bench);                         \
+	static const bool s_benchmark_##name =                                  \
+		Benchmark::add(#name, description, &benchmark_##name);              \
+	static void benchmark_##name(Benchmark& bench)
@@ -1,10 +1,16 @@
 ﻿#pragma once
 #include "Prerequisites.h"
 #include <./ESC/Component.h>
+#include <./ESC/Texture.h>
+
+struct AtlasRegion;
 
 class
 	Window;
 
+class
+	Transform;
+
 /**
  * @class CShape
  * @brief Derived component representing a graphical shape.
@@ -40,6 +46,10 @@ public:
 
 	/**
 	 * @brief Creates the shape of the specified type.
+	 *
+	 * Main thread only: shapes come from pools shared by every CShape, which
+	 * are not thread safe (stops with an error inside a JobSystem job).
+	 *
 	 * @param shapeType Shape type enum value.
 	 */
 	void
@@ -70,7 +80,7 @@ public:
 		render(const EngineUtilities::TSharedPointer<Window>& window) override;
 
 	/**
-	 * @brief Cleans up resources.
+	 * @brief Cleans up resources (main thread only, see createShape()).
 	 */
 	void
 		destroy() override;
@@ -97,6 +107,36 @@ public:
 	void
 		setFillColor(const sf::Color& color);
 
+	/**
+	 * @brief Draws the shape with a texture.
+	 *
+	 * The shape keeps a handle to the texture, so it stays alive while the
+	 * shape uses it even if the resource cache evicts it. A texture still
+	 * loading in the background is bound by render() once it is ready.
+	 *
+	 * @param texture Shared texture, e.g. from ResourceManager<Texture>;
+	 * null removes the current one.
+	 */
+	void
+		setTexture(const EngineUtilities::TSharedPointer<Texture>& texture);
+
+	/**
+	 * @brief Draws the shape with one image of a TextureAtlas.
+	 *
+	 * Shapes using regions of the same atlas page share its texture, so
+	 * the render batcher draws them together.
+	 *
+	 * @param region Region from TextureAtlas::findRegion().
+	 */
+	void
+		setTexture(const AtlasRegion& region);
+
+	/**
+	 * @brief Texture the shape is drawn with (null if none).
+	 */
+	const EngineUtilities::TSharedPointer<Texture>&
+		getTexture() const { return m_texture; }
+
 	/**
 	 * @brief Sets the rotation angle of the shape in degrees.
 	 * @param angle Rotation angle.
@@ -111,12 +151,89 @@ public:
 	void
 		setScale(const sf::Vector2f& scl);
 
+	/**
+	 * @brief Returns the bounding box of the shape in world coordinates.
+	 *
+	 * Includes position, rotation, scale, outline and the parent matrix.
+	 * Empty if no shape was created.
+	 */
+	sf::FloatRect
+		getGlobalBounds() const;
+
+	/**
+	 * @brief Copies a transform to the shape if it changed since the last sync.
+	 *
+	 * Static transforms are skipped, so the per-frame cost only depends on
+	 * the number of moving objects. Transforms moved in the last step are
+	 * always synced, since their interpolated state changes every frame.
+	 *
+	 * @param transform Transform of the same entity.
+	 * @param alpha Interpolation factor between the previous and current step.
+	 * @return True if the shape was updated.
+	 */
+	bool
+		syncTransform(const Transform& transform, float alpha = 1.f);
+
+	/**
+	 * @brief Sets the world matrix of the parent entity.
+	 *
+	 * Applied on top of the shape transform when drawing, for shapes whose
+	 * Transform is relative to a parent in the TransformHierarchy.
+	 *
+	 * @param parentTransform Parent world matrix (identity for roots).
+	 */
+	void
+		setParentTransform(const sf::Transform& parentTransform) { m_parentTransform = parentTransform; }
+
+	/**
+	 * @brief Returns the bounding box of the shape in local coordinates.
+	 */
+	sf::FloatRect
+		getLocalBounds() const;
+
+	/**
+	 * @brief Returns the type given to createShape().
+	 */
+	ShapeType
+		getShapeType() const { return m_shapeType; }
+
+	/**
+	 * @brief Number of points of the shape outline (0 if not created).
+	 */
+	size_t
+		getPointCount() const;
+
+	/**
+	 * @brief Returns a point of the shape outline in local coordinates.
+	 * @param index Point index, below getPointCount().
+	 */
+	sf::Vector2f
+		getPoint(size_t index) const;
+
 private:
+	/**
+	 * @brief Gives m_texture (and m_textureRect) to the SFML shape.
+	 */
+	void
+		bindTexture();
+
 	EngineUtilities::TSharedPointer<sf::Shape>
 		m_shapePtr; ///< Shared pointer to the SFML shape instance.
 
 	ShapeType
 		m_shapeType; ///< Enum representing the current shape type.
+	uint32_t
+		m_syncedVersion = UINT32_MAX; ///< Transform version copied by the last sync.
+	sf::Transform
+		m_parentTransform; ///< World matrix of the parent entity.
+	EngineUtilities::TSharedPointer<Texture>
+		m_texture; ///< Texture drawn on the shape, kept alive while in use.
+	bool
+		m_textureBound = false; ///< m_texture was given to the SFML shape.
+	sf::IntRect
+		m_textureRect; ///< Part of m_texture drawn, if m_useTextureRect.
+	bool
+		m_useTextureRect = false; ///< Draw m_textureRect instead of the whole texture.
 
 	sf::VertexArray*
 		m_line; ///< Pointer for line rendering (optional).
@@ -0,0 +1,141 @@
+#pragma once
+#include "Prerequisites.h"
+#include "ESC/World.h"
+#include <functional>
+
+/**
+ * @struct Contact
+ * @brief Overlap between two colliders found in one step.
+ */
+struct
+	Contact {
+	EntityID entityA;         ///< First entity.
+	EntityID entityB;         ///< Second entity.
+	sf::Vector2f normal;      ///< Unit direction from A to B along which to separate them.
+	float penetration;        ///< Deepest overlap along the normal.
+	sf::Vector2f points[2];   ///< Contact points in world coordinates.
+	int pointCount;           ///< Valid entries in points (1 or 2).
+};
+
+/**
+ * @class CollisionSystem
+ * @brief Finds the contacts between every Collider of a World.
+ *
+ * Each step the colliders are placed in world space with their Transform.
+ * A sort-and-sweep broad phase along X finds the pairs whose boxes overlap.
+ * The sort order is kept between steps, so an insertion sort restores it in
+ * almost linear time when things move a little. The narrow phase then runs
+ * exact circle-circle, circle-polygon and polygon-polygon (separating axis)
+ * tests and builds a manifold of up to two contact points per pair.
+ *
+ * Contacts are not delivered one by one: listeners receive the whole list
+ * once per step.
+ */
+class
+	CollisionSystem {
+public:
+	/**
+	 * @brief Receives every contact found in a step.
+	 */
+	using ContactListener = std::function<void(const std::vector<Contact>&)>;
+
+	/**
+	 * @brief Default constructor.
+	 */
+	CollisionSystem() = default;
+
+	/**
+	 * @brief Detects the contacts of the current step and notifies listeners.
+	 * @param world World whose Transform + Collider entities are tested.
+	 */
+	void
+		update(World& world);
+
+	/**
+	 * @brief Registers a callback called once per step with all contacts.
+	 * @param listener Callback; it is not called on steps without contacts.
+	 */
+	void
+		addListener(ContactListener listener);
+
+	/**
+	 * @brief Forgets a destroyed entity: drops its contacts from the last
+	 * step and re-sorts the broad phase from scratch on the next one, since
+	 * the proxy order of the previous step no longer matches.
+	 * @param entity Entity being destroyed.
+	 */
+	void
+		remove(EntityID entity);
+
+	/**
+	 * @brief Contacts found by the last update().
+	 */
+	const std::vector<Contact>&
+		getContacts() const { return m_contacts; }
+
+	/**
+	 * @brief Number of pairs that passed the broad phase in the last update().
+	 */
+	size_t
+		getBroadPhasePairCount() const { return m_pairCount; }
+
+private:
+	/**
+	 * @brief Collider placed in world space.
+	 */
+	struct
+		Proxy {
+		EntityID entity;
+		float minX, minY, maxX, maxY; ///< World bounding box.
+		bool isCircle;
+		sf::Vector2f center;          ///< Circle center.
+		float radius;                 ///< Circle radius.
+		uint32_t firstVertex;         ///< Polygon data in m_vertices / m_normals.
+		uint32_t vertexCount;
+		uint32_t layer;
+		uint32_t mask;
+	};
+
+	/**
+	 * @brief Fills m_proxies, m_vertices and m_normals from the world.
+	 */
+	void
+		gatherProxies(World& world);
+
+	/**
+	 * @brief Restores the X order of m_order and collects overlapping pairs.
+	 */
+	void
+		broadPhase();
+
+	/**
+	 * @brief Exact test of a pair; appends a contact if they overlap.
+	 */
+	void
+		narrowPhase(const Proxy& a, const Proxy& b);
+
+	bool
+		collideCircles(const Proxy& a, const Proxy& b, Contact& contact) const;
+
+	bool
+		collidePolygonCircle(const Proxy& polygon, const Proxy& circle, Contact& contact) const;
+
+	bool
+		collidePolygons(const Proxy& a, const Proxy& b, Contact& contact) const;
+
+	/**
+	 * @brief Largest separation of @p b along the face normals of @p a.
+	 * @param edge Receives the face of @p a giving that separation.
+	 */
+	float
+		findMaxSeparation(const Proxy& a, const Proxy& b, uint32_t& edge) const;
+
+	std::vector<Proxy> m_proxies;          ///< Colliders of this step.
+	std::vector<sf::Vector2f> m_vertices;  ///< World polygon vertices (counter-clockwise).
+	std::vector<sf::Vector2f> m_normals;   ///< Outward face normals, one per vertex.
+	std::vector<uint32_t> m_order;         ///< Proxies sorted by minX.
+	std::vector<std::pair<uint32_t, uint32_t>> m_pairs; ///< Broad phase output.
+	size_t m_pairCount = 0;                ///< Pairs tested in the last step.
+	std::vector<Contact> m_contacts;       ///< Contacts of the last step.
+	std::vector<ContactListener> m_listeners; ///< Batched contact callbacks.
+};
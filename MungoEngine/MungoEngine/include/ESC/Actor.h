@@ -5,6 +5,7 @@
 #include "Cshape.h"
 #include "./Transform.h"
 #include "Texture.h"
+#include "Collider.h"
 
 /**
  * @class Actor
@@ -24,9 +25,14 @@ public:
 
 	/**
 	 * @brief Constructs an Actor with a given name.
+	 *
+	 * Creates the backing entity in @p world and attaches the default
+	 * CShape and Transform components to it.
+	 *
+	 * @param world World that stores the components of the actor.
 	 * @param actorName Name of the actor.
 	 */
-	Actor(const std::string& actorName);
+	Actor(World* world, const std::string& actorName);
 
 	/**
 	 * @brief Virtual default destructor.
@@ -60,6 +66,7 @@ public:
 	 *
 	 * Override of the base Entity::render method. This function is responsible
 	 * for drawing the actor using the provided render context.
+	 * Shapes whose bounds fall outside the window view are skipped.
 	 */
 	void
 		render(const EngineUtilities::TSharedPointer<Window>& window) override;
@@ -67,65 +74,43 @@ public:
 	/**
 	 * @brief Called when the actor is being destroyed.
 	 *
-	 * Override of the base Entity::destroy method. Clean-up logic should be
-	 * placed here.
+	 * Override of the base Entity::destroy method. Releases the backing
+	 * entity and its components from the world.
 	 */
 	void
 		destroy() override;
 
+	/**
+	 * @brief Draws the actor shape with a shared texture.
+	 * @param texture Texture handle, e.g. from ResourceManager<Texture>.
+	 */
 	void setTexture(const EngineUtilities::TSharedPointer<Texture>& texture);
 
+	/**
+	 * @brief Draws the actor shape with an image of a TextureAtlas.
+	 * @param region Region from TextureAtlas::findRegion().
+	 */
+	void setTexture(const AtlasRegion& region);
+
 
 	/**
-	 * @brief Retrieves the first component of type T attached to the actor.
+	 * @brief Retrieves the component of type T attached to the actor.
 	 *
-	 * This function iterates over the list of components and attempts to
-	 * dynamically cast each one to the requested type T. If a component
-	 * of the desired type is found, it is returned as a shared pointer.
+	 * Exposes Entity::getComponent, an O(1) lookup through the World.
+	 */
+	using Entity::getComponent;
+
+	/**
+	 * @brief Attaches a new component of type T to the actor.
 	 *
-	 * @tparam T The type of component to search for.
-	 * @return EngineUtilities::TSharedPointer<T> A shared pointer to the component
-	 *         of type T if found; otherwise, an empty shared pointer.
+	 * Exposes Entity::addComponent. Pointers to the other components of the
+	 * actor must be fetched again afterwards, as they may have moved.
 	 */
-	template <typename T>
-	EngineUtilities::TSharedPointer<T> getComponent();
+	using Entity::addComponent;
 
 private:
 	/**
 	 * @brief The name of the actor.
 	 */
 	std::string m_name = "Actor";
-
-	// NOTE: It is assumed that the base Entity class provides:
-	// std::vector<EngineUtilities::TSharedPointer<Component>> components;
 };
-
-// -------- Template implementation --------
-
-/**
- * @brief Retrieves the first component of type T attached to the actor.
- *
- * This method searches through all components currently associated with actor.
- * It uses dynamic_pointer_cast to determine if the component can be converted
- * to type T.
- *
- * @tparam T The type of component to retrieve.
- * @return EngineUtilities::TSharedPointer<T> A shared pointer
- * to the component  of type T if found, otherwise an empty shared pointer.
- */
-template<typename T>
-inline EngineUtilities::TSharedPointer<T> Actor::getComponent() {
-	for (auto& component : components) {
-		// Attempt to dynamically cast the component to the requested type T
-		EngineUtilities::TSharedPointer<T> specificComponent
-			= component.template dynamic_pointer_cast<T>();
-
-		// If the cast is successful, return this component
-		if (specificComponent) {
-			return specificComponent;
-		}
-	}
-
-	// Return an empty shared pointer if no matching component is found
-	return EngineUtilities::TSharedPointer<T>();
-}
\ No newline at end of file
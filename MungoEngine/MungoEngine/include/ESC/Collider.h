@@ -0,0 +1,119 @@
+#pragma once
+#include "../Prerequisites.h"
+#include "Component.h"
+
+class
+	CShape;
+
+/**
+ * @class Collider
+ * @brief Component describing the collision geometry of an entity.
+ *
+ * The geometry is either a circle or a convex polygon, given in the same
+ * local space as the CShape of the entity, so the Transform of the entity
+ * places both of them. The CollisionSystem reads colliders and reports
+ * the contacts between them.
+ */
+class
+	Collider : public Component {
+public:
+	/**
+	 * @brief Default constructor. Creates a circle collider of radius 10.
+	 */
+	Collider() : Component(ComponentType::PHYSICS) {}
+
+	/**
+	 * @brief Virtual destructor.
+	 */
+	virtual
+		~Collider() = default;
+
+	void
+		start() override {}
+
+	void
+		update(float deltaTime) override {}
+
+	void
+		render(const EngineUtilities::TSharedPointer<Window>& window) override {}
+
+	void
+		destroy() override {}
+
+	/**
+	 * @brief Makes the collider a circle.
+	 * @param radius Radius in local units.
+	 * @param center Center in local coordinates.
+	 */
+	void
+		setCircle(float radius, const sf::Vector2f& center = sf::Vector2f(0.f, 0.f));
+
+	/**
+	 * @brief Makes the collider an axis-aligned box in local space.
+	 * @param size Width and height; the box starts at the local origin like
+	 * sf::RectangleShape.
+	 */
+	void
+		setBox(const sf::Vector2f& size);
+
+	/**
+	 * @brief Makes the collider a convex polygon.
+	 * @param points Vertices in order (either winding).
+	 */
+	void
+		setPolygon(const std::vector<sf::Vector2f>& points);
+
+	/**
+	 * @brief Copies the geometry of a shape component.
+	 *
+	 * Circles become circle colliders; rectangles, triangles and polygons
+	 * use the points of the shape.
+	 *
+	 * @param shape Shape to match.
+	 */
+	void
+		fitToShape(const CShape& shape);
+
+	/**
+	 * @brief Sets the collision filtering bits.
+	 *
+	 * Two colliders are tested only if each one's layer is in the other's mask.
+	 *
+	 * @param layer Bits this collider belongs to.
+	 * @param mask Bits this collider collides with.
+	 */
+	void
+		setFilter(uint32_t layer, uint32_t mask) {
+		m_layer = layer;
+		m_mask = mask;
+	}
+
+	/**
+	 * @brief Checks whether the collider is a circle.
+	 */
+	bool
+		isCircle() const { return m_isCircle; }
+
+	float
+		getRadius() const { return m_radius; }
+
+	const sf::Vector2f&
+		getCenter() const { return m_center; }
+
+	const std::vector<sf::Vector2f>&
+		getPoints() const { return m_points; }
+
+	uint32_t
+		getLayer() const { return m_layer; }
+
+	uint32_t
+		getMask() const { return m_mask; }
+
+private:
+	bool m_isCircle = true;              ///< Circle or convex polygon.
+	float m_radius = 10.f;               ///< Circle radius.
+	sf::Vector2f m_center{ 10.f, 10.f }; ///< Circle center (matches a default CShape circle).
+	std::vector<sf::Vector2f> m_points;  ///< Polygon vertices in local space.
+	uint32_t m_layer = 1;                ///< Filtering layer bits.
+	uint32_t m_mask = 0xFFFFFFFF;        ///< Layers this collider collides with.
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Prerequisites.h"
+#include <atomic>
 
 class
 	Window;
@@ -34,7 +35,65 @@ enum
 	SHAPE = 6,
 
 	/** Texture component for applying images to surfaces. */
-	TEXTURE = 7
+	TEXTURE = 7,
+
+	/** Particle emitter component for effects. */
+	PARTICLES = 8,
+
+	/** Path follower component for agents that navigate. */
+	NAVIGATION = 9
+};
+
+/**
+ * @brief Identifier assigned to each concrete component type.
+ */
+using ComponentTypeID = uint32_t;
+
+/**
+ * @brief Maximum number of distinct component types a World can store.
+ */
+constexpr ComponentTypeID MAX_COMPONENT_TYPES = 64;
+
+/**
+ * @brief Bit mask with one bit per ComponentTypeID.
+ */
+using ComponentSignature = uint64_t;
+
+/**
+ * @class ComponentTypeRegistry
+ * @brief Hands out a dense, unique identifier for every component type.
+ *
+ * Each type T gets its ID the first time getID<T>() is called, through a
+ * function-local static per template instantiation. Later calls are a single
+ * load, so IDs can be used to index tables in constant time.
+ */
+class
+	ComponentTypeRegistry {
+public:
+	/**
+	 * @brief Returns the identifier of component type T.
+	 * @tparam T Component type.
+	 */
+	template<typename T>
+	static ComponentTypeID
+		getID() {
+		static const ComponentTypeID id = nextID();
+		return id;
+	}
+
+private:
+	/**
+	 * @brief Reserves the next free identifier.
+	 */
+	static ComponentTypeID
+		nextID() {
+		static std::atomic<ComponentTypeID> counter{ 0 };
+		ComponentTypeID id = counter.fetch_add(1);
+		if (id >= MAX_COMPONENT_TYPES) {
+			ERROR("ComponentTypeRegistry", "nextID", "Too many component types registered");
+		}
+		return id;
+	}
 };
 
 /**
@@ -3,6 +3,7 @@
 
 #include "../Prerequisites.h"
 #include "Component.h"
+#include "World.h"
 
 class
 	Window;
@@ -11,9 +12,10 @@ class
  * @class Entity
  * @brief Abstract base class representing an entity in the engine.
  *
- * Entities are core objects in the engine which can hold multiple components.
- * Each entity supports a standard lifecycle (start, update, render, destroy),
- * and provides methods to manage components.
+ * Entities are lightweight handles into a World, which stores their
+ * components in contiguous per-archetype arrays. Each entity supports a
+ * standard lifecycle (start, update, render, destroy), and provides methods
+ * to manage components.
  */
 class
 	Entity {
@@ -62,45 +64,43 @@ public:
 	/**
 	 * @brief Adds a component of type T to the entity.
 	 *
-	 * The component must inherit from the base Component class.
-	 * Internally, it's cast to the base type to be stored in the component list.
+	 * The component must inherit from the base Component class. It is
+	 * constructed in place inside the World storage the entity belongs to.
 	 *
 	 * @tparam T The type of the component (must derive from Component).
-	 * @param component Shared pointer to the component instance.
+	 * @param args Arguments forwarded to the constructor of T.
+	 * @return Non-owning pointer to the stored component, or nullptr if the
+	 *         entity is not bound to a world.
 	 */
-	template<typename T>
-	void
-		addComponent(EngineUtilities::TSharedPointer<T> component) {
+	template<typename T, typename... Args>
+	T*
+		addComponent(Args&&... args) {
 		static_assert
 			(std::is_base_of<Component, T>::value, "T must be derived from Component");
 
-		// Cast component to base type and add to internal list
-		components.push_back(component.template dynamic_pointer_cast<Component>());
+		if (m_world == nullptr) {
+			return nullptr;
+		}
+		return m_world->template addComponent<T>(id, std::forward<Args>(args)...);
 	}
 
 	/**
-	 * @brief Retrieves the first component of type T attached to the entity.
+	 * @brief Retrieves the component of type T attached to the entity.
 	 *
-	 * Iterates through the list of components and attempts to cast each one
-	 * to the requested type. Returns the first successful match.
+	 * The lookup is resolved by the World the entity belongs to. The returned
+	 * pointer does not own the component and is only valid until the next
+	 * structural change in the world.
 	 *
 	 * @tparam T The type of component to retrieve.
-	 * @return Shared pointer to the component if found; empty pointer otherwise.
+	 * @return Pointer to the component if found; nullptr otherwise.
 	 */
 	template<typename T>
-	EngineUtilities::TSharedPointer<T> getComponent() {
-		for (auto& component : components) {
-			// Attempt dynamic cast from base component to specific type T
-			EngineUtilities::TSharedPointer<T> specificComponent =
-				component.template dynamic_pointer_cast<T>();
-
-			if (specificComponent) {
-				return specificComponent;
-			}
+	T*
+		getComponent() {
+		if (m_world == nullptr) {
+			return nullptr;
 		}
-
-		// No matching component found
-		return EngineUtilities::TSharedPointer<T>();
+		return m_world->template getComponent<T>(id);
 	}
 
 protected:
@@ -115,7 +115,7 @@ protected:
 	uint32_t id = 0;
 
 	/**
-	 * @brief List of components attached to this entity.
+	 * @brief World storing the components of this entity (not owned).
 	 */
-	std::vector<EngineUtilities::TSharedPointer<Component>> components;
+	World* m_world = nullptr;
 };
@@ -0,0 +1,246 @@
+#pragma once
+#include "../Prerequisites.h"
+#include "Component.h"
+#include "Texture.h"
+
+struct
+	AtlasRegion;
+
+class
+	JobSystem;
+
+/**
+ * @class ParticleEmitter
+ * @brief Component that spawns, simulates and draws a particle effect.
+ *
+ * Particles are not actors: they live in structure-of-arrays storage inside
+ * the emitter (one float array per attribute), so the update is a few
+ * linear passes that the compiler and VectorBatch run with SIMD, and dead
+ * particles are removed by swapping in the last one. render() writes two
+ * triangles per particle into a single sf::VertexArray (sf::Triangles, which
+ * unlike the deprecated sf::Quads also works on OpenGL ES) and draws the
+ * whole emitter with one draw call.
+ *
+ * Each emitter gets its own random seed, so identical emitters still
+ * produce different particles; setSeed() makes an effect reproducible.
+ *
+ * Particles are simulated in world space: they start at the emitter
+ * position (BaseApp copies it from the entity Transform every step) and do
+ * not follow the emitter afterwards.
+ */
+class
+	ParticleEmitter : public Component {
+public:
+	/**
+	 * @brief Default constructor. Emits nothing until setEmissionRate() or burst().
+	 */
+	ParticleEmitter() : Component(ComponentType::PARTICLES) { setSeed(nextSeed()); }
+
+	/**
+	 * @brief Virtual destructor.
+	 */
+	virtual
+		~ParticleEmitter() = default;
+
+	void
+		start() override {}
+
+	/**
+	 * @brief Ages, removes, moves and emits particles.
+	 * @param deltaTime Time step in seconds.
+	 */
+	void
+		update(float deltaTime) override;
+
+	/**
+	 * @brief Draws every live particle with one draw call.
+	 */
+	void
+		render(const EngineUtilities::TSharedPointer<Window>& window) override;
+
+	/**
+	 * @brief Like render(), writing the vertices on the workers of @p jobs.
+	 * @param window Target window.
+	 * @param jobs Job system splitting the vertex fill (nullptr = this thread).
+	 */
+	void
+		render(const EngineUtilities::TSharedPointer<Window>& window, JobSystem* jobs);
+
+	/**
+	 * @brief Writes two triangles per live particle into getVertices().
+	 *
+	 * render() calls it before drawing; call it directly to draw the
+	 * particles to another target.
+	 *
+	 * @param jobs Job system splitting the fill (nullptr = this thread).
+	 */
+	void
+		buildVertices(JobSystem* jobs = nullptr);
+
+	/**
+	 * @brief Triangles written by the last buildVertices() (6 vertices per particle).
+	 */
+	const sf::VertexArray&
+		getVertices() const { return m_vertices; }
+
+	/**
+	 * @brief Texture to draw getVertices() with (nullptr while the texture
+	 * is missing or loading).
+	 */
+	const sf::Texture*
+		getDrawTexture() const;
+
+	void
+		destroy() override { clear(); }
+
+	/**
+	 * @brief Maximum number of live particles; emission stops at the limit.
+	 */
+	void
+		setMaxParticles(size_t maxParticles);
+
+	/**
+	 * @brief Particles emitted per second (0 = only bursts).
+	 */
+	void
+		setEmissionRate(float particlesPerSecond) { m_emissionRate = particlesPerSecond; }
+
+	/**
+	 * @brief Emits particles at once, on top of the emission rate.
+	 */
+	void
+		burst(size_t count);
+
+	/**
+	 * @brief World position new particles start at.
+	 */
+	void
+		setPosition(const sf::Vector2f& position) { m_position = position; }
+
+	/**
+	 * @brief Lifetime range; each particle picks a random value.
+	 * @param minSeconds Shortest lifetime.
+	 * @param maxSeconds Longest lifetime.
+	 */
+	void
+		setLifetime(float minSeconds, float maxSeconds);
+
+	/**
+	 * @brief Initial speed range, in units per second.
+	 */
+	void
+		setSpeed(float minSpeed, float maxSpeed);
+
+	/**
+	 * @brief Emission cone.
+	 * @param angle Direction in degrees (0 = +x, 90 = +y).
+	 * @param spread Total cone width in degrees (360 = every direction).
+	 */
+	void
+		setDirection(float angle, float spread);
+
+	/**
+	 * @brief Constant acceleration, e.g. gravity.
+	 */
+	void
+		setAcceleration(const sf::Vector2f& acceleration) { m_acceleration = acceleration; }
+
+	/**
+	 * @brief Particle size at birth and at death, linearly interpolated.
+	 */
+	void
+		setSize(float startSize, float endSize);
+
+	/**
+	 * @brief Color at birth and at death, linearly interpolated (fade out
+	 * with an end alpha of 0).
+	 */
+	void
+		setColor(const sf::Color& startColor, const sf::Color& endColor);
+
+	/**
+	 * @brief Draws every particle with a whole texture (null = plain squares).
+	 */
+	void
+		setTexture(const EngineUtilities::TSharedPointer<Texture>& texture);
+
+	/**
+	 * @brief Draws every particle with an image of a TextureAtlas.
+	 */
+	void
+		setTexture(const AtlasRegion& region);
+
+	/**
+	 * @brief Restarts the random sequence (directions, speeds, lifetimes).
+	 *
+	 * Two emitters with the same settings and seed emit the same particles.
+	 */
+	void
+		setSeed(uint32_t seed);
+
+	/**
+	 * @brief Removes every live particle.
+	 */
+	void
+		clear() { m_count = 0; m_vertices.clear(); m_staticFieldsWritten = 0; }
+
+	/**
+	 * @brief Number of live particles.
+	 */
+	size_t
+		getParticleCount() const { return m_count; }
+
+private:
+	/**
+	 * @brief Spawns particles at the emitter position, up to the capacity.
+	 */
+	void
+		emit(size_t count);
+
+	/**
+	 * @brief Uniform random number in [0, 1) (xorshift, per emitter).
+	 */
+	float
+		random();
+
+	/**
+	 * @brief Default seed of a new emitter (a different one every time).
+	 */
+	static uint32_t
+		nextSeed();
+
+	// Particle attributes, one array each (structure of arrays)
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_age;        ///< Seconds since birth.
+	std::vector<float> m_lifetime;   ///< Seconds the particle lives.
+	size_t m_count = 0;              ///< Live particles, stored in [0, m_count).
+	size_t m_maxParticles = 10000;
+
+	sf::Vector2f m_position;
+	sf::Vector2f m_acceleration;
+	float m_emissionRate = 0.f;
+	float m_emissionAccumulator = 0.f; ///< Fraction of a particle still to emit.
+	float m_minLifetime = 1.f;
+	float m_maxLifetime = 1.f;
+	float m_minSpeed = 50.f;
+	float m_maxSpeed = 100.f;
+	float m_angle = -90.f;           ///< Degrees.
+	float m_spread = 30.f;           ///< Degrees.
+	float m_startSize = 4.f;
+	float m_endSize = 4.f;
+	sf::Color m_startColor = sf::Color::White;
+	sf::Color m_endColor = sf::Color::White;
+	uint32_t m_randomState = 0x9E3779B9u; ///< Set by setSeed().
+
+	EngineUtilities::TSharedPointer<Texture> m_texture;
+	sf::IntRect m_textureRect;       ///< Part of m_texture drawn on each particle.
+	bool m_useTextureRect = false;   ///< Use m_textureRect instead of the whole texture.
+	sf::VertexArray m_vertices{ sf::Triangles }; ///< Reused every frame.
+	sf::FloatRect m_texCoordsRect;   ///< Texture rect the texCoords were written for.
+	sf::Color m_writtenColor;        ///< Color written while it does not fade.
+	bool m_constantColorWritten = false; ///< The written colors are m_writtenColor.
+	size_t m_staticFieldsWritten = 0; ///< Particles whose texCoords (and constant color) are up to date.
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include "../Prerequisites.h"
+#include "Component.h"
+#include "Transform.h"
+#include <initializer_list>
+
+/**
+ * @class PathFollower
+ * @brief Component that moves its entity along a list of waypoints.
+ *
+ * The waypoints come from setPath() or from the PathfindingService, which
+ * delivers the result of PathfindingService::requestPath() here. BaseApp
+ * calls follow() with the entity Transform every step: the entity seeks the
+ * current waypoint and moves on to the next one once it is within the
+ * arrival radius.
+ */
+class
+	PathFollower : public Component {
+public:
+	/**
+	 * @brief Default constructor. Does nothing until it gets a path.
+	 */
+	PathFollower() : Component(ComponentType::NAVIGATION) {}
+
+	/**
+	 * @brief Virtual destructor.
+	 */
+	virtual
+		~PathFollower() = default;
+
+	void
+		start() override {}
+
+	/**
+	 * @brief Movement happens in follow(), which needs the Transform.
+	 */
+	void
+		update(float deltaTime) override {}
+
+	void
+		render(const EngineUtilities::TSharedPointer<Window>& window) override {}
+
+	void
+		destroy() override { clearPath(); }
+
+	/**
+	 * @brief Moves the transform toward the current waypoint.
+	 * @param transform Transform of the same entity.
+	 * @param deltaTime Time step in seconds.
+	 */
+	void
+		follow(Transform& transform, float deltaTime);
+
+	/**
+	 * @brief Replaces the path and starts at its first waypoint.
+	 */
+	void
+		setPath(const std::vector<sf::Vector2f>& path);
+
+	void
+		setPath(std::vector<sf::Vector2f>&& path);
+
+	void
+		setPath(std::initializer_list<sf::Vector2f> path) { setPath(std::vector<sf::Vector2f>(path)); }
+
+	/**
+	 * @brief Stops following and forgets the path.
+	 */
+	void
+		clearPath();
+
+	/**
+	 * @brief Marks the last path request as failed (and clears the path).
+	 */
+	void
+		setPathFailed();
+
+	/**
+	 * @brief True if the last path request found no path.
+	 */
+	bool
+		hasFailed() const { return m_failed; }
+
+	/**
+	 * @brief True while there are waypoints left.
+	 */
+	bool
+		hasPath() const { return m_currentWaypointIndex < m_path.size(); }
+
+	/**
+	 * @brief True once the last waypoint has been reached.
+	 */
+	bool
+		isFinished() const { return !m_path.empty() && !hasPath(); }
+
+	/**
+	 * @brief Movement speed in units per second (default 100).
+	 */
+	void
+		setSpeed(float speed) { m_speed = speed; }
+
+	/**
+	 * @brief Distance at which a waypoint counts as reached (default 10).
+	 */
+	void
+		setArrivalRadius(float radius) { m_arrivalRadius = radius; }
+
+	const std::vector<sf::Vector2f>&
+		getPath() const { return m_path; }
+
+	size_t
+		getCurrentWaypointIndex() const { return m_currentWaypointIndex; }
+
+private:
+	std::vector<sf::Vector2f> m_path;   ///< Waypoints in world units.
+	size_t m_currentWaypointIndex = 0;  ///< Next waypoint to reach.
+	float m_speed = 100.f;
+	float m_arrivalRadius = 10.f;
+	bool m_failed = false;
+};
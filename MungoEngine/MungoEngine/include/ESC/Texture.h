@@ -2,45 +2,154 @@
 #include "../Prerequisites.h"
 #include "Component.h"
 
+/**
+ * @class Texture
+ * @brief Image stored on the GPU that shapes can be drawn with.
+ *
+ * Textures are shared resources: get them from a ResourceManager<Texture>
+ * so a file used by many actors is decoded and uploaded only once.
+ */
 class Texture : public Component {
 public:
-    Texture() = default;
-   
+    Texture() : Component(TEXTURE) {}
+
+    /**
+     * @brief Loads "textureName.extension" directly.
+     *
+     * Every instance loads its own copy; prefer ResourceManager::load().
+     */
     Texture(const std::string& textureName, const std::string& extension = "png")
-        : m_textureName(textureName)
+        : Component(TEXTURE)
+        , m_textureName(textureName)
         , m_extension(extension)
-        , Component(TEXTURE)
     {
-        if (!m_texture.loadFromFile(m_textureName + "." + m_extension))
-            std::cout << "Error de carga de textura: "
-            << m_textureName << "." << m_extension
-            << std::endl;
+        loadFromFile(m_textureName + "." + m_extension);
     }
 
 
     virtual
     ~Texture() = default;
 
-    void 
+    void
     start() override {}
 
     void
-    update(float deltaTime) override;
+    update(float deltaTime) override {}
+
+    void
+    render(const EngineUtilities::TSharedPointer<Window>& window) override {}
 
-    void 
-    render(const EngineUtilities::TSharedPointer<Window>& window) override;
-    
     void
     destroy() override {}
 
+    /**
+     * @brief Decodes an image file and uploads it.
+     * @return False if the file could not be loaded.
+     */
+    bool
+    loadFromFile(const std::string& path) {
+        if (!m_texture.loadFromFile(path)) {
+            LOG_WARNING("Texture", "loadFromFile", "Error de carga de textura: " << path);
+            return false;
+        }
+        m_ready = true;
+        return true;
+    }
+
+    /**
+     * @brief Decodes an image file held in memory (e.g. an AssetArchive entry).
+     * @return False if the data is not a supported image.
+     */
+    bool
+    loadFromMemory(const void* data, size_t size) {
+        if (!m_texture.loadFromMemory(data, size)) {
+            LOG_WARNING("Texture", "loadFromMemory", "Error de carga de textura");
+            return false;
+        }
+        m_ready = true;
+        return true;
+    }
+
+    /**
+     * @brief Uploads an image already decoded in memory.
+     * @return False if the image is empty or too large for the GPU.
+     */
+    bool
+    loadFromImage(const sf::Image& image) {
+        if (!m_texture.loadFromImage(image)) {
+            LOG_WARNING("Texture", "loadFromImage", "Error de carga de textura");
+            return false;
+        }
+        m_ready = true;
+        return true;
+    }
+
+    /**
+     * @brief Allocates the texture for an upload done in several steps.
+     *
+     * The texture is not ready until endUpload(); shapes bound to it wait.
+     *
+     * @param size Size of the image that will be uploaded.
+     * @return False if the GPU could not create the texture.
+     */
+    bool
+    beginUpload(const sf::Vector2u& size) {
+        m_ready = false;
+        return m_texture.create(size.x, size.y);
+    }
+
+    /**
+     * @brief Copies a band of rows of @p image to the texture.
+     * @param image Image of the size given to beginUpload().
+     * @param firstRow First row to copy.
+     * @param rowCount Number of rows.
+     */
+    void
+    uploadRows(const sf::Image& image, unsigned int firstRow, unsigned int rowCount) {
+        const unsigned int width = image.getSize().x;
+        m_texture.update(image.getPixelsPtr() + static_cast<size_t>(firstRow) * width * 4,
+            width, rowCount, 0, firstRow);
+    }
+
+    /**
+     * @brief Marks an upload started with beginUpload() as complete.
+     */
+    void
+    endUpload() {
+        m_ready = true;
+    }
+
+    /**
+     * @brief Checks whether the pixels are on the GPU and the texture can be drawn.
+     */
+    bool
+    isReady() const {
+        return m_ready;
+    }
+
+    /**
+     * @brief Video memory used by the texture (4 bytes per pixel).
+     */
+    size_t
+    getMemorySize() const {
+        const sf::Vector2u size = m_texture.getSize();
+        return static_cast<size_t>(size.x) * size.y * 4;
+    }
+
     sf::Texture&
-    getTexture() { 
-        return m_texture; 
+    getTexture() {
+        return m_texture;
     }
-    
+
+    const sf::Texture&
+    getTexture() const {
+        return m_texture;
+    }
+
 
 private:
     sf::Texture m_texture;
     std::string m_textureName;
     std::string m_extension;
+    bool m_ready = false; ///< The pixels were uploaded.
 };
@@ -21,10 +21,13 @@ public:
      * rotation (0,0), and scale (1,1).
      */
     Transform()
-        : m_position(0.f, 0.f),
+        : Component(ComponentType::TRANSFORM),
+        m_position(0.f, 0.f),
         m_rotation(0.f, 0.f),
         m_scale(1.f, 1.f),
-        Component(ComponentType::TRANSFORM) {
+        m_previousPosition(0.f, 0.f),
+        m_previousRotation(0.f, 0.f),
+        m_previousScale(1.f, 1.f) {
     }
 
     /**
@@ -70,21 +73,128 @@ public:
         if (length > range) {
             direction /= length;  // Normaliza el vector
             m_position += direction * speed * deltaTime;
+            markDirty();
         }
     }
 
-    // Setters
-    void setPosition(const sf::Vector2f& _position) { m_position = _position; }
-    void setRotation(const sf::Vector2f& _rotation) { m_rotation = _rotation; }
-    void setScale(const sf::Vector2f& _scale) { m_scale = _scale; }
+    /**
+     * @brief Stores the current state as the previous one.
+     *
+     * Called before every fixed simulation step so rendering can interpolate
+     * between the last two simulated states.
+     */
+    void savePreviousState() {
+        if (!isInterpolating()) {
+            return;
+        }
+        m_previousPosition = m_position;
+        m_previousRotation = m_rotation;
+        m_previousScale = m_scale;
+
+        // The interpolated state changed even though the current one did not
+        ++m_version;
+    }
+
+    /**
+     * @brief Checks whether the last step changed the transform, in which
+     * case the interpolated state differs from frame to frame.
+     */
+    bool isInterpolating() const {
+        return m_previousPosition != m_position ||
+            m_previousRotation != m_rotation ||
+            m_previousScale != m_scale;
+    }
+
+    /**
+     * @brief Matrix of the state blended between the previous and current step.
+     * @param alpha Blend factor in [0, 1] (0 = previous, 1 = current).
+     */
+    sf::Transform getInterpolatedTransform(float alpha) const {
+        if (!isInterpolating()) {
+            return getTransform();
+        }
+        sf::Transform transform;
+        transform.translate(getInterpolatedPosition(alpha))
+            .rotate(getInterpolatedRotation(alpha).x)
+            .scale(getInterpolatedScale(alpha));
+        return transform;
+    }
+
+    /**
+     * @brief Counter bumped on every change of the current or previous state.
+     *
+     * Consumers store the version they last read and skip the work while it
+     * stays the same.
+     */
+    uint32_t getVersion() const { return m_version; }
+
+    /**
+     * @brief Combined position, rotation and scale matrix of the current state.
+     *
+     * Same convention as sf::Transformable with the origin at (0, 0). The
+     * matrix is cached and only rebuilt after a change.
+     */
+    const sf::Transform& getTransform() const {
+        if (m_transformDirty) {
+            m_transform = sf::Transform::Identity;
+            m_transform.translate(m_position).rotate(m_rotation.x).scale(m_scale);
+            m_transformDirty = false;
+        }
+        return m_transform;
+    }
+
+    /**
+     * @brief Position blended between the previous and current step.
+     * @param alpha Blend factor in [0, 1] (0 = previous, 1 = current).
+     */
+    sf::Vector2f getInterpolatedPosition(float alpha) const {
+        return m_previousPosition + (m_position - m_previousPosition) * alpha;
+    }
+
+    /**
+     * @brief Rotation blended between the previous and current step.
+     * @param alpha Blend factor in [0, 1] (0 = previous, 1 = current).
+     */
+    sf::Vector2f getInterpolatedRotation(float alpha) const {
+        return m_previousRotation + (m_rotation - m_previousRotation) * alpha;
+    }
 
-    // Getters
-    sf::Vector2f& getPosition() { return m_position; }
-    sf::Vector2f& getRotation() { return m_rotation; }
-    sf::Vector2f& getScale() { return m_scale; }
+    /**
+     * @brief Scale blended between the previous and current step.
+     * @param alpha Blend factor in [0, 1] (0 = previous, 1 = current).
+     */
+    sf::Vector2f getInterpolatedScale(float alpha) const {
+        return m_previousScale + (m_scale - m_previousScale) * alpha;
+    }
+
+    // Setters (they mark the transform as changed)
+    void setPosition(const sf::Vector2f& _position) { m_position = _position; markDirty(); }
+    void setRotation(const sf::Vector2f& _rotation) { m_rotation = _rotation; markDirty(); }
+    void setScale(const sf::Vector2f& _scale) { m_scale = _scale; markDirty(); }
+
+    // Getters (read-only, so every change goes through the setters)
+    const sf::Vector2f& getPosition() const { return m_position; }
+    const sf::Vector2f& getRotation() const { return m_rotation; }
+    const sf::Vector2f& getScale() const { return m_scale; }
 
 private:
+    /**
+     * @brief Records a change of the current state.
+     */
+    void markDirty() {
+        m_transformDirty = true;
+        ++m_version;
+    }
+
     sf::Vector2f m_position; //< Position vector representing the entity's position in 2D space.
     sf::Vector2f m_rotation; //< Rotation vector representing the entity's rotation in degrees.
     sf::Vector2f m_scale;    //< Scale vector representing the entity's scale factors.
+
+    sf::Vector2f m_previousPosition; //< Position at the start of the last fixed step.
+    sf::Vector2f m_previousRotation; //< Rotation at the start of the last fixed step.
+    sf::Vector2f m_previousScale;    //< Scale at the start of the last fixed step.
+
+    uint32_t m_version = 0;                 //< Bumped on every change.
+    mutable sf::Transform m_transform;      //< Cached matrix of the current state.
+    mutable bool m_transformDirty = true;   //< m_transform must be rebuilt.
 };
@@ -0,0 +1,561 @@
+#pragma once
+
+#include "../Prerequisites.h"
+#include "Component.h"
+#include "../JobSystem.h"
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+class
+	Window;
+
+/**
+ * @brief Identifier of an entity stored inside a World.
+ */
+using EntityID = uint32_t;
+
+/**
+ * @brief EntityID value meaning "no entity" (e.g. no parent).
+ */
+constexpr EntityID INVALID_ENTITY = UINT32_MAX;
+
+/**
+ * @class IComponentColumn
+ * @brief Type-erased contiguous array holding every component of one type
+ * inside an archetype.
+ *
+ * Row @c i of every column of an archetype belongs to the same entity.
+ */
+class
+	IComponentColumn {
+public:
+	/**
+	 * @brief Virtual default destructor.
+	 */
+	virtual
+		~IComponentColumn() = default;
+
+	/**
+	 * @brief Returns the registry identifier of the stored component type.
+	 */
+	virtual ComponentTypeID
+		getTypeID() const = 0;
+
+	/**
+	 * @brief Number of components (rows) currently stored.
+	 */
+	virtual size_t
+		size() const = 0;
+
+	/**
+	 * @brief Returns the component stored at the given row as its base type.
+	 * @param row Row index inside the archetype.
+	 */
+	virtual Component*
+		getComponent(size_t row) = 0;
+
+	/**
+	 * @brief Appends, by move, the component stored at @p row of @p source.
+	 * @param source Column of the same component type.
+	 * @param row Row to take from @p source (left in a moved-from state).
+	 */
+	virtual void
+		moveFrom(IComponentColumn& source, size_t row) = 0;
+
+	/**
+	 * @brief Removes a row by swapping the last element into its place.
+	 * @param row Row index to remove.
+	 */
+	virtual void
+		removeSwap(size_t row) = 0;
+
+	/**
+	 * @brief Creates an empty column storing the same component type.
+	 */
+	virtual EngineUtilities::TUniquePtr<IComponentColumn>
+		createEmpty() const = 0;
+
+	/**
+	 * @brief Calls Component::update on every row, in memory order.
+	 * @param deltaTime Time elapsed since the last frame (in seconds).
+	 */
+	virtual void
+		updateAll(float deltaTime) = 0;
+
+	/**
+	 * @brief Calls Component::update on the rows [first, last).
+	 *
+	 * Used to split a column between job system workers.
+	 *
+	 * @param first First row.
+	 * @param last One past the last row.
+	 * @param deltaTime Time elapsed since the last frame (in seconds).
+	 */
+	virtual void
+		updateRange(size_t first, size_t last, float deltaTime) = 0;
+
+	/**
+	 * @brief Calls Component::render on every row, in memory order.
+	 * @param window Shared pointer to the render window.
+	 */
+	virtual void
+		renderAll(const EngineUtilities::TSharedPointer<Window>& window) = 0;
+};
+
+/**
+ * @class TComponentColumn
+ * @brief Concrete column storing components of type T by value.
+ *
+ * @tparam T Component type (must derive from Component).
+ */
+template<typename T>
+class
+	TComponentColumn : public IComponentColumn {
+public:
+	ComponentTypeID
+		getTypeID() const override { return ComponentTypeRegistry::getID<T>(); }
+
+	size_t
+		size() const override { return data.size(); }
+
+	Component*
+		getComponent(size_t row) override { return &data[row]; }
+
+	void
+		moveFrom(IComponentColumn& source, size_t row) override {
+		data.push_back(std::move(static_cast<TComponentColumn<T>&>(source).data[row]));
+	}
+
+	void
+		removeSwap(size_t row) override {
+		if (row + 1 != data.size()) {
+			data[row] = std::move(data.back());
+		}
+		data.pop_back();
+	}
+
+	EngineUtilities::TUniquePtr<IComponentColumn>
+		createEmpty() const override {
+		return EngineUtilities::TUniquePtr<IComponentColumn>(new TComponentColumn<T>());
+	}
+
+	void
+		updateAll(float deltaTime) override {
+		for (T& component : data) {
+			component.update(deltaTime);
+		}
+	}
+
+	void
+		updateRange(size_t first, size_t last, float deltaTime) override {
+		for (size_t row = first; row < last; ++row) {
+			data[row].update(deltaTime);
+		}
+	}
+
+	void
+		renderAll(const EngineUtilities::TSharedPointer<Window>& window) override {
+		for (T& component : data) {
+			component.render(window);
+		}
+	}
+
+	/**
+	 * @brief Contiguous storage of the components.
+	 */
+	std::vector<T> data;
+};
+
+/**
+ * @struct Archetype
+ * @brief Group of entities sharing exactly the same set of component types.
+ *
+ * Components are stored as a structure of arrays: one contiguous column per
+ * component type, all columns indexed by the same row.
+ */
+struct
+	Archetype {
+	Archetype() {
+		std::fill(std::begin(columnOfType), std::end(columnOfType), static_cast<int8_t>(-1));
+	}
+
+	/**
+	 * @brief Bit mask of the component types stored in this archetype.
+	 */
+	ComponentSignature signature = 0;
+
+	/**
+	 * @brief One column per component type, in ascending type ID order.
+	 */
+	std::vector<EngineUtilities::TUniquePtr<IComponentColumn>> columns;
+
+	/**
+	 * @brief Slot table mapping a component type ID to its column index
+	 * (-1 when the type is not stored), giving O(1) column lookup.
+	 */
+	int8_t columnOfType[MAX_COMPONENT_TYPES];
+
+	/**
+	 * @brief Entity owning each row.
+	 */
+	std::vector<EntityID> entities;
+
+	/**
+	 * @brief Finds the column index storing the given type.
+	 * @return Column index, or -1 if the archetype does not hold that type.
+	 */
+	int
+		findColumn(ComponentTypeID type) const {
+		return columnOfType[type];
+	}
+
+	/**
+	 * @brief Appends a column and registers it in the slot table.
+	 */
+	void
+		addColumn(EngineUtilities::TUniquePtr<IComponentColumn> column) {
+		columnOfType[column->getTypeID()] = static_cast<int8_t>(columns.size());
+		columns.push_back(std::move(column));
+	}
+
+	/**
+	 * @brief Returns the typed column for T, or nullptr if not present.
+	 */
+	template<typename T>
+	TComponentColumn<T>*
+		getColumn() {
+		int index = columnOfType[ComponentTypeRegistry::getID<T>()];
+		if (index < 0) {
+			return nullptr;
+		}
+		return static_cast<TComponentColumn<T>*>(columns[index].get());
+	}
+};
+
+/**
+ * @class World
+ * @brief Archetype based storage for every entity and component of a scene.
+ *
+ * Entities are plain identifiers. Their components live in contiguous
+ * per-type arrays grouped by archetype, so systems can iterate them linearly
+ * instead of chasing one heap allocation per component.
+ *
+ * Pointers returned by getComponent() and addComponent() stay valid only
+ * until the next structural change (adding or removing components or
+ * entities) in the same archetype.
+ */
+class
+	World {
+public:
+	/**
+	 * @brief Called with an entity about to be destroyed.
+	 */
+	using DestroyListener = std::function<void(EntityID)>;
+
+	/**
+	 * @brief Creates the world with the empty archetype.
+	 */
+	World();
+
+	/**
+	 * @brief Destructor. Destroys every remaining entity.
+	 */
+	~World();
+
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
+
+	/**
+	 * @brief Creates a new entity without components.
+	 * @return Identifier of the new entity.
+	 */
+	EntityID
+		createEntity();
+
+	/**
+	 * @brief Destroys an entity and all of its components.
+	 *
+	 * Destroy listeners run first, while the components are still there.
+	 * The identifier is recycled by a later createEntity().
+	 *
+	 * @param entity Entity to destroy.
+	 */
+	void
+		destroyEntity(EntityID entity);
+
+	/**
+	 * @brief Registers a callback run by destroyEntity(), so systems that
+	 * index entities by identifier can drop them before the id is reused.
+	 *
+	 * Listeners are not called for the entities left when the world itself
+	 * is destroyed.
+	 */
+	void
+		addDestroyListener(DestroyListener listener) { m_destroyListeners.push_back(std::move(listener)); }
+
+	/**
+	 * @brief Checks if the identifier refers to a living entity.
+	 */
+	bool
+		isAlive(EntityID entity) const;
+
+	/**
+	 * @brief Number of living entities.
+	 */
+	size_t
+		getEntityCount() const { return m_entityCount; }
+
+	/**
+	 * @brief Adds a component of type T constructed in place.
+	 *
+	 * The entity is moved to the archetype matching its new signature. If
+	 * the entity already has a T, the existing component is returned.
+	 *
+	 * @tparam T Component type (must derive from Component).
+	 * @param entity Target entity.
+	 * @param args Arguments forwarded to the constructor of T.
+	 * @return Pointer to the stored component, or nullptr if the entity is dead.
+	 */
+	template<typename T, typename... Args>
+	T*
+		addComponent(EntityID entity, Args&&... args);
+
+	/**
+	 * @brief Retrieves the component of type T of an entity.
+	 *
+	 * Constant time: the entity record gives the archetype and row, and the
+	 * archetype slot table gives the column for the type ID of T.
+	 *
+	 * @return Non-owning pointer to the component, or nullptr if not present.
+	 */
+	template<typename T>
+	T*
+		getComponent(EntityID entity);
+
+	/**
+	 * @brief Calls @p func for every entity having all of the given components.
+	 *
+	 * Matching archetypes are visited one after the other and their columns
+	 * are walked linearly. @p func must not add or remove components or
+	 * entities.
+	 *
+	 * @tparam Ts Required component types.
+	 * @param func Callable taking (Ts&...).
+	 */
+	template<typename... Ts, typename Func>
+	void
+		forEach(Func&& func);
+
+	/**
+	 * @brief Like forEach(), but also passes the entity identifier.
+	 *
+	 * @tparam Ts Required component types.
+	 * @param func Callable taking (EntityID, Ts&...).
+	 */
+	template<typename... Ts, typename Func>
+	void
+		forEachEntity(Func&& func);
+
+	/**
+	 * @brief Parallel version of forEach() running on a JobSystem.
+	 *
+	 * The rows of each matching archetype are split into chunks of
+	 * @p grainSize and processed by the workers; the call returns when all
+	 * chunks are done. @p func runs concurrently, so it must only touch the
+	 * components it receives.
+	 *
+	 * @tparam Ts Required component types.
+	 * @param jobs Job system executing the chunks.
+	 * @param grainSize Entities per job.
+	 * @param func Callable taking (Ts&...).
+	 */
+	template<typename... Ts, typename Func>
+	void
+		parallelForEach(JobSystem& jobs, size_t grainSize, Func&& func);
+
+	/**
+	 * @brief Updates every component of every entity.
+	 *
+	 * With a job system, each column is split into ranges updated in
+	 * parallel; components must then not touch other entities in update().
+	 *
+	 * @param deltaTime Time elapsed since the last frame (in seconds).
+	 * @param jobs Optional job system (nullptr = main thread only).
+	 */
+	void
+		update(float deltaTime, JobSystem* jobs = nullptr);
+
+	/**
+	 * @brief Renders every component of every entity.
+	 * @param window Shared pointer to the render window.
+	 */
+	void
+		render(const EngineUtilities::TSharedPointer<Window>& window);
+
+private:
+	/**
+	 * @brief Location of an entity inside the archetype storage.
+	 */
+	struct
+		EntityRecord {
+		uint32_t archetype = 0; ///< Index in m_archetypes.
+		uint32_t row = 0;       ///< Row inside the archetype.
+		bool alive = false;     ///< Whether the identifier is in use.
+	};
+
+	/**
+	 * @brief Finds the archetype for a signature.
+	 * @return Archetype index, or -1 if it does not exist yet.
+	 */
+	int
+		findArchetype(ComponentSignature signature) const;
+
+	/**
+	 * @brief Registers a new archetype and returns its index.
+	 */
+	uint32_t
+		registerArchetype(EngineUtilities::TUniquePtr<Archetype> archetype);
+
+	/**
+	 * @brief Moves the components of an entity to another archetype.
+	 *
+	 * Only the columns present in both archetypes are moved; the caller is
+	 * responsible for filling the remaining columns of the new row.
+	 */
+	void
+		moveEntity(EntityID entity, uint32_t targetArchetype);
+
+	/**
+	 * @brief Removes a row from an archetype, fixing the swapped entity record.
+	 */
+	void
+		removeRow(uint32_t archetype, uint32_t row);
+
+	std::vector<EngineUtilities::TUniquePtr<Archetype>> m_archetypes;
+	std::unordered_map<ComponentSignature, uint32_t> m_archetypeLookup;
+	std::vector<EntityRecord> m_records;
+	std::vector<EntityID> m_freeEntities;
+	size_t m_entityCount = 0;
+	std::vector<DestroyListener> m_destroyListeners;
+};
+
+// -------- Template implementation --------
+
+template<typename T, typename... Args>
+inline T*
+World::addComponent(EntityID entity, Args&&... args) {
+	static_assert
+		(std::is_base_of<Component, T>::value, "T must be derived from Component");
+
+	if (!isAlive(entity)) {
+		return nullptr;
+	}
+
+	if (T* existing = getComponent<T>(entity)) {
+		return existing;
+	}
+
+	Archetype& source = *m_archetypes[m_records[entity].archetype];
+	const ComponentTypeID newType = ComponentTypeRegistry::getID<T>();
+	const ComponentSignature signature = source.signature | (ComponentSignature(1) << newType);
+
+	int targetIndex = findArchetype(signature);
+	if (targetIndex < 0) {
+		EngineUtilities::TUniquePtr<Archetype> archetype(new Archetype());
+		archetype->signature = signature;
+		for (ComponentTypeID type = 0; type < MAX_COMPONENT_TYPES; ++type) {
+			if ((signature & (ComponentSignature(1) << type)) == 0) {
+				continue;
+			}
+			if (type == newType) {
+				archetype->addColumn(
+					EngineUtilities::TUniquePtr<IComponentColumn>(new TComponentColumn<T>()));
+			}
+			else {
+				archetype->addColumn(source.columns[source.findColumn(type)]->createEmpty());
+			}
+		}
+		targetIndex = static_cast<int>(registerArchetype(std::move(archetype)));
+	}
+
+	moveEntity(entity, static_cast<uint32_t>(targetIndex));
+
+	TComponentColumn<T>* column = m_archetypes[targetIndex]->template getColumn<T>();
+	column->data.emplace_back(std::forward<Args>(args)...);
+	return &column->data.back();
+}
+
+template<typename T>
+inline T*
+World::getComponent(EntityID entity) {
+	if (!isAlive(entity)) {
+		return nullptr;
+	}
+
+	const EntityRecord& record = m_records[entity];
+	TComponentColumn<T>* column = m_archetypes[record.archetype]->template getColumn<T>();
+	return column ? &column->data[record.row] : nullptr;
+}
+
+template<typename... Ts, typename Func>
+inline void
+World::forEach(Func&& func) {
+	for (auto& archetype : m_archetypes) {
+		if (archetype->entities.empty()) {
+			continue;
+		}
+
+		std::tuple<TComponentColumn<Ts>*...> columns(archetype->template getColumn<Ts>()...);
+		if (!(std::get<TComponentColumn<Ts>*>(columns) && ...)) {
+			continue;
+		}
+
+		const size_t count = archetype->entities.size();
+		for (size_t row = 0; row < count; ++row) {
+			func(std::get<TComponentColumn<Ts>*>(columns)->data[row]...);
+		}
+	}
+}
+
+template<typename... Ts, typename Func>
+inline void
+World::forEachEntity(Func&& func) {
+	for (auto& archetype : m_archetypes) {
+		if (archetype->entities.empty()) {
+			continue;
+		}
+
+		std::tuple<TComponentColumn<Ts>*...> columns(archetype->template getColumn<Ts>()...);
+		if (!(std::get<TComponentColumn<Ts>*>(columns) && ...)) {
+			continue;
+		}
+
+		const size_t count = archetype->entities.size();
+		for (size_t row = 0; row < count; ++row) {
+			func(archetype->entities[row], std::get<TComponentColumn<Ts>*>(columns)->data[row]...);
+		}
+	}
+}
+
+template<typename... Ts, typename Func>
+inline void
+World::parallelForEach(JobSystem& jobs, size_t grainSize, Func&& func) {
+	for (auto& archetype : m_archetypes) {
+		if (archetype->entities.empty()) {
+			continue;
+		}
+
+		std::tuple<TComponentColumn<Ts>*...> columns(archetype->template getColumn<Ts>()...);
+		if (!(std::get<TComponentColumn<Ts>*>(columns) && ...)) {
+			continue;
+		}
+
+		jobs.parallelFor(0, archetype->entities.size(), grainSize,
+			[&func, &columns](size_t first, size_t last) {
+				for (size_t row = first; row < last; ++row) {
+					func(std::get<TComponentColumn<Ts>*>(columns)->data[row]...);
+				}
+			});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#pragma once
+#include "Prerequisites.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+class
+	JobSystem;
+
+/**
+ * @class JobCounter
+ * @brief Counts the unfinished jobs of a group so callers can wait on them
+ * or schedule other jobs after them.
+ *
+ * A counter must outlive every job that signals it; call JobSystem::wait()
+ * on it before destroying it.
+ */
+class
+	JobCounter {
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	/**
+	 * @brief Checks whether every job signalling this counter has finished.
+	 */
+	bool
+		isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<int> m_pending{ 0 };            ///< Unfinished jobs.
+	std::mutex m_continuationMutex;             ///< Guards m_continuations.
+	std::vector<std::function<void()>> m_continuations; ///< Jobs waiting for zero.
+};
+
+/**
+ * @class JobSystem
+ * @brief Thread pool with one work-stealing deque per thread.
+ *
+ * Each worker pushes and pops its own jobs at the back of its deque (LIFO,
+ * cache friendly) and, when it runs dry, steals from the front of the other
+ * deques. The thread that created the system takes slot 0 and executes jobs
+ * while it waits on a counter, so it never just blocks.
+ *
+ * A waiting thread runs whatever frame job it finds, not only the ones of
+ * its counter, so schedule() is meant for short jobs. Long work that the
+ * frame does not wait for (file decoding, path searches) goes through
+ * scheduleBackground(): those jobs sit in a separate queue that only the
+ * workers take from, once no frame job is left, and wait() never runs them.
+ */
+class
+	JobSystem {
+public:
+	/**
+	 * @brief Starts the worker threads.
+	 * @param threadCount Total threads including the calling one
+	 * (0 = one per hardware core).
+	 */
+	explicit
+		JobSystem(unsigned int threadCount = 0);
+
+	/**
+	 * @brief Stops and joins every worker thread.
+	 */
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	/**
+	 * @brief Schedules a short job.
+	 *
+	 * Any thread waiting on a counter may run it, including the main thread
+	 * in the middle of a frame; long jobs belong in scheduleBackground().
+	 *
+	 * @param job Work to run on any thread.
+	 * @param counter Optional counter incremented now and decremented when
+	 * the job finishes.
+	 */
+	void
+		schedule(std::function<void()> job, JobCounter* counter = nullptr);
+
+	/**
+	 * @brief Schedules a long job that only the worker threads run.
+	 *
+	 * Background jobs run in FIFO order once the workers have no frame job
+	 * left, and wait() never picks them up. Without worker threads the job
+	 * runs right away on the calling thread.
+	 *
+	 * @param job Work to run on a worker thread.
+	 * @param counter Optional counter incremented now and decremented when
+	 * the job finishes.
+	 */
+	void
+		scheduleBackground(std::function<void()> job, JobCounter* counter = nullptr);
+
+	/**
+	 * @brief Schedules a job that only starts once @p dependency reaches zero.
+	 * @param dependency Counter the job depends on.
+	 * @param job Work to run.
+	 * @param counter Optional counter signalled when the job finishes.
+	 */
+	void
+		scheduleAfter(JobCounter& dependency,
+			std::function<void()> job,
+			JobCounter* counter = nullptr);
+
+	/**
+	 * @brief Runs other frame jobs until the counter reaches zero.
+	 *
+	 * Background jobs are left to the workers; waiting on their counter
+	 * only helps with frame jobs in the meantime.
+	 *
+	 * @param counter Counter to wait for.
+	 */
+	void
+		wait(JobCounter& counter);
+
+	/**
+	 * @brief Splits [begin, end) into chunks and processes them in parallel.
+	 *
+	 * Blocks until every chunk is done. Ranges not larger than @p grainSize
+	 * run inline on the calling thread.
+	 *
+	 * @param begin First index.
+	 * @param end One past the last index.
+	 * @param grainSize Minimum number of indices per job.
+	 * @param func Callable taking (size_t first, size_t last).
+	 */
+	template<typename Func>
+	void
+		parallelFor(size_t begin, size_t end, size_t grainSize, Func&& func);
+
+	/**
+	 * @brief Checks whether the calling thread is a worker of any JobSystem.
+	 *
+	 * Code that is not thread safe (e.g. the CShape pools) uses it to refuse
+	 * running inside a job.
+	 */
+	static bool
+		isWorkerThread();
+
+	/**
+	 * @brief Number of threads executing jobs, including the owner thread.
+	 */
+	unsigned int
+		getThreadCount() const { return static_cast<unsigned int>(m_queues.size()); }
+
+private:
+	/**
+	 * @brief Deque of one thread; the owner uses the back, thieves the front.
+	 */
+	struct
+		WorkQueue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> jobs;
+	};
+
+	/**
+	 * @brief Main loop of a worker thread.
+	 */
+	void
+		workerLoop(unsigned int index);
+
+	/**
+	 * @brief Pops a local job or steals one; runs it.
+	 * @param index Slot of the calling thread.
+	 * @param background Whether a background job may run when no frame
+	 * job is left (workers only).
+	 * @return True if a job was executed.
+	 */
+	bool
+		runOneJob(unsigned int index, bool background);
+
+	/**
+	 * @brief Pushes a ready job in the queue of the calling thread.
+	 */
+	void
+		push(std::function<void()> job);
+
+	/**
+	 * @brief Wraps a job so it signals its counter and releases dependants.
+	 */
+	std::function<void()>
+		wrap(std::function<void()> job, JobCounter* counter);
+
+	/**
+	 * @brief Slot of the calling thread (0 for the owner and foreign threads).
+	 */
+	unsigned int
+		currentIndex() const;
+
+	std::vector<EngineUtilities::TUniquePtr<WorkQueue>> m_queues; ///< One deque per thread.
+	WorkQueue m_background;              ///< Long jobs, FIFO, taken by the workers only.
+	std::vector<std::thread> m_workers;  ///< Worker threads (slots 1..N-1).
+	std::atomic<int> m_queuedJobs{ 0 };  ///< Jobs waiting in any queue.
+	std::atomic<bool> m_running{ true }; ///< Cleared on shutdown.
+	std::mutex m_sleepMutex;             ///< Guards m_wakeUp.
+	std::condition_variable m_wakeUp;    ///< Wakes idle workers.
+};
+
+// -------- Template implementation --------
+
+template<typename Func>
+inline void
+JobSystem::parallelFor(size_t begin, size_t end, size_t grainSize, Func&& func) {
+	if (end <= begin) {
+		return;
+	}
+	if (grainSize == 0) {
+		grainSize = 1;
+	}
+
+	const size_t count = end - begin;
+	if (count <= grainSize || m_queues.size() == 1) {
+		func(begin, end);
+		return;
+	}
+
+	JobCounter counter;
+	for (size_t first = begin; first < end; first += grainSize) {
+		size_t last = std::min(first + grainSize, end);
+		schedule([&func, first, last]() { func(first, last); }, &counter);
+	}
+	wait(counter);
+}
@@ -0,0 +1,318 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log message.
+ */
+enum
+	LogLevel {
+	LOG_LEVEL_DEBUG = 0,   ///< Detailed information for debugging.
+	LOG_LEVEL_INFO = 1,    ///< Normal events (resource creation, statistics).
+	LOG_LEVEL_WARNING = 2, ///< Something unexpected that the engine recovered from.
+	LOG_LEVEL_ERROR = 3    ///< Fatal problems; ERROR exits after logging them.
+};
+
+/**
+ * @class Logger
+ * @brief Asynchronous logger fed by the LOG_* macros.
+ *
+ * Callers never format text nor touch a stream: a message claims a slot of
+ * a bounded multi-producer ring buffer with one compare-and-swap, its
+ * arguments are copied into the slot as raw values and the slot is
+ * published. A background thread turns the slots into text and writes them
+ * to the console and/or a file.
+ *
+ * The caller cost is bounded: when the ring is full the message is dropped
+ * (and counted) instead of waiting, except for errors, which wait for space
+ * because the program is about to exit.
+ */
+class
+	Logger {
+public:
+	/**
+	 * @brief Bytes of argument data a message can hold; longer messages are cut.
+	 */
+	static const size_t PAYLOAD_SIZE = 224;
+
+	/**
+	 * @brief One message in the ring buffer.
+	 */
+	struct
+		Record {
+		std::atomic<uint64_t> sequence;  ///< Ring position this slot is ready for.
+		int64_t time;                    ///< Nanoseconds since the logger started.
+		uint32_t thread;                 ///< Small id of the calling thread.
+		uint8_t level;                   ///< LogLevel of the message.
+		bool truncated;                  ///< The arguments did not fit.
+		uint16_t size;                   ///< Used bytes of data.
+		char data[PAYLOAD_SIZE];         ///< Encoded arguments.
+	};
+
+	/**
+	 * @brief Logger shared by the whole engine; starts its thread on first use.
+	 */
+	static Logger&
+		getInstance();
+
+	/**
+	 * @brief Drains the pending messages and stops the background thread.
+	 */
+	~Logger();
+
+	Logger(const Logger&) = delete;
+	Logger& operator=(const Logger&) = delete;
+
+	/**
+	 * @brief Run-time minimum level; messages below it are skipped.
+	 */
+	void
+		setLevel(LogLevel level) { m_level.store(level, std::memory_order_relaxed); }
+
+	bool
+		isEnabled(LogLevel level) const { return level >= m_level.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Enables or disables writing to std::cerr (enabled by default).
+	 */
+	void
+		setConsoleOutput(bool enabled) { m_console.store(enabled, std::memory_order_relaxed); }
+
+	/**
+	 * @brief Also writes every message to a file (empty path = no file).
+	 * @return False if the file could not be opened.
+	 */
+	bool
+		setLogFile(const std::string& path);
+
+	/**
+	 * @brief Waits until every message logged before the call is written.
+	 */
+	void
+		flush();
+
+	/**
+	 * @brief Messages lost because the ring buffer was full.
+	 */
+	uint64_t
+		getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Claims a slot for a new message.
+	 * @return The slot to fill, or nullptr if the ring is full.
+	 */
+	Record*
+		acquire(LogLevel level);
+
+	/**
+	 * @brief Publishes a slot filled after acquire().
+	 */
+	void
+		commit(Record* record);
+
+private:
+	Logger();
+
+	/**
+	 * @brief Body of the background thread.
+	 */
+	void
+		run();
+
+	/**
+	 * @brief Writes every published message.
+	 * @return Number of messages written.
+	 */
+	size_t
+		drain();
+
+	/**
+	 * @brief Appends the text line of a slot to @p text.
+	 */
+	void
+		format(const Record& record, std::string& text) const;
+
+	std::unique_ptr<Record[]> m_records;        ///< Ring buffer.
+	size_t m_mask;                              ///< Capacity - 1.
+	alignas(64) std::atomic<uint64_t> m_enqueuePos{ 0 };
+	alignas(64) std::atomic<uint64_t> m_dequeuePos{ 0 };
+
+	std::atomic<int> m_level{ LOG_LEVEL_DEBUG };
+	std::atomic<bool> m_console{ true };
+	std::atomic<uint64_t> m_dropped{ 0 };
+	uint64_t m_reportedDrops = 0;               ///< Drops already reported (logger thread).
+	int64_t m_epoch;                            ///< Start time for the message stamps.
+
+	std::mutex m_fileMutex;                     ///< Guards m_file.
+	std::ofstream m_file;
+
+	std::atomic<bool> m_running{ true };
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wakeCondition;
+	std::thread m_thread;
+};
+
+/**
+ * @brief Marks the end of a field (class, method) inside an encoded message.
+ */
+struct
+	LogField {};
+
+/**
+ * @class LogWriter
+ * @brief Copies the arguments of one message into its ring slot.
+ *
+ * Strings are copied and numbers are stored as binary values; they are only
+ * converted to text on the logger thread. Other streamable types are
+ * formatted here as a fallback.
+ */
+class
+	LogWriter {
+public:
+	explicit
+		LogWriter(LogLevel level)
+		: m_record(Logger::getInstance().acquire(level)) {}
+
+	~LogWriter() {
+		if (m_record) {
+			Logger::getInstance().commit(m_record);
+		}
+	}
+
+	LogWriter(const LogWriter&) = delete;
+	LogWriter& operator=(const LogWriter&) = delete;
+
+	/**
+	 * @brief Encoding tags of the values in a Record.
+	 */
+	enum
+		Tag : uint8_t {
+		TAG_FIELD = 0,
+		TAG_STRING = 1,
+		TAG_INT = 2,
+		TAG_UINT = 3,
+		TAG_DOUBLE = 4,
+		TAG_CHAR = 5,
+		TAG_BOOL = 6
+	};
+
+	LogWriter&
+		operator<<(LogField) {
+		put(TAG_FIELD, nullptr, 0);
+		return *this;
+	}
+
+	LogWriter&
+		operator<<(const char* text) {
+		putString(text ? text : "(null)", text ? std::strlen(text) : 6);
+		return *this;
+	}
+
+	LogWriter&
+		operator<<(const std::string& text) {
+		putString(text.data(), text.size());
+		return *this;
+	}
+
+	LogWriter&
+		operator<<(char value) {
+		put(TAG_CHAR, &value, sizeof(value));
+		return *this;
+	}
+
+	LogWriter&
+		operator<<(bool value) {
+		put(TAG_BOOL, &value, sizeof(value));
+		return *this;
+	}
+
+	/**
+	 * @brief Integers and floating point numbers, stored without formatting.
+	 */
+	template<typename T>
+	typename std::enable_if<std::is_arithmetic<T>::value, LogWriter&>::type
+		operator<<(T value) {
+		if (std::is_floating_point<T>::value) {
+			double number = static_cast<double>(value);
+			put(TAG_DOUBLE, &number, sizeof(number));
+		}
+		else if (std::is_signed<T>::value) {
+			int64_t number = static_cast<int64_t>(value);
+			put(TAG_INT, &number, sizeof(number));
+		}
+		else {
+			uint64_t number = static_cast<uint64_t>(value);
+			put(TAG_UINT, &number, sizeof(number));
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Any other type with an ostream operator, formatted now.
+	 */
+	template<typename T>
+	typename std::enable_if<!std::is_arithmetic<T>::value, LogWriter&>::type
+		operator<<(const T& value) {
+		if (m_record) {
+			std::ostringstream os;
+			os << value;
+			*this << os.str();
+		}
+		return *this;
+	}
+
+private:
+	void
+		putString(const char* text, size_t length) {
+		if (!m_record) {
+			return;
+		}
+		const size_t header = 1 + sizeof(uint16_t);
+		if (m_record->size + header >= Logger::PAYLOAD_SIZE) {
+			m_record->truncated = true;
+			return;
+		}
+
+		// Keep as much of the string as fits
+		size_t room = Logger::PAYLOAD_SIZE - m_record->size - header;
+		if (length > room) {
+			length = room;
+			m_record->truncated = true;
+		}
+		uint16_t size = static_cast<uint16_t>(length);
+		char* out = m_record->data + m_record->size;
+		out[0] = static_cast<char>(TAG_STRING);
+		std::memcpy(out + 1, &size, sizeof(size));
+		std::memcpy(out + header, text, length);
+		m_record->size = static_cast<uint16_t>(m_record->size + header + length);
+	}
+
+	void
+		put(Tag tag, const void* value, size_t size) {
+		if (!m_record) {
+			return;
+		}
+		if (m_record->size + 1 + size > Logger::PAYLOAD_SIZE) {
+			m_record->truncated = true;
+			return;
+		}
+		char* out = m_record->data + m_record->size;
+		out[0] = static_cast<char>(tag);
+		if (size > 0) {
+			std::memcpy(out + 1, value, size);
+		}
+		m_record->size = static_cast<uint16_t>(m_record->size + 1 + size);
+	}
+
+	Logger::Record* m_record; ///< Slot being filled, nullptr if dropped.
+};
@@ -0,0 +1,199 @@
+#pragma once
+#include "Prerequisites.h"
+#include "ESC/World.h"
+
+/**
+ * @class LooseQuadtree
+ * @brief Dynamic loose quadtree over entity bounding boxes.
+ *
+ * Every node covers a square cell, but the objects it holds may spill out
+ * of it up to half a cell on each side (loose factor 2). That way an object
+ * is stored by its center and size alone: its node is found in O(depth)
+ * without testing bounds, and small movements usually keep it in the same
+ * node, so update() is O(1) for most frames.
+ *
+ * Objects whose center falls outside the root cell are kept in the root
+ * and always tested.
+ */
+class
+	LooseQuadtree {
+public:
+	/**
+	 * @brief Constructor.
+	 * @param worldBounds Area covered by the root cell.
+	 * @param maxDepth Maximum number of subdivisions.
+	 */
+	explicit
+		LooseQuadtree(const sf::FloatRect& worldBounds, unsigned int maxDepth = 8);
+
+	/**
+	 * @brief Inserts an entity, or moves it if it is already in the tree.
+	 * @param entity Entity identifier.
+	 * @param bounds World bounding box of the entity.
+	 */
+	void
+		update(EntityID entity, const sf::FloatRect& bounds);
+
+	/**
+	 * @brief Removes an entity from the tree (no-op if absent).
+	 * @param entity Entity identifier.
+	 */
+	void
+		remove(EntityID entity);
+
+	/**
+	 * @brief Removes every entity, keeping the allocated nodes.
+	 */
+	void
+		clear();
+
+	/**
+	 * @brief Finds the entities whose bounds intersect an area.
+	 * @param area Query rectangle (e.g. the view bounds).
+	 * @param out Receives the entities found (appended, unordered). Any
+	 * allocator works, e.g. a TFrameVector on the frame arena.
+	 */
+	template<typename Allocator>
+	void
+		query(const sf::FloatRect& area, std::vector<EntityID, Allocator>& out) const;
+
+	/**
+	 * @brief Finds the entities whose bounds contain a point.
+	 * @param point World position.
+	 * @param out Receives the entities found (appended, unordered).
+	 */
+	template<typename Allocator>
+	void
+		queryPoint(const sf::Vector2f& point, std::vector<EntityID, Allocator>& out) const;
+
+	/**
+	 * @brief Picks the entity under a point.
+	 *
+	 * When several bounds overlap, the highest identifier wins, which is
+	 * the one drawn last.
+	 *
+	 * @param point World position.
+	 * @param entity Receives the picked entity.
+	 * @return True if an entity was found.
+	 */
+	bool
+		pick(const sf::Vector2f& point, EntityID& entity) const;
+
+	/**
+	 * @brief Number of entities in the tree.
+	 */
+	size_t
+		size() const { return m_itemCount; }
+
+private:
+	/**
+	 * @brief Entity stored in a node.
+	 */
+	struct
+		Item {
+		EntityID entity;
+		sf::FloatRect bounds;
+	};
+
+	/**
+	 * @brief Square cell of the tree.
+	 */
+	struct
+		Node {
+		sf::Vector2f center;       ///< Center of the cell.
+		float halfSize;            ///< Half side of the cell (loose half side is 2x).
+		int parent;                ///< Parent node, -1 for the root.
+		int children[4];           ///< Child nodes by quadrant, -1 if absent.
+		uint32_t subtreeCount;     ///< Items in this node and below.
+		std::vector<Item> items;   ///< Items stored in this node.
+	};
+
+	/**
+	 * @brief Location of an entity in the tree.
+	 */
+	struct
+		Record {
+		int node = -1;     ///< Node holding the entity, -1 if absent.
+		uint32_t slot = 0; ///< Index in the node items.
+	};
+
+	/**
+	 * @brief Node that should hold the given bounds.
+	 * @param create Create missing nodes on the way down.
+	 * @return Node index, or -1 if it does not exist and @p create is false.
+	 */
+	int
+		findNode(const sf::FloatRect& bounds, bool create);
+
+	/**
+	 * @brief Removes the item of a record from its node.
+	 */
+	void
+		detach(Record& record);
+
+	/**
+	 * @brief Visits the items of every node whose loose bounds pass @p nodeTest.
+	 */
+	template<typename NodeTest, typename ItemFunc>
+	void
+		visit(NodeTest&& nodeTest, ItemFunc&& itemFunc) const;
+
+	std::vector<Node> m_nodes;     ///< Node storage, root at index 0.
+	std::vector<Record> m_records; ///< Location of each entity, indexed by id.
+	unsigned int m_maxDepth;       ///< Maximum subdivisions.
+	size_t m_itemCount = 0;        ///< Entities in the tree.
+};
+
+// -------- Template implementation --------
+
+template<typename Allocator>
+inline void
+LooseQuadtree::query(const sf::FloatRect& area, std::vector<EntityID, Allocator>& out) const {
+	visit(
+		[&area](const sf::FloatRect& loose) { return loose.intersects(area); },
+		[&area, &out](const Item& item) {
+			if (item.bounds.intersects(area)) {
+				out.push_back(item.entity);
+			}
+		});
+}
+
+template<typename Allocator>
+inline void
+LooseQuadtree::queryPoint(const sf::Vector2f& point, std::vector<EntityID, Allocator>& out) const {
+	visit(
+		[&point](const sf::FloatRect& loose) { return loose.contains(point); },
+		[&point, &out](const Item& item) {
+			if (item.bounds.contains(point)) {
+				out.push_back(item.entity);
+			}
+		});
+}
+
+template<typename NodeTest, typename ItemFunc>
+inline void
+LooseQuadtree::visit(NodeTest&& nodeTest, ItemFunc&& itemFunc) const {
+	int stack[64 * 4];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0) {
+		const Node& node = m_nodes[stack[--top]];
+		for (const Item& item : node.items) {
+			itemFunc(item);
+		}
+
+		for (int child : node.children) {
+			if (child < 0 || m_nodes[child].subtreeCount == 0) {
+				continue;
+			}
+			const Node& childNode = m_nodes[child];
+			const float looseHalf = childNode.halfSize * 2.f;
+			sf::FloatRect loose(childNode.center.x - looseHalf, childNode.center.y - looseHalf,
+				looseHalf * 2.f, looseHalf * 2.f);
+			if (nodeTest(loose)) {
+				stack[top++] = child;
+			}
+		}
+	}
+}
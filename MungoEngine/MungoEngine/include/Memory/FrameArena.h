@@ -0,0 +1,191 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace EngineUtilities {
+	/**
+	 * @brief Clase FrameArena, reserva lineal para datos que solo viven un frame.
+	 *
+	 * Reservar es mover un desplazamiento dentro de un bloque; liberar no hace
+	 * nada y todo se descarta junto en reset(), que Window::update() llama una
+	 * vez por frame. Si un frame necesita ms memoria que la disponible se
+	 * piden bloques extra al heap, y en el siguiente reset() el bloque principal
+	 * crece hasta el mximo observado, as que en rgimen estable no hay
+	 * llamadas a malloc.
+	 *
+	 * No es seguro entre hilos.
+	 */
+	class FrameArena
+	{
+	public:
+		/**
+		 * @brief Constructor.
+		 *
+		 * @param capacity Tamao inicial en bytes del bloque principal.
+		 */
+		explicit FrameArena(size_t capacity = 1024 * 1024)
+			: m_buffer(new unsigned char[capacity]), m_capacity(capacity) {}
+
+		/**
+		 * @brief Destructor. Libera el bloque principal y los bloques extra.
+		 */
+		~FrameArena()
+		{
+			releaseOverflow();
+			delete[] m_buffer;
+		}
+
+		// Prohibir la copia: la memoria entregada pertenece a esta arena
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		/**
+		 * @brief Reserva memoria vlida hasta el prximo reset().
+		 *
+		 * @param size Nmero de bytes.
+		 * @param alignment Alineacin requerida (potencia de dos).
+		 * @return Puntero a la memoria reservada.
+		 */
+		void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+		{
+			uintptr_t base = reinterpret_cast<uintptr_t>(m_buffer);
+			uintptr_t aligned = (base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			size_t newOffset = static_cast<size_t>(aligned - base) + size;
+
+			if (newOffset <= m_capacity)
+			{
+				m_offset = newOffset;
+				m_frameUsed = m_offset + m_overflowBytes;
+				return reinterpret_cast<void*>(aligned);
+			}
+
+			// No cabe: bloque extra del heap hasta el prximo reset
+			unsigned char* block = new unsigned char[size + alignment];
+			m_overflowBlocks.push_back(block);
+			m_overflowBytes += size + alignment;
+			m_frameUsed = m_offset + m_overflowBytes;
+			uintptr_t blockAligned = (reinterpret_cast<uintptr_t>(block) + alignment - 1)
+				& ~(uintptr_t)(alignment - 1);
+			return reinterpret_cast<void*>(blockAligned);
+		}
+
+		/**
+		 * @brief No hace nada: la memoria se recupera en reset().
+		 */
+		void deallocate(void*, size_t) {}
+
+		/**
+		 * @brief Descarta todo lo reservado en el frame y registra su mximo.
+		 */
+		void reset()
+		{
+			m_lastFrameHighWater = m_frameUsed;
+			if (m_frameUsed > m_highWater)
+			{
+				m_highWater = m_frameUsed;
+			}
+
+			// Si el frame no cupo, crecer para que el siguiente s quepa
+			if (!m_overflowBlocks.empty())
+			{
+				releaseOverflow();
+				delete[] m_buffer;
+				m_capacity = m_frameUsed;
+				m_buffer = new unsigned char[m_capacity];
+			}
+
+			m_offset = 0;
+			m_frameUsed = 0;
+		}
+
+		/**
+		 * @brief Bytes reservados en el frame actual.
+		 */
+		size_t getUsed() const { return m_frameUsed; }
+
+		/**
+		 * @brief Tamao del bloque principal en bytes.
+		 */
+		size_t getCapacity() const { return m_capacity; }
+
+		/**
+		 * @brief Bytes usados por el ltimo frame terminado.
+		 */
+		size_t getLastFrameHighWaterMark() const { return m_lastFrameHighWater; }
+
+		/**
+		 * @brief Mximo de bytes usados por un frame desde la creacin.
+		 */
+		size_t getHighWaterMark() const { return m_highWater; }
+
+	private:
+		/**
+		 * @brief Libera los bloques extra pedidos al heap.
+		 */
+		void releaseOverflow()
+		{
+			for (unsigned char* block : m_overflowBlocks)
+			{
+				delete[] block;
+			}
+			m_overflowBlocks.clear();
+			m_overflowBytes = 0;
+		}
+
+		unsigned char* m_buffer;                     ///< Bloque principal.
+		size_t m_capacity;                           ///< Tamao del bloque principal.
+		size_t m_offset = 0;                         ///< Prximo byte libre del bloque principal.
+		size_t m_frameUsed = 0;                      ///< Bytes usados en el frame actual.
+		size_t m_lastFrameHighWater = 0;             ///< Bytes usados por el frame anterior.
+		size_t m_highWater = 0;                      ///< Mximo histrico por frame.
+		size_t m_overflowBytes = 0;                  ///< Bytes en bloques extra.
+		std::vector<unsigned char*> m_overflowBlocks; ///< Bloques extra del frame actual.
+	};
+
+	/**
+	 * @brief Adaptador de asignador STL que reserva en una FrameArena.
+	 *
+	 * Permite usar contenedores estndar para datos de un frame sin llamar a
+	 * malloc. Los contenedores deben destruirse antes del siguiente reset().
+	 *
+	 * @code
+	 * TFrameVector<float> distances{ TFrameAllocator<float>(arena) };
+	 * @endcode
+	 */
+	template<typename T>
+	class TFrameAllocator
+	{
+	public:
+		using value_type = T;
+
+		explicit TFrameAllocator(FrameArena& frameArena) : arena(&frameArena) {}
+
+		template<typename U>
+		TFrameAllocator(const TFrameAllocator<U>& other) : arena(other.arena) {}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* memory, size_t count)
+		{
+			arena->deallocate(memory, count * sizeof(T));
+		}
+
+		template<typename U>
+		bool operator==(const TFrameAllocator<U>& other) const { return arena == other.arena; }
+
+		template<typename U>
+		bool operator!=(const TFrameAllocator<U>& other) const { return arena != other.arena; }
+
+		FrameArena* arena; ///< Arena de la que se reserva.
+	};
+
+	/**
+	 * @brief std::vector que reserva en una FrameArena.
+	 */
+	template<typename T>
+	using TFrameVector = std::vector<T, TFrameAllocator<T>>;
+}
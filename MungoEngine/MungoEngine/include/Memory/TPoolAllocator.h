@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace EngineUtilities {
+	/**
+	 * @brief Clase TPoolAllocator, reserva de bloques de tamao fijo para objetos de tipo T.
+	 *
+	 * La memoria se pide al sistema por pginas de varios bloques y los bloques
+	 * libres se encadenan en una lista libre, as que reservar y liberar son
+	 * O(1) y no fragmentan el heap cuando se crean y destruyen muchos objetos
+	 * del mismo tipo (proyectiles, partculas, componentes).
+	 *
+	 * No es seguro entre hilos: cada pool debe usarse desde un solo hilo.
+	 * Los objetos deben devolverse al pool antes de destruirlo.
+	 */
+	template<typename T>
+	class TPoolAllocator
+	{
+	public:
+		/**
+		 * @brief Constructor.
+		 *
+		 * @param slotsPerPage Nmero de bloques que se reservan cada vez que el pool crece.
+		 */
+		explicit TPoolAllocator(size_t slotsPerPage = 64)
+			: m_slotsPerPage(slotsPerPage > 0 ? slotsPerPage : 1) {}
+
+		/**
+		 * @brief Destructor. Devuelve al sistema todas las pginas.
+		 */
+		~TPoolAllocator()
+		{
+			for (Slot* page : m_pages)
+			{
+				delete[] page;
+			}
+		}
+
+		// Prohibir la copia: los bloques entregados pertenecen a este pool
+		TPoolAllocator(const TPoolAllocator&) = delete;
+		TPoolAllocator& operator=(const TPoolAllocator&) = delete;
+
+		/**
+		 * @brief Reserva memoria sin construir para un objeto T.
+		 *
+		 * @return Puntero a un bloque con tamao y alineacin de T.
+		 */
+		void* allocate()
+		{
+			if (m_freeList == nullptr)
+			{
+				grow();
+			}
+			Slot* slot = m_freeList;
+			m_freeList = slot->next;
+			++m_usedCount;
+			return slot->storage;
+		}
+
+		/**
+		 * @brief Devuelve al pool un bloque obtenido con allocate().
+		 *
+		 * @param memory Bloque a liberar (el objeto ya debe estar destruido).
+		 */
+		void deallocate(void* memory)
+		{
+			if (memory == nullptr)
+			{
+				return;
+			}
+			Slot* slot = static_cast<Slot*>(memory);
+			slot->next = m_freeList;
+			m_freeList = slot;
+			--m_usedCount;
+		}
+
+		/**
+		 * @brief Reserva un bloque y construye un T en l.
+		 *
+		 * @param args Argumentos reenviados al constructor de T.
+		 * @return Puntero al nuevo objeto.
+		 */
+		template<typename... Args>
+		T* create(Args&&... args)
+		{
+			return new (allocate()) T(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * @brief Destruye un objeto creado con create() y devuelve su bloque.
+		 *
+		 * @param object Objeto a destruir.
+		 */
+		void destroy(T* object)
+		{
+			if (object != nullptr)
+			{
+				object->~T();
+				deallocate(object);
+			}
+		}
+
+		/**
+		 * @brief Nmero de bloques entregados y an no devueltos.
+		 */
+		size_t getUsedCount() const { return m_usedCount; }
+
+		/**
+		 * @brief Nmero total de bloques reservados en todas las pginas.
+		 */
+		size_t getCapacity() const { return m_pages.size() * m_slotsPerPage; }
+
+	private:
+		/**
+		 * @brief Bloque del pool: libre guarda el siguiente libre, ocupado guarda un T.
+		 */
+		union Slot
+		{
+			Slot* next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		/**
+		 * @brief Reserva una pgina nueva y encadena sus bloques en la lista libre.
+		 */
+		void grow()
+		{
+			Slot* page = new Slot[m_slotsPerPage];
+			for (size_t i = 0; i + 1 < m_slotsPerPage; ++i)
+			{
+				page[i].next = &page[i + 1];
+			}
+			page[m_slotsPerPage - 1].next = m_freeList;
+			m_freeList = page;
+			m_pages.push_back(page);
+		}
+
+		size_t m_slotsPerPage;      ///< Bloques por pgina.
+		size_t m_usedCount = 0;     ///< Bloques en uso.
+		Slot* m_freeList = nullptr; ///< Primer bloque libre.
+		std::vector<Slot*> m_pages; ///< Pginas reservadas.
+	};
+
+	/**
+	 * @brief Deleter para TUniquePtr que devuelve el objeto a su TPoolAllocator.
+	 */
+	template<typename T>
+	struct TPoolDeleter
+	{
+		TPoolDeleter() = default;
+		explicit TPoolDeleter(TPoolAllocator<T>* allocator) : pool(allocator) {}
+
+		void operator()(T* object) const
+		{
+			if (pool != nullptr)
+			{
+				pool->destroy(object);
+			}
+		}
+
+		TPoolAllocator<T>* pool = nullptr; ///< Pool del que proviene el objeto.
+	};
+}
@@ -27,103 +27,325 @@
  * SOFTWARE.
 */
 #pragma once
+#include <new>
+#include <utility>
+#include <atomic>
+#include "TPoolAllocator.h"
 
 namespace EngineUtilities {
+	/**
+	 * @brief Poltica de recuento de referencias para un solo hilo.
+	 *
+	 * Usa un entero simple; es la opcin por defecto y la ms rpida.
+	 */
+	struct SingleThreadRefCount
+	{
+		using Counter = int;
+
+		static void increment(Counter& count) { ++count; }
+
+		/**
+		 * @brief Disminuye el contador.
+		 * @return true si el contador lleg a cero.
+		 */
+		static bool decrement(Counter& count) { return --count == 0; }
+
+		/**
+		 * @brief Aumenta el contador solo si no es cero.
+		 * @return true si se pudo tomar la referencia.
+		 */
+		static bool incrementIfNotZero(Counter& count)
+		{
+			if (count == 0)
+			{
+				return false;
+			}
+			++count;
+			return true;
+		}
+
+		static int load(const Counter& count) { return count; }
+	};
+
+	/**
+	 * @brief Poltica de recuento de referencias segura entre hilos.
+	 *
+	 * Los incrementos son relaxed (quien copia ya tiene una referencia) y los
+	 * decrementos acq_rel, para que la destruccin vea todas las escrituras
+	 * hechas por los dems hilos sobre el objeto.
+	 */
+	struct AtomicRefCount
+	{
+		using Counter = std::atomic<int>;
+
+		static void increment(Counter& count)
+		{
+			count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		static bool decrement(Counter& count)
+		{
+			return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+		}
+
+		static bool incrementIfNotZero(Counter& count)
+		{
+			int current = count.load(std::memory_order_relaxed);
+			while (current != 0)
+			{
+				if (count.compare_exchange_weak(current, current + 1,
+					std::memory_order_acq_rel, std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		static int load(const Counter& count)
+		{
+			return count.load(std::memory_order_acquire);
+		}
+	};
+
+	/**
+	 * @brief Bloque de control compartido por todas las instancias que apuntan
+	 * al mismo objeto.
+	 *
+	 * Guarda el recuento de referencias y sabe cmo destruir el objeto
+	 * gestionado sin conocer su tipo concreto.
+	 *
+	 * @tparam Policy Poltica de recuento (SingleThreadRefCount o AtomicRefCount).
+	 */
+	template<typename Policy>
+	struct TControlBlock
+	{
+		typename Policy::Counter strongCount{ 1 }; ///< Nmero de TSharedPointer que poseen el objeto.
+
+		/**
+		 * @brief Nmero de TWeakPointer vivos, ms uno mientras strongCount > 0.
+		 *
+		 * El bloque de control se libera cuando este contador llega a cero.
+		 */
+		typename Policy::Counter weakCount{ 1 };
+
+		virtual ~TControlBlock() = default;
+
+		/**
+		 * @brief Destruye el objeto gestionado (no libera el bloque de control).
+		 */
+		virtual void destroyObject() = 0;
+
+		/**
+		 * @brief Libera la memoria del propio bloque de control.
+		 */
+		virtual void deallocate() { delete this; }
+
+		/**
+		 * @brief Suelta una referencia fuerte; destruye el objeto en la ltima.
+		 */
+		static void releaseStrong(TControlBlock* block)
+		{
+			if (Policy::decrement(block->strongCount))
+			{
+				block->destroyObject();
+				releaseWeak(block);
+			}
+		}
+
+		/**
+		 * @brief Suelta una referencia dbil; libera el bloque en la ltima.
+		 */
+		static void releaseWeak(TControlBlock* block)
+		{
+			if (Policy::decrement(block->weakCount))
+			{
+				block->deallocate();
+			}
+		}
+	};
+
+	/**
+	 * @brief Bloque de control para un objeto reservado por separado con new.
+	 *
+	 * Se usa cuando TSharedPointer adopta un puntero crudo.
+	 */
+	template<typename T, typename Policy>
+	struct TPointerControlBlock : public TControlBlock<Policy>
+	{
+		explicit TPointerControlBlock(T* rawPtr) : object(rawPtr) {}
+
+		void destroyObject() override
+		{
+			delete object;
+			object = nullptr;
+		}
+
+		T* object; ///< Objeto gestionado.
+	};
+
+	/**
+	 * @brief Bloque de control que contiene el objeto en lnea.
+	 *
+	 * El objeto y el recuento de referencias comparten una nica reserva de
+	 * memoria, como en std::make_shared. Lo crea MakeShared.
+	 */
+	template<typename T, typename Policy>
+	struct TInlineControlBlock : public TControlBlock<Policy>
+	{
+		template<typename... Args>
+		explicit TInlineControlBlock(Args&&... args)
+		{
+			new (&storage) T(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * @brief Obtener el objeto almacenado en el bloque.
+		 */
+		T* get() { return reinterpret_cast<T*>(&storage); }
+
+		void destroyObject() override
+		{
+			get()->~T();
+		}
+
+		alignas(T) unsigned char storage[sizeof(T)]; ///< Memoria del objeto.
+	};
+
+	/**
+	 * @brief Bloque de control en lnea cuya memoria proviene de un TPoolAllocator.
+	 *
+	 * Lo crea MakeShared(pool, ...); al liberarse devuelve su bloque al pool.
+	 */
+	template<typename T, typename Policy>
+	struct TPooledControlBlock : public TInlineControlBlock<T, Policy>
+	{
+		using Pool = TPoolAllocator<TPooledControlBlock<T, Policy>>;
+
+		template<typename... Args>
+		explicit TPooledControlBlock(Pool* ownerPool, Args&&... args)
+			: TInlineControlBlock<T, Policy>(std::forward<Args>(args)...)
+			, pool(ownerPool) {}
+
+		void deallocate() override
+		{
+			pool->destroy(this);
+		}
+
+		Pool* pool; ///< Pool al que se devuelve el bloque.
+	};
+
+	/**
+	 * @brief Pool para crear TSharedPointer<T> con MakeShared(pool, ...).
+	 */
+	template<typename T, typename Policy = SingleThreadRefCount>
+	using TSharedPool = TPoolAllocator<TPooledControlBlock<T, Policy>>;
+
 	/**
 	 * @brief Clase TSharedPointer para manejar la gestin de memoria compartida.
 	 *
 	 * La clase TSharedPointer gestiona la memoria de un objeto de tipo T y lleva un
 	 * recuento de referencias para permitir la comparticin segura de un mismo objeto
 	 * en mltiples instancias de TSharedPointer.
+	 *
+	 * @tparam T Tipo del objeto gestionado.
+	 * @tparam Policy Poltica de recuento. Por defecto SingleThreadRefCount;
+	 * usar AtomicRefCount (TAtomicSharedPointer) para compartir entre hilos.
 	 */
-	template<typename T>
+	template<typename T, typename Policy = SingleThreadRefCount>
 	class TSharedPointer
 	{
 	public:
+		using ControlBlock = TControlBlock<Policy>;
+
 		/**
 		 * @brief Constructor por defecto.
 		 *
-		 * Inicializa el puntero y el recuento de referencias a nullptr.
+		 * Inicializa el puntero y el bloque de control a nullptr.
 		 */
-		TSharedPointer() : ptr(nullptr), refCount(nullptr) {}
+		TSharedPointer() : ptr(nullptr), controlBlock(nullptr) {}
 
 		/**
 		 * @brief Constructor que toma un puntero crudo.
 		 *
+		 * Reserva un bloque de control aparte. Para una nica reserva usar
+		 * MakeShared.
+		 *
 		 * @param rawPtr Puntero crudo al objeto que se va a gestionar.
 		 */
-		explicit TSharedPointer(T* rawPtr) : ptr(rawPtr), refCount(new int(1)) {}
+		explicit TSharedPointer(T* rawPtr)
+			: ptr(rawPtr)
+			, controlBlock(rawPtr ? new TPointerControlBlock<T, Policy>(rawPtr) : nullptr) {}
 
 		/**
-		 * @brief Constructor desde un puntero crudo y un recuento de referencias.
+		 * @brief Constructor desde un puntero crudo y un bloque de control existente.
 		 *
 		 * @param rawPtr Puntero crudo al objeto gestionado.
-		 * @param existingRefCount Puntero al recuento de referencias existente.
+		 * @param existingBlock Bloque de control que ya gestiona el objeto.
 		 */
-		TSharedPointer(T* rawPtr, int* existingRefCount) : ptr(rawPtr), refCount(existingRefCount)
+		TSharedPointer(T* rawPtr, ControlBlock* existingBlock)
+			: ptr(rawPtr), controlBlock(existingBlock)
 		{
-			if (refCount)
+			if (controlBlock)
 			{
-				++(*refCount);
+				Policy::increment(controlBlock->strongCount);
 			}
 		}
 
 		/**
 		 * @brief Constructor de copia.
 		 *
-		 * Copia el puntero y el recuento de referencias del otro TSharedPointer y
+		 * Copia el puntero y el bloque de control del otro TSharedPointer y
 		 * aumenta el recuento de referencias.
 		 *
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 */
-		TSharedPointer(const TSharedPointer<T>& other) : ptr(other.ptr), refCount(other.refCount)
+		TSharedPointer(const TSharedPointer& other)
+			: ptr(other.ptr), controlBlock(other.controlBlock)
 		{
-			if (refCount)
+			if (controlBlock)
 			{
-				++(*refCount);
+				Policy::increment(controlBlock->strongCount);
 			}
 		}
 
 		/**
 		 * @brief Constructor de movimiento.
 		 *
-		 * Transfiere la propiedad del puntero y el recuento de referencias del otro
+		 * Transfiere la propiedad del puntero y el bloque de control del otro
 		 * TSharedPointer al nuevo objeto TSharedPointer.
 		 *
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 */
-		TSharedPointer(TSharedPointer<T>&& other) noexcept : ptr(other.ptr), refCount(other.refCount)
+		TSharedPointer(TSharedPointer&& other) noexcept
+			: ptr(other.ptr), controlBlock(other.controlBlock)
 		{
 			other.ptr = nullptr;
-			other.refCount = nullptr;
+			other.controlBlock = nullptr;
 		}
 
 		/**
 		 * @brief Operador de asignacin de copia.
 		 *
-		 * Libera el objeto actual, copia el puntero y el recuento de referencias del otro
+		 * Libera el objeto actual, copia el puntero y el bloque de control del otro
 		 * TSharedPointer, y aumenta el recuento de referencias.
 		 *
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 * @return Referencia al objeto TSharedPointer actual.
 		 */
-		TSharedPointer<T>& operator=(const TSharedPointer<T>& other)
+		TSharedPointer& operator=(const TSharedPointer& other)
 		{
 			if (this != &other)
 			{
-				// Disminuir el recuento de referencias del objeto actual
-				if (refCount && --(*refCount) == 0)
+				// Tomar la nueva referencia antes de soltar la actual
+				if (other.controlBlock)
 				{
-					delete ptr;
-					delete refCount;
+					Policy::increment(other.controlBlock->strongCount);
 				}
+				releaseReference();
 				// Copiar datos del otro puntero compartido
 				ptr = other.ptr;
-				refCount = other.refCount;
-				if (refCount)
-				{
-					++(*refCount);
-				}
+				controlBlock = other.controlBlock;
 			}
 			return *this;
 		}
@@ -131,35 +353,31 @@ namespace EngineUtilities {
 		/**
 		 * @brief Operador de asignacin de movimiento.
 		 *
-		 * Libera el objeto actual, transfiere la propiedad del puntero y el recuento de
-		 * referencias del otro TSharedPointer al actual.
+		 * Libera el objeto actual, transfiere la propiedad del puntero y el bloque
+		 * de control del otro TSharedPointer al actual.
 		 *
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 * @return Referencia al objeto TSharedPointer actual.
 		 */
-		TSharedPointer<T>& operator=(TSharedPointer<T>&& other) noexcept
+		TSharedPointer& operator=(TSharedPointer&& other) noexcept
 		{
 			if (this != &other)
 			{
 				// Liberar el objeto actual
-				if (refCount && --(*refCount) == 0)
-				{
-					delete ptr;
-					delete refCount;
-				}
+				releaseReference();
 				// Transferir los datos del otro puntero compartido
 				ptr = other.ptr;
-				refCount = other.refCount;
+				controlBlock = other.controlBlock;
 				other.ptr = nullptr;
-				other.refCount = nullptr;
+				other.controlBlock = nullptr;
 			}
 			return *this;
 		}
 
 		template<typename U>
-		TSharedPointer(const TSharedPointer<U>& other)
-			: ptr(other.ptr), refCount(other.refCount) {
-			if (refCount) ++(*refCount);
+		TSharedPointer(const TSharedPointer<U, Policy>& other)
+			: ptr(other.ptr), controlBlock(other.controlBlock) {
+			if (controlBlock) Policy::increment(controlBlock->strongCount);
 		}
 
 		/**
@@ -170,11 +388,7 @@ namespace EngineUtilities {
 		 */
 		~TSharedPointer()
 		{
-			if (refCount && --(*refCount) == 0)
-			{
-				delete ptr;
-				delete refCount;
-			}
+			releaseReference();
 		}
 
 		/**
@@ -211,8 +425,8 @@ namespace EngineUtilities {
 		bool isNull() const { return ptr == nullptr; }
 
 	public:
-		T* ptr;       ///< Puntero al objeto gestionado.
-		int* refCount; ///< Puntero al recuento de referencias.
+		T* ptr;                     ///< Puntero al objeto gestionado.
+		ControlBlock* controlBlock; ///< Bloque de control con el recuento de referencias.
 
 		/**
 		 * @brief Mtodo swap.
@@ -221,16 +435,16 @@ namespace EngineUtilities {
 		 *
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 */
-		void swap(TSharedPointer<T>& other) noexcept
+		void swap(TSharedPointer& other) noexcept
 		{
 			T* tempPtr = other.ptr;
-			int* tempRefCount = other.refCount;
+			ControlBlock* tempBlock = other.controlBlock;
 
 			other.ptr = this->ptr;
-			other.refCount = this->refCount;
+			other.controlBlock = this->controlBlock;
 
 			this->ptr = tempPtr;
-			this->refCount = tempRefCount;
+			this->controlBlock = tempBlock;
 		}
 
 		/**
@@ -241,55 +455,125 @@ namespace EngineUtilities {
 		void reset(T* newPtr = nullptr)
 		{
 			// Disminuir el recuento de referencias del objeto actual
-			if (refCount && --(*refCount) == 0)
-			{
-				delete ptr;
-				delete refCount;
-			}
+			releaseReference();
 
-			// Si newPtr es nullptr, asignar nullptr al puntero y recuento de referencias
+			// Si newPtr es nullptr, asignar nullptr al puntero y bloque de control
 			if (newPtr == nullptr)
 			{
 				ptr = nullptr;
-				refCount = nullptr;
+				controlBlock = nullptr;
 			}
 			else
 			{
-				// Asignar nuevo objeto y manejar el recuento de referencias
+				// Asignar nuevo objeto y su bloque de control
 				ptr = newPtr;
-				refCount = new int(1);
+				controlBlock = new TPointerControlBlock<T, Policy>(newPtr);
 			}
 		}
 
 		// Mtodo de conversin para hacer cast dinmico
 		template<typename U>
-		TSharedPointer<U> dynamic_pointer_cast() const {
+		TSharedPointer<U, Policy> dynamic_pointer_cast() const {
 			// Intenta convertir el puntero de tipo T a U
 			U* castedPtr = dynamic_cast<U*>(ptr);
 			if (castedPtr) {
 				// Si la conversin es exitosa, devuelve un nuevo TSharedPointer<U>
-				return TSharedPointer<U>(castedPtr, refCount);
+				return TSharedPointer<U, Policy>(castedPtr, controlBlock);
 			}
 			else {
 				// Si falla la conversin, devuelve un TSharedPointer<U> nulo
-				return TSharedPointer<U>();
+				return TSharedPointer<U, Policy>();
 			}
 		}
 
+	private:
+		/**
+		 * @brief Suelta la referencia actual, destruyendo el objeto y el bloque
+		 * de control si era la ltima.
+		 */
+		void releaseReference()
+		{
+			if (controlBlock)
+			{
+				ControlBlock::releaseStrong(controlBlock);
+			}
+		}
 	};
 
+	/**
+	 * @brief TSharedPointer que puede copiarse y destruirse desde varios hilos.
+	 */
+	template<typename T>
+	using TAtomicSharedPointer = TSharedPointer<T, AtomicRefCount>;
+
+	/**
+	 * @brief Crea un TSharedPointer con la poltica de recuento indicada.
+	 *
+	 * Reserva en una sola operacin el bloque de control y el objeto.
+	 *
+	 * @tparam T Tipo del objeto gestionado.
+	 * @tparam Policy Poltica de recuento de referencias.
+	 * @param args Argumentos reenviados al constructor de T.
+	 */
+	template<typename T, typename Policy, typename... Args>
+	TSharedPointer<T, Policy> MakeSharedWithPolicy(Args&&... args)
+	{
+		TInlineControlBlock<T, Policy>* block
+			= new TInlineControlBlock<T, Policy>(std::forward<Args>(args)...);
+
+		TSharedPointer<T, Policy> result;
+		result.ptr = block->get();
+		result.controlBlock = block;
+		return result;
+	}
+
 	/**
 	 * @brief Funcin de utilidad para crear un TSharedPointer.
 	 *
+	 * Reserva en una sola operacin el bloque de control y el objeto, y
+	 * reenva los argumentos al constructor de T sin copiarlos.
+	 *
 	 * @tparam T Tipo del objeto gestionado.
 	 * @tparam Args Tipos de los argumentos del constructor del objeto gestionado.
 	 * @param args Argumentos del constructor del objeto gestionado.
 	 * @return Un objeto TSharedPointer gestionando un nuevo objeto de tipo T.
 	 */
 	template<typename T, typename... Args>
-	TSharedPointer<T> MakeShared(Args... args)
+	TSharedPointer<T> MakeShared(Args&&... args)
+	{
+		return MakeSharedWithPolicy<T, SingleThreadRefCount>(std::forward<Args>(args)...);
+	}
+
+	/**
+	 * @brief Crea un TSharedPointer cuyo objeto y bloque de control viven en un pool.
+	 *
+	 * Igual que MakeShared, pero la nica reserva se toma de @p pool, as que
+	 * crear y destruir muchos objetos no toca el heap global.
+	 *
+	 * @param pool Pool del que se toma la memoria.
+	 * @param args Argumentos reenviados al constructor del objeto gestionado.
+	 * @return Un TSharedPointer gestionando un nuevo objeto de tipo T.
+	 */
+	template<typename T, typename Policy, typename... Args>
+	TSharedPointer<T, Policy> MakeShared(TSharedPool<T, Policy>& pool, Args&&... args)
+	{
+		TPooledControlBlock<T, Policy>* block = pool.create(&pool, std::forward<Args>(args)...);
+
+		TSharedPointer<T, Policy> result;
+		result.ptr = block->get();
+		result.controlBlock = block;
+		return result;
+	}
+
+	/**
+	 * @brief Igual que MakeShared, pero con recuento de referencias atmico.
+	 *
+	 * @return Un TAtomicSharedPointer gestionando un nuevo objeto de tipo T.
+	 */
+	template<typename T, typename... Args>
+	TAtomicSharedPointer<T> MakeAtomicShared(Args&&... args)
 	{
-		return TSharedPointer<T>(new T(args...));
+		return MakeSharedWithPolicy<T, AtomicRefCount>(std::forward<Args>(args)...);
 	}
 
 }
\ No newline at end of file
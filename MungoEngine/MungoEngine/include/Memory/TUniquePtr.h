@@ -27,17 +27,31 @@
  * SOFTWARE.
 */
 #pragma once
+#include <utility>
+#include "TPoolAllocator.h"
 
 namespace EngineUtilities {
+    /**
+     * @brief Deleter por defecto de TUniquePtr: libera el objeto con delete.
+     */
+    template<typename T>
+    struct TDefaultDelete
+    {
+        void operator()(T* object) const { delete object; }
+    };
+
     /**
    * @brief Clase TUniquePtr para manejo exclusivo de memoria.
    *
    * La clase TUniquePtr gestiona la memoria de un objeto de tipo T y garantiza
    * que solo una instancia de TUniquePtr puede poseer y gestionar el objeto en
    * cualquier momento.
+   *
+   * @tparam Deleter Forma de liberar el objeto. Por defecto delete; TPoolDeleter
+   * devuelve el objeto a un TPoolAllocator.
    */
-    template<typename T>
-    class TUniquePtr
+    template<typename T, typename Deleter = TDefaultDelete<T>>
+    class TUniquePtr : private Deleter
     {
     public:
         /**
@@ -54,6 +68,14 @@ namespace EngineUtilities {
          */
         explicit TUniquePtr(T* rawPtr) : ptr(rawPtr) {}
 
+        /**
+         * @brief Constructor que toma un puntero crudo y su deleter.
+         *
+         * @param rawPtr Puntero crudo al objeto que se va a gestionar.
+         * @param deleter Objeto que liberar rawPtr.
+         */
+        TUniquePtr(T* rawPtr, const Deleter& deleter) : Deleter(deleter), ptr(rawPtr) {}
+
         /**
          * @brief Constructor de movimiento.
          *
@@ -61,7 +83,8 @@ namespace EngineUtilities {
          *
          * @param other Otro objeto TUniquePtr del mismo tipo T.
          */
-        TUniquePtr(TUniquePtr<T>&& other) noexcept : ptr(other.ptr)
+        TUniquePtr(TUniquePtr&& other) noexcept
+            : Deleter(static_cast<const Deleter&>(other)), ptr(other.ptr)
         {
             other.ptr = nullptr;
         }
@@ -75,14 +98,15 @@ namespace EngineUtilities {
          * @param other Otro objeto TUniquePtr del mismo tipo T.
          * @return Referencia al objeto TUniquePtr actual.
          */
-        TUniquePtr<T>& operator=(TUniquePtr<T>&& other) noexcept
+        TUniquePtr& operator=(TUniquePtr&& other) noexcept
         {
             if (this != &other)
             {
                 // Liberar el objeto actual
-                delete ptr;
+                destroyObject();
 
                 // Transferir los datos del otro puntero exclusivo
+                static_cast<Deleter&>(*this) = static_cast<const Deleter&>(other);
                 ptr = other.ptr;
                 other.ptr = nullptr;
             }
@@ -96,12 +120,12 @@ namespace EngineUtilities {
          */
         ~TUniquePtr()
         {
-            delete ptr;
+            destroyObject();
         }
 
         // Prohibir la copia de TUniquePtr
-        TUniquePtr(const TUniquePtr<T>&) = delete;
-        TUniquePtr<T>& operator=(const TUniquePtr<T>&) = delete;
+        TUniquePtr(const TUniquePtr&) = delete;
+        TUniquePtr& operator=(const TUniquePtr&) = delete;
 
         template<typename U>
         TUniquePtr(TUniquePtr<U>&& other) noexcept
@@ -153,7 +177,7 @@ namespace EngineUtilities {
          */
         void reset(T* rawPtr = nullptr)
         {
-            delete ptr;
+            destroyObject();
             ptr = rawPtr;
         }
 
@@ -167,6 +191,17 @@ namespace EngineUtilities {
             return ptr == nullptr;
         }
     private:
+        /**
+         * @brief Libera el objeto gestionado con el deleter.
+         */
+        void destroyObject()
+        {
+            if (ptr != nullptr)
+            {
+                static_cast<Deleter&>(*this)(ptr);
+            }
+        }
+
         T* ptr; ///< Puntero al objeto gestionado.
     };
 
@@ -184,6 +219,22 @@ namespace EngineUtilities {
         return TUniquePtr<T>(new T(args...));
     }
 
+    /**
+     * @brief Crea un TUniquePtr cuyo objeto vive en un TPoolAllocator.
+     *
+     * Al destruirse el TUniquePtr el bloque vuelve al pool en lugar de al heap.
+     *
+     * @param pool Pool del que se toma la memoria.
+     * @param args Argumentos reenviados al constructor del objeto gestionado.
+     * @return Un TUniquePtr con TPoolDeleter gestionando el nuevo objeto.
+     */
+    template<typename T, typename... Args>
+    TUniquePtr<T, TPoolDeleter<T>> MakeUnique(TPoolAllocator<T>& pool, Args&&... args)
+    {
+        return TUniquePtr<T, TPoolDeleter<T>>(
+            pool.create(std::forward<Args>(args)...), TPoolDeleter<T>(&pool));
+    }
+
 
 
     /*
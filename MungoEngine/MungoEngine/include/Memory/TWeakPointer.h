@@ -35,24 +35,123 @@ namespace EngineUtilities {
 		 *
 		 * La clase TWeakPointer proporciona una manera de observar un objeto gestionado por un TSharedPointer
 		 * sin tener influencia sobre el recuento de referencias del objeto. Permite acceder al objeto solo si
-		 * an existe.
+		 * an existe. Mantiene vivo el bloque de control (recuento dbil), por lo que lock() y expired()
+		 * son seguros aunque el objeto ya se haya destruido.
 		 */
-	template<typename T>
+	template<typename T, typename Policy = SingleThreadRefCount>
 	class TWeakPointer
 	{
 	public:
+		using ControlBlock = TControlBlock<Policy>;
+
 		/**
 		 * @brief Constructor por defecto.
 		 */
-		TWeakPointer() : ptr(nullptr), refCount(nullptr) {}
+		TWeakPointer() : ptr(nullptr), controlBlock(nullptr) {}
 
 		/**
 		 * @brief Constructor que toma un TSharedPointer.
 		 *
 		 * @param sharedPtr TSharedPointer desde el cual se observar el objeto.
 		 */
-		TWeakPointer(const TSharedPointer<T>& sharedPtr)
-			: ptr(sharedPtr.ptr), refCount(sharedPtr.refCount) {
+		TWeakPointer(const TSharedPointer<T, Policy>& sharedPtr)
+			: ptr(sharedPtr.ptr), controlBlock(sharedPtr.controlBlock) {
+			if (controlBlock)
+			{
+				Policy::increment(controlBlock->weakCount);
+			}
+		}
+
+		/**
+		 * @brief Constructor de copia.
+		 *
+		 * @param other Otro TWeakPointer que observa el mismo objeto.
+		 */
+		TWeakPointer(const TWeakPointer& other)
+			: ptr(other.ptr), controlBlock(other.controlBlock) {
+			if (controlBlock)
+			{
+				Policy::increment(controlBlock->weakCount);
+			}
+		}
+
+		/**
+		 * @brief Constructor de movimiento.
+		 *
+		 * @param other Otro TWeakPointer; queda vaco.
+		 */
+		TWeakPointer(TWeakPointer&& other) noexcept
+			: ptr(other.ptr), controlBlock(other.controlBlock) {
+			other.ptr = nullptr;
+			other.controlBlock = nullptr;
+		}
+
+		/**
+		 * @brief Operador de asignacin de copia.
+		 */
+		TWeakPointer& operator=(const TWeakPointer& other)
+		{
+			if (this != &other)
+			{
+				if (other.controlBlock)
+				{
+					Policy::increment(other.controlBlock->weakCount);
+				}
+				reset();
+				ptr = other.ptr;
+				controlBlock = other.controlBlock;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Operador de asignacin de movimiento.
+		 */
+		TWeakPointer& operator=(TWeakPointer&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				ptr = other.ptr;
+				controlBlock = other.controlBlock;
+				other.ptr = nullptr;
+				other.controlBlock = nullptr;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Destructor.
+		 *
+		 * Suelta la referencia dbil; el bloque de control se libera cuando ya
+		 * no quedan referencias fuertes ni dbiles.
+		 */
+		~TWeakPointer()
+		{
+			reset();
+		}
+
+		/**
+		 * @brief Deja de observar el objeto.
+		 */
+		void reset()
+		{
+			if (controlBlock)
+			{
+				ControlBlock::releaseWeak(controlBlock);
+			}
+			ptr = nullptr;
+			controlBlock = nullptr;
+		}
+
+		/**
+		 * @brief Comprobar si el objeto observado ya fue destruido.
+		 *
+		 * @return true si no queda ningn TSharedPointer que posea el objeto.
+		 */
+		bool expired() const
+		{
+			return controlBlock == nullptr || Policy::load(controlBlock->strongCount) == 0;
 		}
 
 		/**
@@ -60,24 +159,33 @@ namespace EngineUtilities {
 		 *
 		 * @return Un TSharedPointer al objeto gestionado, o nullptr si el objeto ha sido destruido.
 		 */
-		TSharedPointer<T> lock() const
+		TSharedPointer<T, Policy> lock() const
 		{
-			if (refCount && *refCount > 0)
+			TSharedPointer<T, Policy> result;
+			// Solo se toma la referencia si el objeto sigue vivo
+			if (controlBlock && Policy::incrementIfNotZero(controlBlock->strongCount))
 			{
-				return TSharedPointer<T>(ptr, refCount);
+				result.ptr = ptr;
+				result.controlBlock = controlBlock;
 			}
-			return TSharedPointer<T>();
+			return result;
 		}
 
 		// Hacer que TSharedPointer sea un amigo para acceder a los miembros privados.
-		template<typename U>
+		template<typename U, typename P>
 		friend class TSharedPointer;
 
 	private:
 		T* ptr;       ///< Puntero al objeto observado.
-		int* refCount; ///< Puntero al recuento de referencias del TSharedPointer original.
+		ControlBlock* controlBlock; ///< Bloque de control del TSharedPointer original.
 	};
 
+	/**
+	 * @brief TWeakPointer que observa un TAtomicSharedPointer.
+	 */
+	template<typename T>
+	using TAtomicWeakPointer = TWeakPointer<T, AtomicRefCount>;
+
 	/*
 	#include "TSharedPointer.h"
 #include "TWeakPointer.h"
@@ -0,0 +1,90 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @class NavMesh
+ * @brief Walkable area made of convex polygons that share edges.
+ *
+ * A few large polygons cover open space that a grid needs thousands of
+ * cells for, so searches over them visit far fewer nodes. The
+ * PathfindingService runs A* over the polygons and straightens the result
+ * through the shared edges (portals) with the funnel algorithm.
+ *
+ * Add the polygons, then call build() to link the neighbours. Polygons are
+ * linked when they share an edge with the same two end points.
+ */
+class
+	NavMesh {
+public:
+	/**
+	 * @brief Edge of a polygon and what lies behind it.
+	 */
+	struct
+		Edge {
+		int neighbor = -1;  ///< Polygon on the other side, -1 if it is a wall.
+		sf::Vector2f left;  ///< Portal end on the left when leaving through the edge.
+		sf::Vector2f right; ///< Portal end on the right when leaving through the edge.
+	};
+
+	/**
+	 * @brief Adds a convex polygon, in either winding order.
+	 * @return Index of the polygon.
+	 */
+	size_t
+		addPolygon(const std::vector<sf::Vector2f>& points);
+
+	/**
+	 * @brief Links the polygons that share an edge.
+	 */
+	void
+		build();
+
+	/**
+	 * @brief Removes every polygon.
+	 */
+	void
+		clear();
+
+	size_t
+		getPolygonCount() const { return m_polygons.size(); }
+
+	/**
+	 * @brief Finds the polygon containing a point.
+	 * @return Polygon index, -1 if the point is outside the mesh.
+	 */
+	int
+		findPolygon(const sf::Vector2f& point) const;
+
+	/**
+	 * @brief Centroid of a polygon, used for the A* costs.
+	 */
+	const sf::Vector2f&
+		getCenter(size_t polygon) const { return m_polygons[polygon].center; }
+
+	/**
+	 * @brief Edges of a polygon, in order.
+	 */
+	const std::vector<Edge>&
+		getEdges(size_t polygon) const { return m_polygons[polygon].edges; }
+
+	/**
+	 * @brief Changes every time the mesh changes.
+	 */
+	uint32_t
+		getVersion() const { return m_version; }
+
+private:
+	/**
+	 * @brief One convex polygon.
+	 */
+	struct
+		Polygon {
+		std::vector<sf::Vector2f> points; ///< Counter-clockwise (in x right, y up terms).
+		std::vector<Edge> edges;          ///< Edge i goes from point i to point i + 1.
+		sf::Vector2f center;
+		sf::FloatRect bounds;
+	};
+
+	std::vector<Polygon> m_polygons;
+	uint32_t m_version = 0;
+};
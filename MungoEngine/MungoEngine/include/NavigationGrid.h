@@ -0,0 +1,98 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @class NavigationGrid
+ * @brief Walkable/blocked map of square cells for grid pathfinding.
+ *
+ * One byte per cell, row by row, so the searches of the
+ * PathfindingService read neighbouring cells from the same cache lines.
+ * Cells outside the grid count as blocked.
+ *
+ * Every change bumps a version number, which clears the path cache of the
+ * services using the grid. Change the grid only while no search is running
+ * (see PathfindingService::flush()).
+ */
+class
+	NavigationGrid {
+public:
+	/**
+	 * @brief Constructor. Every cell starts walkable.
+	 * @param width Number of columns.
+	 * @param height Number of rows.
+	 * @param cellSize Side of a cell in world units.
+	 * @param origin World position of the top-left corner of cell (0, 0).
+	 */
+	NavigationGrid(int width = 0, int height = 0, float cellSize = 32.f,
+		const sf::Vector2f& origin = sf::Vector2f(0.f, 0.f));
+
+	/**
+	 * @brief Changes the size of the grid; every cell becomes walkable.
+	 */
+	void
+		resize(int width, int height, float cellSize,
+			const sf::Vector2f& origin = sf::Vector2f(0.f, 0.f));
+
+	int
+		getWidth() const { return m_width; }
+
+	int
+		getHeight() const { return m_height; }
+
+	float
+		getCellSize() const { return m_cellSize; }
+
+	/**
+	 * @brief Number of cells (width * height).
+	 */
+	size_t
+		getCellCount() const { return m_walkable.size(); }
+
+	/**
+	 * @brief Checks a cell; cells outside the grid are blocked.
+	 */
+	bool
+		isWalkable(int x, int y) const {
+		return x >= 0 && y >= 0 && x < m_width && y < m_height &&
+			m_walkable[static_cast<size_t>(y) * m_width + x] != 0;
+	}
+
+	/**
+	 * @brief Marks a cell as walkable or blocked (ignored outside the grid).
+	 */
+	void
+		setWalkable(int x, int y, bool walkable);
+
+	/**
+	 * @brief Marks every cell touching a world rectangle (e.g. the global
+	 * bounds of an obstacle shape).
+	 */
+	void
+		setWalkable(const sf::FloatRect& area, bool walkable);
+
+	/**
+	 * @brief Cell containing a world position (may be outside the grid).
+	 */
+	sf::Vector2i
+		worldToCell(const sf::Vector2f& position) const;
+
+	/**
+	 * @brief World position of the center of a cell.
+	 */
+	sf::Vector2f
+		cellToWorld(const sf::Vector2i& cell) const;
+
+	/**
+	 * @brief Changes every time a cell changes.
+	 */
+	uint32_t
+		getVersion() const { return m_version; }
+
+private:
+	int m_width = 0;
+	int m_height = 0;
+	float m_cellSize;
+	sf::Vector2f m_origin;
+	std::vector<uint8_t> m_walkable; ///< 1 if walkable, row by row.
+	uint32_t m_version = 0;
+};
@@ -0,0 +1,268 @@
+#pragma once
+#include "Prerequisites.h"
+#include "JobSystem.h"
+#include "NavigationGrid.h"
+#include "NavMesh.h"
+#include "ESC/World.h"
+#include <list>
+
+/**
+ * @enum PathAlgorithm
+ * @brief Search used for a path request.
+ */
+enum
+	PathAlgorithm {
+	PATH_ASTAR = 0,      ///< A* over the grid cells (8 directions).
+	PATH_JUMP_POINT = 1, ///< Jump point search over the grid: same paths, far fewer nodes.
+	PATH_NAVMESH = 2     ///< A* over the NavMesh polygons, straightened by the funnel.
+};
+
+/**
+ * @class PathfindingService
+ * @brief Finds paths on a NavigationGrid or a NavMesh for many agents.
+ *
+ * Agents call requestPath(); update() then runs the pending requests as a
+ * batch of background jobs on the worker threads while the frame goes on
+ * (see JobSystem::scheduleBackground()), and on a later step hands each
+ * resulting waypoint list to the PathFollower of its entity. Requests never
+ * block the caller, and the step's own waits never run a search.
+ *
+ * Grid moves go in 8 directions without cutting blocked corners. Each
+ * search runs on a pooled context whose node arrays and open list (a
+ * binary heap) are reused: stamping the nodes with a search number means
+ * nothing is cleared between searches. Grid paths are cached by start and
+ * goal cell (least recently used ones are dropped), and the cache is
+ * emptied whenever the grid changes.
+ */
+class
+	PathfindingService {
+public:
+	/**
+	 * @brief Counters since construction (or the last resetStats()).
+	 */
+	struct
+		Stats {
+		uint64_t requests = 0;      ///< Paths asked for (sync and async).
+		uint64_t cacheHits = 0;     ///< Requests answered by the cache.
+		uint64_t searches = 0;      ///< Searches run.
+		uint64_t failures = 0;      ///< Requests without a path.
+		uint64_t expandedNodes = 0; ///< Nodes taken from the open lists.
+	};
+
+	/**
+	 * @brief Constructor.
+	 * @param jobs Worker threads that run the batched searches.
+	 */
+	explicit
+		PathfindingService(JobSystem& jobs);
+
+	/**
+	 * @brief Waits for the searches still running.
+	 */
+	~PathfindingService();
+
+	PathfindingService(const PathfindingService&) = delete;
+	PathfindingService& operator=(const PathfindingService&) = delete;
+
+	/**
+	 * @brief Grid used by PATH_ASTAR and PATH_JUMP_POINT (must outlive the service).
+	 */
+	void
+		setGrid(const NavigationGrid* grid);
+
+	/**
+	 * @brief Mesh used by PATH_NAVMESH (must outlive the service).
+	 */
+	void
+		setNavMesh(const NavMesh* navMesh);
+
+	/**
+	 * @brief Finds a path now, on the calling thread.
+	 * @param start Start position in world units.
+	 * @param goal Goal position in world units.
+	 * @param path Receives the waypoints after the start, ending at @p goal.
+	 * @param algorithm Search to use.
+	 * @return False if there is no path.
+	 */
+	bool
+		findPath(const sf::Vector2f& start, const sf::Vector2f& goal,
+			std::vector<sf::Vector2f>& path, PathAlgorithm algorithm = PATH_JUMP_POINT);
+
+	/**
+	 * @brief Queues a path for the PathFollower of an entity.
+	 *
+	 * A newer request of the same entity replaces one not started yet.
+	 */
+	void
+		requestPath(EntityID entity, const sf::Vector2f& start, const sf::Vector2f& goal,
+			PathAlgorithm algorithm = PATH_JUMP_POINT);
+
+	/**
+	 * @brief Delivers the finished batch and starts the next one.
+	 *
+	 * Call once per step from the thread that owns the world.
+	 */
+	void
+		update(World& world);
+
+	/**
+	 * @brief Waits for the running batch and delivers it. Call before
+	 * changing the grid or the mesh.
+	 */
+	void
+		flush(World& world);
+
+	/**
+	 * @brief Maximum number of requests searched per batch (default 256).
+	 */
+	void
+		setMaxBatchSize(size_t maxBatchSize) { m_maxBatchSize = maxBatchSize > 0 ? maxBatchSize : 1; }
+
+	/**
+	 * @brief Maximum number of cached grid paths (default 1024, 0 = no cache).
+	 */
+	void
+		setCacheCapacity(size_t capacity);
+
+	/**
+	 * @brief Requests waiting or being searched.
+	 */
+	size_t
+		getPendingCount() const { return m_pending.size() + m_batch.size(); }
+
+	const Stats&
+		getStats() const { return m_stats; }
+
+	void
+		resetStats() { m_stats = Stats(); }
+
+private:
+	/**
+	 * @brief One path request and, once searched, its result.
+	 */
+	struct
+		Request {
+		EntityID entity = INVALID_ENTITY;
+		sf::Vector2f start;
+		sf::Vector2f goal;
+		PathAlgorithm algorithm = PATH_JUMP_POINT;
+		std::vector<sf::Vector2f> path;
+		bool searched = false; ///< False if answered by the cache.
+		bool found = false;
+		uint64_t expandedNodes = 0;
+	};
+
+	/**
+	 * @brief Open list entry.
+	 */
+	struct
+		OpenNode {
+		float cost;     ///< Cost so far plus heuristic.
+		uint32_t node;
+
+		bool operator>(const OpenNode& other) const { return cost > other.cost; }
+	};
+
+	/**
+	 * @brief Scratch memory of one search, reused by the next ones.
+	 */
+	struct
+		SearchContext {
+		std::vector<float> cost;        ///< Best cost found to each node.
+		std::vector<uint32_t> parent;   ///< Node it was reached from.
+		std::vector<uint32_t> stamp;    ///< Search that last touched each node.
+		std::vector<uint8_t> closed;    ///< Node expanded (valid if stamped).
+		std::vector<OpenNode> open;     ///< Binary heap.
+		uint32_t search = 0;            ///< Number of the current search.
+	};
+
+	/**
+	 * @brief Cached grid path.
+	 */
+	struct
+		CacheEntry {
+		std::vector<sf::Vector2f> path; ///< Cell centers after the start cell.
+		std::list<uint64_t>::iterator lruPosition;
+	};
+
+	/**
+	 * @brief Runs one request (any thread).
+	 */
+	void
+		search(Request& request);
+
+	bool
+		searchGrid(const sf::Vector2i& start, const sf::Vector2i& goal, bool jumpPoints,
+			SearchContext& context, std::vector<sf::Vector2f>& path, uint64_t& expanded) const;
+
+	bool
+		searchNavMesh(const sf::Vector2f& start, const sf::Vector2f& goal,
+			SearchContext& context, std::vector<sf::Vector2f>& path, uint64_t& expanded) const;
+
+	/**
+	 * @brief Jump point search: follows a direction until a jump point.
+	 * @return Cell index of the jump point, UINT32_MAX if there is none.
+	 */
+	uint32_t
+		jump(int x, int y, int dx, int dy, const sf::Vector2i& goal) const;
+
+	/**
+	 * @brief Prepares a context for a search over @p nodeCount nodes.
+	 */
+	static void
+		beginSearch(SearchContext& context, size_t nodeCount);
+
+	SearchContext*
+		acquireContext();
+
+	void
+		releaseContext(SearchContext* context);
+
+	/**
+	 * @brief Key of a grid request in the cache, 0 if it cannot be cached.
+	 */
+	uint64_t
+		getCacheKey(const Request& request) const;
+
+	/**
+	 * @brief Looks for a cached path and fills the request with it.
+	 */
+	bool
+		readCache(Request& request);
+
+	void
+		writeCache(const Request& request);
+
+	/**
+	 * @brief Empties the cache if the grid changed since it was filled.
+	 */
+	void
+		validateCache();
+
+	/**
+	 * @brief Gives a finished request to the PathFollower of its entity.
+	 */
+	void
+		deliver(World& world, Request& request);
+
+	JobSystem& m_jobs;
+	const NavigationGrid* m_grid = nullptr;
+	const NavMesh* m_navMesh = nullptr;
+
+	std::vector<Request> m_pending;                    ///< Not started yet.
+	std::unordered_map<EntityID, size_t> m_pendingIndex; ///< Entity -> index in m_pending.
+	std::vector<Request> m_batch;                      ///< Being searched by the workers.
+	JobCounter m_batchJobs;
+	size_t m_maxBatchSize = 256;
+
+	std::mutex m_contextMutex;                         ///< Guards m_freeContexts.
+	std::vector<std::unique_ptr<SearchContext>> m_contexts;
+	std::vector<SearchContext*> m_freeContexts;
+
+	std::unordered_map<uint64_t, CacheEntry> m_cache;
+	std::list<uint64_t> m_cacheOrder;                  ///< Most recently used first.
+	size_t m_cacheCapacity = 1024;
+	uint32_t m_cacheGridVersion = 0;
+
+	Stats m_stats;
+};
@@ -22,6 +22,10 @@
 #include "Memory/TWeakPointer.h"    ///< Custom weak pointer implementation.
 #include "Memory/TStaticPtr.h"      ///< Custom static pointer implementation.
 #include "Memory/TUniquePtr.h"      ///< Custom unique pointer implementation.
+#include "Memory/TPoolAllocator.h"  ///< Fixed-size pool allocator.
+#include "Memory/FrameArena.h"      ///< Per-frame linear allocator.
+#include "Profiler.h"               ///< Frame profiler used by PROFILE_SCOPE.
+#include "Logger.h"                 ///< Asynchronous logger used by the LOG_* macros.
 
 // ========================
 // Macros
@@ -39,9 +43,69 @@
 	if (x != nullptr) { delete x; x = nullptr; }
 
  /**
+	* @brief Lowest level compiled in; LOG_* calls below it generate no code.
+	*
+	* 0 = debug, 1 = info, 2 = warning, 3 = error. Debug messages are only
+	* kept in builds without NDEBUG unless the project defines it.
+	*/
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL 1
+#else
+#define LOG_COMPILE_LEVEL 0
+#endif
+#endif
+
+	/**
+	 * @brief Queues a message for the logger thread.
+	 *
+	 * The arguments are copied into the log ring buffer and formatted later,
+	 * so the caller never waits on the console or a file.
+	 *
+	 * @param level LogLevel of the message.
+	 * @param classObj The name of the class.
+	 * @param method The method where the message is generated.
+	 * @param msg Message; values can be chained with <<.
+	 *
+	 * Example usage:
+	 * @code
+	 * LOG_WARNING("MyClass", "update", "Slow step: " << milliseconds << " ms");
+	 * @endcode
+	 */
+#define LOG_WRITE(level, classObj, method, msg)                             \
+{                                                                           \
+	if (Logger::getInstance().isEnabled(level)) {                           \
+		LogWriter log_(level);                                              \
+		log_ << classObj << LogField() << method << LogField() << msg;      \
+	}                                                                       \
+}
+
+#if LOG_COMPILE_LEVEL <= 0
+#define LOG_DEBUG(classObj, method, msg) LOG_WRITE(LOG_LEVEL_DEBUG, classObj, method, msg)
+#else
+#define LOG_DEBUG(classObj, method, msg) {}
+#endif
+
+#if LOG_COMPILE_LEVEL <= 1
+#define LOG_INFO(classObj, method, msg) LOG_WRITE(LOG_LEVEL_INFO, classObj, method, msg)
+#else
+#define LOG_INFO(classObj, method, msg) {}
+#endif
+
+#if LOG_COMPILE_LEVEL <= 2
+#define LOG_WARNING(classObj, method, msg) LOG_WRITE(LOG_LEVEL_WARNING, classObj, method, msg)
+#else
+#define LOG_WARNING(classObj, method, msg) {}
+#endif
+
+#define LOG_ERROR(classObj, method, msg) LOG_WRITE(LOG_LEVEL_ERROR, classObj, method, msg)
+
+	/**
 	* @brief Outputs a formatted message indicating the state of a
 	* resource creation.
 	*
+	* Logged at info level through the asynchronous logger.
+	*
 	* @param classObj The name of the class.
 	* @param method The method where the message is generated.
 	* @param state The current state or detail of the resource creation.
@@ -52,16 +116,14 @@
 	* @endcode
 	*/
 #define MESSAGE(classObj, method, state)                        \
-{                                                               \
-	std::ostringstream os_;                                     \
-	os_ << classObj << "::" << method << " : "                  \
-		<< "[CREATION OF RESOURCE" << ": " << state << "] \n";  \
-	std::cerr << os_.str();                                     \
-}
+	LOG_INFO(classObj, method, "[CREATION OF RESOURCE: " << state << "]")
 
 	/**
 	 * @brief Outputs a formatted error message and exits the application.
 	 *
+	 * The message is logged at error level and the logger is flushed before
+	 * exiting, so it is never lost.
+	 *
 	 * @param classObj The name of the class.
 	 * @param method The method where the error occurred.
 	 * @param errorMSG A description of the error.
@@ -71,15 +133,40 @@
 	 * ERROR("MyClass", "loadFile", "File not found");
 	 * @endcode
 	 */
-#define ERROR(classObj, method, errorMSG)                          \
-{                                                                  \
-	std::ostringstream os_;                                        \
-	os_ << "ERROR : " << classObj << "::" << method << " : "       \
-		<< "  Error in data from params [" << errorMSG << "] \n";  \
-	std::cerr << os_.str();                                        \
-	exit(1);                                                       \
+#define ERROR(classObj, method, errorMSG)                                   \
+{                                                                           \
+	LOG_ERROR(classObj, method, "Error in data from params [" << errorMSG << "]"); \
+	Logger::getInstance().flush();                                          \
+	exit(1);                                                                \
 }
 
+	/**
+	 * @brief Times the enclosing scope as a profiler zone.
+	 *
+	 * @param name Zone name (a string literal).
+	 *
+	 * Compiled out when PROFILER_ENABLED is defined as 0.
+	 *
+	 * Example usage:
+	 * @code
+	 * void MyClass::update() {
+	 *     PROFILE_SCOPE("MyClass::update");
+	 * }
+	 * @endcode
+	 */
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
 	 // ========================
 	 // Enums
 	 // ========================
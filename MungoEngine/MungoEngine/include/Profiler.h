@@ -0,0 +1,194 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class Profiler
+ * @brief Collects timed zones from every thread for frame profiling.
+ *
+ * Zones are usually recorded with the PROFILE_SCOPE macro. Each thread
+ * writes its zones into its own ring buffer, without locks: recording a
+ * zone is two clock reads and a few stores. The main thread reads the
+ * buffers once per frame in endFrame() to keep a rolling min/avg/p99 per
+ * zone name, and writeChromeTrace() dumps the zones still in the buffers as
+ * a Chrome trace (about://tracing or ui.perfetto.dev).
+ */
+class
+	Profiler {
+public:
+	/**
+	 * @brief Timing statistics of one zone name over the rolling window.
+	 */
+	struct
+		ZoneSummary {
+		std::string name; ///< Zone name.
+		uint64_t count;   ///< Zones recorded since the start.
+		double minMs;     ///< Shortest zone in the window, in milliseconds.
+		double avgMs;     ///< Average duration in the window, in milliseconds.
+		double p99Ms;     ///< 99th percentile duration in the window, in milliseconds.
+	};
+
+	/**
+	 * @brief Profiler shared by the whole engine.
+	 */
+	static Profiler&
+		getInstance();
+
+	/**
+	 * @brief Current time on the profiler clock, in nanoseconds.
+	 */
+	static int64_t
+		now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	 * @brief Turns recording on or off at run time (on by default).
+	 */
+	void
+		setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+	bool
+		isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Stores a finished zone in the ring buffer of the calling thread.
+	 * @param name Zone name; must stay valid (a string literal).
+	 * @param start Start time from now().
+	 * @param end End time from now().
+	 */
+	void
+		record(const char* name, int64_t start, int64_t end);
+
+	/**
+	 * @brief Adds the zones recorded since the last call to the statistics.
+	 *
+	 * Call once per frame from the main thread.
+	 */
+	void
+		endFrame();
+
+	/**
+	 * @brief Statistics of every zone name, sorted by name.
+	 */
+	std::vector<ZoneSummary>
+		getSummary() const;
+
+	/**
+	 * @brief Logs getSummary() as a table, one line per zone.
+	 */
+	void
+		printSummary() const;
+
+	/**
+	 * @brief Writes the zones still in the ring buffers as Chrome trace JSON.
+	 * @param path Output file.
+	 * @return False if the file could not be written.
+	 */
+	bool
+		writeChromeTrace(const std::string& path) const;
+
+private:
+	Profiler();
+
+	/**
+	 * @brief Recorded zone. The fields are atomic because the main thread
+	 * may read a slot while its owner overwrites it.
+	 */
+	struct
+		Event {
+		std::atomic<const char*> name{ nullptr };
+		std::atomic<int64_t> start{ 0 };
+		std::atomic<int64_t> end{ 0 };
+	};
+
+	/**
+	 * @brief Plain copy of an Event taken by the reader.
+	 */
+	struct
+		Sample {
+		const char* name;
+		int64_t start;
+		int64_t end;
+	};
+
+	/**
+	 * @brief Ring buffer written only by its thread.
+	 *
+	 * reserved is advanced before a slot is written and committed after,
+	 * so a reader can tell whether a slot it read was being overwritten.
+	 */
+	struct
+		ThreadBuffer {
+		uint32_t threadIndex;
+		std::unique_ptr<Event[]> events;
+		std::atomic<uint64_t> reserved{ 0 };
+		std::atomic<uint64_t> committed{ 0 };
+		uint64_t statsRead = 0; ///< First event not yet added to the statistics.
+	};
+
+	/**
+	 * @brief Rolling window of the last durations of a zone name.
+	 */
+	struct
+		ZoneStats {
+		std::vector<float> samples; ///< Durations in milliseconds (ring).
+		size_t next = 0;
+		uint64_t count = 0;
+	};
+
+	/**
+	 * @brief Creates the ring buffer of the calling thread.
+	 */
+	ThreadBuffer*
+		registerThread();
+
+	/**
+	 * @brief Copies the events of [first, committed) that were not overwritten.
+	 * @return Index after the last event copied.
+	 */
+	uint64_t
+		readEvents(const ThreadBuffer& buffer, uint64_t first,
+			std::vector<Sample>& out) const;
+
+	std::atomic<bool> m_enabled{ true };
+	int64_t m_epoch;                   ///< now() at startup; trace times are relative to it.
+
+	mutable std::mutex m_mutex;        ///< Guards the buffer list and the statistics.
+	std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+	std::map<std::string, ZoneStats> m_stats;
+	std::map<const char*, ZoneStats*> m_statsByPointer; ///< Avoids building strings per event.
+};
+
+/**
+ * @class ProfileZone
+ * @brief Records the lifetime of a scope as a profiler zone.
+ */
+class
+	ProfileZone {
+public:
+	explicit
+		ProfileZone(const char* name)
+		: m_name(Profiler::getInstance().isEnabled() ? name : nullptr),
+		m_start(m_name ? Profiler::now() : 0) {}
+
+	~ProfileZone() {
+		if (m_name) {
+			Profiler::getInstance().record(m_name, m_start, Profiler::now());
+		}
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	const char* m_name;
+	int64_t m_start;
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @class RenderBatcher
+ * @brief Collects shapes into triangle vertex arrays and draws each group
+ * with a single draw call.
+ *
+ * Shapes are converted to world-space triangles on the CPU when submitted.
+ * Consecutive shapes sharing the same texture, blend mode and shader are
+ * appended to the same sf::VertexArray, so draw order is preserved while a
+ * scene using one texture collapses into one draw call. Vertex storage is
+ * kept between frames to avoid reallocations.
+ */
+class
+	RenderBatcher {
+public:
+	/**
+	 * @brief Default constructor.
+	 */
+	RenderBatcher() = default;
+
+	/**
+	 * @brief Adds a shape (fill and outline) to the current frame.
+	 * @param shape Shape to draw; its transform, texture and colors are used.
+	 * @param states Extra render states (transform, blend mode, shader).
+	 */
+	void
+		submit(const sf::Shape& shape,
+			const sf::RenderStates& states = sf::RenderStates::Default);
+
+	/**
+	 * @brief Draws every pending batch to the target and empties the batcher.
+	 * @param target Render target receiving the draw calls.
+	 */
+	void
+		flush(sf::RenderTarget& target);
+
+	/**
+	 * @brief Discards pending batches without drawing them.
+	 */
+	void
+		clear();
+
+	/**
+	 * @brief Checks if there is anything waiting to be flushed.
+	 */
+	bool
+		isEmpty() const { return m_batchCount == 0; }
+
+	/**
+	 * @brief Number of draw calls issued since the last resetStats().
+	 */
+	unsigned int
+		getDrawCallCount() const { return m_drawCalls; }
+
+	/**
+	 * @brief Number of shapes submitted since the last resetStats().
+	 */
+	unsigned int
+		getShapeCount() const { return m_shapeCount; }
+
+	/**
+	 * @brief Number of texture changes between the draw calls issued since
+	 * the last resetStats(); each one makes the GPU bind another texture.
+	 */
+	unsigned int
+		getTextureBindCount() const { return m_textureBinds; }
+
+	/**
+	 * @brief Resets the draw call and shape counters (once per frame).
+	 */
+	void
+		resetStats();
+
+private:
+	/**
+	 * @brief Group of triangles drawn with the same render states.
+	 */
+	struct
+		Batch {
+		const sf::Texture* texture = nullptr;
+		const sf::Shader* shader = nullptr;
+		sf::BlendMode blendMode;
+		sf::VertexArray vertices{ sf::Triangles };
+	};
+
+	/**
+	 * @brief Returns the batch to append to, starting a new one if the states
+	 * differ from the last batch.
+	 */
+	Batch&
+		getBatch(const sf::Texture* texture, const sf::RenderStates& states);
+
+	std::vector<Batch> m_batches;    ///< Batch storage, reused every frame.
+	size_t m_batchCount = 0;         ///< Batches in use this frame.
+	std::vector<sf::Vector2f> m_points; ///< Scratch buffer for shape points.
+	unsigned int m_drawCalls = 0;    ///< Draw calls since resetStats().
+	unsigned int m_shapeCount = 0;   ///< Shapes since resetStats().
+	unsigned int m_textureBinds = 0; ///< Texture changes since resetStats().
+	const sf::Texture* m_boundTexture = nullptr; ///< Texture of the last draw call.
+};
@@ -0,0 +1,264 @@
+#pragma once
+#include "Prerequisites.h"
+#include "AssetArchive.h"
+#include <list>
+
+/**
+ * @class ResourceManager
+ * @brief Cache of file resources keyed by path that hands out shared handles.
+ *
+ * Each file is loaded once: later requests for the same path get the same
+ * object while anyone still uses it. The cache itself keeps a strong handle
+ * to the most recently used resources, up to a memory budget, so dropping
+ * the last user does not force a reload right away. Over budget, the least
+ * recently used resources lose that cache reference; only a weak reference
+ * stays, so their memory is freed as soon as their users let go of them,
+ * and a resource still in use is never loaded twice.
+ *
+ * Paths found in the mounted AssetArchive (see setArchive()) are read from
+ * it; the rest are loaded from loose files.
+ *
+ * @tparam T Resource type. Needs a default constructor,
+ * `bool loadFromFile(const std::string&)`,
+ * `bool loadFromMemory(const void*, size_t)` and `size_t getMemorySize() const`.
+ */
+template<typename T>
+class
+	ResourceManager {
+public:
+	using Handle = EngineUtilities::TSharedPointer<T>;
+
+	/**
+	 * @brief Cache counters since construction (or the last resetStats()).
+	 */
+	struct
+		Stats {
+		uint64_t hits = 0;        ///< Requests served without loading.
+		uint64_t misses = 0;      ///< Requests that loaded the file.
+		uint64_t failedLoads = 0; ///< Misses whose file could not be loaded.
+		uint64_t evictions = 0;   ///< Resources dropped from the cache by the budget.
+	};
+
+	/**
+	 * @brief Constructor.
+	 * @param budgetBytes Memory the cache may keep alive on its own.
+	 */
+	explicit
+		ResourceManager(size_t budgetBytes = 256 * 1024 * 1024)
+		: m_budget(budgetBytes) {}
+
+	ResourceManager(const ResourceManager&) = delete;
+	ResourceManager& operator=(const ResourceManager&) = delete;
+
+	/**
+	 * @brief Returns the resource of a file, loading it if nobody has it.
+	 * @param path File path, used as is as the cache key.
+	 * @return Shared handle, null if the file could not be loaded.
+	 */
+	Handle
+		load(const std::string& path) {
+		auto found = m_entries.find(path);
+		if (found != m_entries.end()) {
+			Entry& entry = found->second;
+			Handle resource = entry.cached ? entry.strong : entry.weak.lock();
+			if (!resource.isNull()) {
+				++m_stats.hits;
+				touch(found->first, entry, resource);
+				return resource;
+			}
+
+			// Evicted and released by every user: load it again
+			m_entries.erase(found);
+		}
+
+		++m_stats.misses;
+		Handle resource = EngineUtilities::MakeShared<T>();
+		if (resource.isNull() || !loadResource(path, *resource)) {
+			++m_stats.failedLoads;
+			LOG_WARNING("ResourceManager", "load", "Could not load " << path);
+			return Handle();
+		}
+		return insert(path, resource);
+	}
+
+	/**
+	 * @brief Adds a resource created elsewhere (e.g. loaded from memory)
+	 * under a path, replacing any previous one.
+	 * @return The handle now stored in the cache.
+	 */
+	Handle
+		insert(const std::string& path, const Handle& resource) {
+		auto found = m_entries.find(path);
+		if (found != m_entries.end()) {
+			uncache(found->second);
+			m_entries.erase(found);
+		}
+		if (resource.isNull()) {
+			return resource;
+		}
+
+		auto inserted = m_entries.emplace(path, Entry()).first;
+		Entry& entry = inserted->second;
+		entry.weak = resource;
+		entry.bytes = resource->getMemorySize();
+		touch(inserted->first, entry, resource);
+		return resource;
+	}
+
+	/**
+	 * @brief Reads resources from an archive before trying loose files.
+	 * @param archive Open archive that outlives the cache, or nullptr.
+	 */
+	void
+		setArchive(const AssetArchive* archive) { m_archive = archive; }
+
+	const AssetArchive*
+		getArchive() const { return m_archive; }
+
+	/**
+	 * @brief Checks whether a path has a live resource, without loading it.
+	 */
+	bool
+		contains(const std::string& path) const {
+		auto found = m_entries.find(path);
+		return found != m_entries.end() &&
+			(found->second.cached || !found->second.weak.expired());
+	}
+
+	/**
+	 * @brief Changes the budget and evicts down to it.
+	 */
+	void
+		setBudget(size_t budgetBytes) {
+		m_budget = budgetBytes;
+		enforceBudget(nullptr);
+	}
+
+	size_t
+		getBudget() const { return m_budget; }
+
+	/**
+	 * @brief Memory of the resources the cache keeps alive itself.
+	 */
+	size_t
+		getCachedBytes() const { return m_cachedBytes; }
+
+	/**
+	 * @brief Drops every cache reference; resources in use stay alive.
+	 */
+	void
+		clear() {
+		m_entries.clear();
+		m_lru.clear();
+		m_cachedBytes = 0;
+	}
+
+	const Stats&
+		getStats() const { return m_stats; }
+
+	void
+		resetStats() { m_stats = Stats(); }
+
+	/**
+	 * @brief Fraction of requests served without loading (0 if none yet).
+	 */
+	float
+		getHitRate() const {
+		const uint64_t total = m_stats.hits + m_stats.misses;
+		return total > 0 ? static_cast<float>(m_stats.hits) / total : 0.f;
+	}
+
+private:
+	/**
+	 * @brief Cache slot of one path.
+	 */
+	struct
+		Entry {
+		Handle strong;                     ///< Cache reference while within budget.
+		EngineUtilities::TWeakPointer<T> weak; ///< Finds the resource while anyone uses it.
+		size_t bytes = 0;                  ///< Memory used by the resource.
+		bool cached = false;               ///< strong is set and the entry is in m_lru.
+		typename std::list<const std::string*>::iterator lruPosition;
+	};
+
+	/**
+	 * @brief Loads a resource from the archive, or from its file if the
+	 * archive does not have it.
+	 */
+	bool
+		loadResource(const std::string& path, T& resource) const {
+		if (m_archive) {
+			AssetBlob blob = m_archive->find(path);
+			if (blob) {
+				return resource.loadFromMemory(blob.data, blob.size);
+			}
+		}
+		return resource.loadFromFile(path);
+	}
+
+	/**
+	 * @brief Marks an entry as the most recently used, caching it again if
+	 * the budget had evicted it.
+	 */
+	void
+		touch(const std::string& path, Entry& entry, const Handle& resource) {
+		if (entry.cached) {
+			m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+		}
+		else {
+			entry.strong = resource;
+			entry.cached = true;
+			m_lru.push_front(&path);
+			entry.lruPosition = m_lru.begin();
+			m_cachedBytes += entry.bytes;
+		}
+		enforceBudget(&entry);
+	}
+
+	/**
+	 * @brief Removes the cache reference of an entry.
+	 */
+	void
+		uncache(Entry& entry) {
+		if (!entry.cached) {
+			return;
+		}
+		m_lru.erase(entry.lruPosition);
+		entry.strong = Handle();
+		entry.cached = false;
+		m_cachedBytes -= entry.bytes;
+	}
+
+	/**
+	 * @brief Evicts least recently used entries until the budget is met.
+	 * @param keep Entry just requested, never evicted here.
+	 */
+	void
+		enforceBudget(const Entry* keep) {
+		auto position = m_lru.end();
+		while (m_cachedBytes > m_budget && position != m_lru.begin()) {
+			--position;
+			auto found = m_entries.find(**position);
+			Entry& entry = found->second;
+			if (&entry == keep) {
+				continue;
+			}
+
+			++position;
+			uncache(entry);
+			++m_stats.evictions;
+
+			// Nobody else holds it: the memory is gone, forget the path
+			if (entry.weak.expired()) {
+				m_entries.erase(found);
+			}
+		}
+	}
+
+	std::unordered_map<std::string, Entry> m_entries;
+	std::list<const std::string*> m_lru; ///< Cached paths, most recent first.
+	size_t m_budget;
+	size_t m_cachedBytes = 0;
+	Stats m_stats;
+	const AssetArchive* m_archive = nullptr; ///< Searched before the file system.
+};
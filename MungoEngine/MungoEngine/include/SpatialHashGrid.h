@@ -0,0 +1,158 @@
+#pragma once
+#include "Prerequisites.h"
+#include "ESC/World.h"
+#include <cmath>
+
+/**
+ * @class SpatialHashGrid
+ * @brief Uniform grid over 2D points for proximity queries.
+ *
+ * Space is divided in square cells of a fixed size and every cell is hashed
+ * into a bucket table. Points are inserted between clear() and build();
+ * build() sorts them by bucket with a counting sort, so a rebuild is O(n)
+ * and each bucket ends up contiguous in memory. Queries only look at the
+ * cells overlapping the query shape, so they cost O(k) for k nearby points
+ * instead of O(n).
+ *
+ * Entries keep their cell coordinates, which discards hash collisions and
+ * never reports a point twice.
+ */
+class
+	SpatialHashGrid {
+public:
+	/**
+	 * @brief Constructor.
+	 * @param cellSize Side of a cell in world units (about the usual query radius).
+	 * @param bucketCount Number of hash buckets (rounded up to a power of two).
+	 */
+	explicit
+		SpatialHashGrid(float cellSize = 64.f, size_t bucketCount = 4096);
+
+	/**
+	 * @brief Removes every point.
+	 */
+	void
+		clear();
+
+	/**
+	 * @brief Adds a point; it becomes visible to queries after build().
+	 * @param entity Entity the point belongs to.
+	 * @param position World position.
+	 */
+	void
+		insert(EntityID entity, const sf::Vector2f& position);
+
+	/**
+	 * @brief Sorts the inserted points into their buckets.
+	 */
+	void
+		build();
+
+	/**
+	 * @brief Clears the grid and fills it with the Transform position of
+	 * every entity in the world.
+	 * @param world World to read the transforms from.
+	 */
+	void
+		rebuild(World& world);
+
+	/**
+	 * @brief Finds the points inside a circle.
+	 * @param center Circle center.
+	 * @param radius Circle radius.
+	 * @param out Receives the entities found (appended, unordered).
+	 */
+	void
+		queryRadius(const sf::Vector2f& center, float radius, std::vector<EntityID>& out) const;
+
+	/**
+	 * @brief Finds the points inside an axis-aligned rectangle.
+	 * @param area Rectangle in world coordinates.
+	 * @param out Receives the entities found (appended, unordered).
+	 */
+	void
+		queryAABB(const sf::FloatRect& area, std::vector<EntityID>& out) const;
+
+	/**
+	 * @brief Finds the k points closest to a position.
+	 *
+	 * Cells are visited in growing rings around the position until no
+	 * unvisited cell can hold a closer point.
+	 *
+	 * @param position Query position.
+	 * @param k Maximum number of results.
+	 * @param out Receives the entities found, nearest first (replaced).
+	 */
+	void
+		queryKNearest(const sf::Vector2f& position, size_t k, std::vector<EntityID>& out) const;
+
+	/**
+	 * @brief Number of points in the grid.
+	 */
+	size_t
+		size() const { return m_entries.size(); }
+
+	/**
+	 * @brief Side of a cell in world units.
+	 */
+	float
+		getCellSize() const { return m_cellSize; }
+
+private:
+	/**
+	 * @brief Point stored in the grid.
+	 */
+	struct
+		Entry {
+		EntityID entity;       ///< Owner of the point.
+		sf::Vector2f position; ///< World position.
+		int cellX;             ///< Cell column.
+		int cellY;             ///< Cell row.
+	};
+
+	/**
+	 * @brief Cell coordinate containing a world coordinate.
+	 */
+	int
+		cellCoord(float value) const {
+		return static_cast<int>(std::floor(value * m_inverseCellSize));
+	}
+
+	/**
+	 * @brief Bucket holding a cell.
+	 */
+	size_t
+		bucketOf(int cellX, int cellY) const;
+
+	/**
+	 * @brief Calls @p func for every entry stored in the given cell.
+	 */
+	template<typename Func>
+	void
+		visitCell(int cellX, int cellY, Func&& func) const;
+
+	float m_cellSize;                  ///< Side of a cell.
+	float m_inverseCellSize;           ///< 1 / m_cellSize.
+	size_t m_bucketMask;               ///< Bucket count - 1.
+	std::vector<Entry> m_pending;      ///< Points inserted since the last build.
+	std::vector<Entry> m_entries;      ///< Points sorted by bucket.
+	std::vector<uint32_t> m_bucketStart; ///< First entry of each bucket (+1 sentinel).
+	int m_minCellX = 0;                ///< Occupied cell range, used to stop
+	int m_minCellY = 0;                ///< the k-nearest ring search.
+	int m_maxCellX = -1;
+	int m_maxCellY = -1;
+};
+
+// -------- Template implementation --------
+
+template<typename Func>
+inline void
+SpatialHashGrid::visitCell(int cellX, int cellY, Func&& func) const {
+	const size_t bucket = bucketOf(cellX, cellY);
+	for (uint32_t i = m_bucketStart[bucket]; i < m_bucketStart[bucket + 1]; ++i) {
+		const Entry& entry = m_entries[i];
+		if (entry.cellX == cellX && entry.cellY == cellY) {
+			func(entry);
+		}
+	}
+}
@@ -0,0 +1,178 @@
+#pragma once
+#include "Prerequisites.h"
+#include "ResourceManager.h"
+#include "ESC/Texture.h"
+
+/**
+ * @brief Named image inside an atlas page.
+ */
+struct
+	AtlasRegion {
+	EngineUtilities::TSharedPointer<Texture> texture; ///< Page holding the image.
+	sf::IntRect rect;                                 ///< Pixels of the image in the page.
+	size_t page = 0;                                  ///< Index of the page in its atlas.
+};
+
+/**
+ * @class MaxRectsPacker
+ * @brief Places rectangles in a bin with the MaxRects algorithm.
+ *
+ * Keeps the list of maximal free rectangles and puts each new rectangle in
+ * the free one that leaves the shortest side over (Best Short Side Fit).
+ * Rectangles are not rotated, so texture coordinates stay simple.
+ */
+class
+	MaxRectsPacker {
+public:
+	/**
+	 * @brief Constructor.
+	 * @param width Bin width.
+	 * @param height Bin height.
+	 */
+	MaxRectsPacker(int width, int height);
+
+	/**
+	 * @brief Places a rectangle.
+	 * @param width Rectangle width.
+	 * @param height Rectangle height.
+	 * @param placed Receives the rectangle position in the bin.
+	 * @return False if it does not fit anywhere.
+	 */
+	bool
+		insert(int width, int height, sf::IntRect& placed);
+
+	/**
+	 * @brief Fraction of the bin area already used.
+	 */
+	float
+		getOccupancy() const;
+
+private:
+	/**
+	 * @brief Cuts the free rectangles that overlap a placed one.
+	 */
+	void
+		splitFreeRects(const sf::IntRect& used);
+
+	/**
+	 * @brief Removes free rectangles contained in another one.
+	 */
+	void
+		pruneFreeRects();
+
+	int m_width;
+	int m_height;
+	int64_t m_usedArea = 0;
+	std::vector<sf::IntRect> m_freeRects;
+};
+
+/**
+ * @class TextureAtlas
+ * @brief Packs many small images into a few large texture pages.
+ *
+ * Shapes drawn with regions of the same page share one sf::Texture, so the
+ * RenderBatcher keeps them in one batch instead of switching textures
+ * between shapes (see RenderBatcher::getTextureBindCount()).
+ *
+ * An atlas is either built at run time (addImage()/addFile(), then
+ * build()), or built offline with `--atlas` and loaded with load(). Each
+ * image gets a border of copies of its edge pixels, so smoothing does not
+ * blend in its neighbours.
+ */
+class
+	TextureAtlas {
+public:
+	/**
+	 * @brief Constructor.
+	 * @param pageSize Width and height of the pages.
+	 * @param padding Border around each image, in pixels.
+	 */
+	explicit
+		TextureAtlas(unsigned int pageSize = 2048, unsigned int padding = 1)
+		: m_pageSize(pageSize), m_padding(padding) {}
+
+	/**
+	 * @brief Queues an image for the next build().
+	 * @param name Name used to find the region (a name added again is replaced).
+	 */
+	void
+		addImage(const std::string& name, const sf::Image& image);
+
+	/**
+	 * @brief Queues an image file, read from @p archive when it has it.
+	 * @return False if the image could not be decoded.
+	 */
+	bool
+		addFile(const std::string& name, const std::string& path,
+			const AssetArchive* archive = nullptr);
+
+	/**
+	 * @brief Packs the queued images into pages and uploads them.
+	 *
+	 * Large images are placed first, which packs MaxRects best. Images
+	 * bigger than a page are skipped with a warning. Regions of previous
+	 * builds are kept; each build fills new pages.
+	 *
+	 * @return False if a page could not be created.
+	 */
+	bool
+		build();
+
+	/**
+	 * @brief Finds a region by name.
+	 * @return Null if the atlas has no such image.
+	 */
+	const AtlasRegion*
+		findRegion(const std::string& name) const;
+
+	size_t
+		getRegionCount() const { return m_regions.size(); }
+
+	size_t
+		getPageCount() const { return m_pages.size(); }
+
+	const EngineUtilities::TSharedPointer<Texture>&
+		getPage(size_t index) const { return m_pages[index]; }
+
+	/**
+	 * @brief Writes the pages as "<prefix>_<n>.png" and the regions as
+	 * "<prefix>.atlas". The pages are read back from the GPU.
+	 * @return False if a file could not be written.
+	 */
+	bool
+		save(const std::string& pathPrefix) const;
+
+	/**
+	 * @brief Loads an atlas written by save(), replacing the current one.
+	 *
+	 * The pages are loaded through @p textures, so they come from its
+	 * AssetArchive when mounted and are shared with other users.
+	 *
+	 * @param path The ".atlas" file.
+	 * @return False if the file or a page could not be loaded.
+	 */
+	bool
+		load(const std::string& path, ResourceManager<Texture>& textures);
+
+private:
+	/**
+	 * @brief Image waiting for build().
+	 */
+	struct
+		PendingImage {
+		std::string name;
+		sf::Image image;
+	};
+
+	/**
+	 * @brief Copies the edge pixels of an image into its border.
+	 */
+	void
+		extrude(sf::Image& page, const sf::Image& image, unsigned int x, unsigned int y) const;
+
+	unsigned int m_pageSize;
+	unsigned int m_padding;
+	std::vector<PendingImage> m_pending;
+	std::vector<EngineUtilities::TSharedPointer<Texture>> m_pages;
+	std::unordered_map<std::string, AtlasRegion> m_regions;
+};
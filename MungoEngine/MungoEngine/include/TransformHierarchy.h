@@ -0,0 +1,117 @@
+#pragma once
+#include "Prerequisites.h"
+#include "ESC/World.h"
+
+/**
+ * @class TransformHierarchy
+ * @brief Parent-child links between entity Transforms.
+ *
+ * The world matrix of a child is the world matrix of its parent times its
+ * own local Transform, so attached objects follow their parent without
+ * being moved by hand.
+ *
+ * Nodes are kept in flat arrays sorted by depth, parents always before
+ * their children, so update() computes every world matrix in a single
+ * forward pass. Nodes whose local transform did not change and whose parent
+ * is clean are skipped, so only dirty subtrees cost matrix products. The
+ * order is rebuilt lazily after the links change.
+ */
+class
+	TransformHierarchy {
+public:
+	/**
+	 * @brief Default constructor.
+	 */
+	TransformHierarchy() = default;
+
+	/**
+	 * @brief Attaches @p child to @p parent, or detaches it.
+	 *
+	 * The child Transform becomes relative to the parent.
+	 *
+	 * @param child Entity to attach.
+	 * @param parent New parent, or INVALID_ENTITY to make it a root again.
+	 */
+	void
+		setParent(EntityID child, EntityID parent);
+
+	/**
+	 * @brief Parent of an entity, or INVALID_ENTITY.
+	 */
+	EntityID
+		getParent(EntityID entity) const;
+
+	/**
+	 * @brief Removes an entity from the hierarchy; its children become roots.
+	 * @param entity Entity being destroyed.
+	 */
+	void
+		remove(EntityID entity);
+
+	/**
+	 * @brief Recomputes the world matrices of the dirty subtrees.
+	 * @param world World holding the Transform components.
+	 * @param alpha Interpolation factor of the frame (1 = current step).
+	 */
+	void
+		update(World& world, float alpha = 1.f);
+
+	/**
+	 * @brief World matrix of an entity computed by the last update().
+	 *
+	 * Identity for entities that are not in the hierarchy; their local
+	 * Transform is already their world transform.
+	 */
+	const sf::Transform&
+		getWorldTransform(EntityID entity) const;
+
+	/**
+	 * @brief World matrix of the parent of an entity (identity for roots).
+	 */
+	const sf::Transform&
+		getParentWorldTransform(EntityID entity) const;
+
+	/**
+	 * @brief Entities whose parent world matrix changed in the last update().
+	 *
+	 * Includes the entities attached, detached or orphaned by remove()
+	 * since the previous update(). Render components of these entities must
+	 * pick up getParentWorldTransform(), which is the identity for roots.
+	 */
+	const std::vector<EntityID>&
+		getChangedChildren() const { return m_changedChildren; }
+
+	/**
+	 * @brief Number of entities in the hierarchy.
+	 */
+	size_t
+		size() const { return m_entities.size(); }
+
+private:
+	/**
+	 * @brief Adds an entity to the node arrays if it is not there yet.
+	 */
+	void
+		addNode(EntityID entity);
+
+	/**
+	 * @brief Sorts the nodes by depth and refreshes the parent slots.
+	 */
+	void
+		rebuildOrder();
+
+	// Node arrays, all indexed by slot and sorted by depth
+	std::vector<EntityID> m_entities;    ///< Entity of each slot.
+	std::vector<int32_t> m_parentSlots;  ///< Slot of the parent, -1 for roots.
+	std::vector<uint32_t> m_versions;    ///< Transform version used last time.
+	std::vector<sf::Transform> m_worlds; ///< World matrix of each slot.
+	std::vector<uint8_t> m_dirty;        ///< World matrix changed in the last update.
+
+	// Lookup tables indexed by entity
+	std::vector<int32_t> m_slotOf;       ///< Slot of each entity, -1 if absent.
+	std::vector<EntityID> m_parentOf;    ///< Parent of each entity.
+	std::vector<uint8_t> m_relinked;     ///< Parent link changed since the last update.
+
+	std::vector<EntityID> m_changedChildren; ///< Output of the last update.
+	bool m_orderDirty = false;           ///< Links changed since the last sort.
+};
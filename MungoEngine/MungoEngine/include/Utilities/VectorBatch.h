@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace EngineUtilities {
+	/**
+	 * @brief Operaciones de CVector2 sobre muchos vectores a la vez.
+	 *
+	 * Los vectores se guardan como estructura de arreglos (SoA): un arreglo
+	 * con todas las x y otro con todas las y. As cada instruccin SIMD procesa
+	 * 4 (SSE2) u 8 (AVX2) vectores seguidos sin reordenar datos.
+	 *
+	 * La versin se elige una sola vez en tiempo de ejecucin segn la CPU:
+	 * AVX2 si est disponible, SSE2 en cualquier x86 de 64 bits y un bucle
+	 * escalar en el resto de plataformas. length() y distance() dan los mismos
+	 * resultados que CVector2; normalize() y seek() usan en SIMD la inversa de
+	 * la raz aproximada (rsqrt ms un paso de Newton-Raphson), con un error
+	 * relativo por debajo de 5e-7.
+	 *
+	 * Los arreglos de salida pueden ser los mismos que los de entrada; no hace
+	 * falta ninguna alineacin.
+	 */
+	namespace VectorBatch {
+		/**
+		 * @brief Nombre de la versin elegida ("AVX2", "SSE2" o "Scalar").
+		 */
+		const char*
+			getBackendName();
+
+		/**
+		 * @brief out = a + b.
+		 */
+		void
+			add(const float* ax, const float* ay,
+				const float* bx, const float* by,
+				float* outX, float* outY, size_t count);
+
+		/**
+		 * @brief out = a + b * scale (p. ej. posicin + velocidad * deltaTime).
+		 */
+		void
+			addScaled(const float* ax, const float* ay,
+				const float* bx, const float* by, float scale,
+				float* outX, float* outY, size_t count);
+
+		/**
+		 * @brief out = v * scale.
+		 */
+		void
+			scale(const float* x, const float* y, float scale,
+				float* outX, float* outY, size_t count);
+
+		/**
+		 * @brief out = longitud de v.
+		 */
+		void
+			length(const float* x, const float* y, float* out, size_t count);
+
+		/**
+		 * @brief out = distancia entre a y b.
+		 */
+		void
+			distance(const float* ax, const float* ay,
+				const float* bx, const float* by,
+				float* out, size_t count);
+
+		/**
+		 * @brief out = v normalizado; los vectores nulos quedan en (0, 0),
+		 * igual que CVector2::normalized().
+		 */
+		void
+			normalize(const float* x, const float* y,
+				float* outX, float* outY, size_t count);
+
+		/**
+		 * @brief out = a + (b - a) * t.
+		 */
+		void
+			lerp(const float* ax, const float* ay,
+				const float* bx, const float* by, float t,
+				float* outX, float* outY, size_t count);
+
+		/**
+		 * @brief Mueve cada posicin hacia su objetivo, como Transform::seek().
+		 *
+		 * Las posiciones a ms de @p range de su objetivo avanzan @p step
+		 * unidades hacia l; las dems no cambian.
+		 *
+		 * @param x Coordenadas x de las posiciones (se modifican).
+		 * @param y Coordenadas y de las posiciones (se modifican).
+		 * @param targetX Coordenadas x de los objetivos.
+		 * @param targetY Coordenadas y de los objetivos.
+		 * @param step Distancia a recorrer (velocidad * deltaTime).
+		 * @param range Distancia a la que se considera alcanzado el objetivo.
+		 * @param moved Opcional: recibe 1 por cada posicin que se movi y 0 si no.
+		 * @param count Nmero de vectores.
+		 */
+		void
+			seek(float* x, float* y,
+				const float* targetX, const float* targetY,
+				float step, float range,
+				uint8_t* moved, size_t count);
+	}
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "Prerequisites.h"
+#include "RenderBatcher.h"
 
 /**
  * @class Window
@@ -54,6 +55,9 @@ public:
 
 	/**
 	 * @brief Draws a drawable object to the window.
+	 *
+	 * Pending batched shapes are flushed first so draw order is preserved.
+	 *
 	 * @param drawable The drawable object to render.
 	 * @param states Render states to apply (default is sf::RenderStates::Default).
 	 */
@@ -61,17 +65,78 @@ public:
 		draw(const sf::Drawable& drawable,
 			const sf::RenderStates& states = sf::RenderStates::Default);
 
+	/**
+	 * @brief Queues a shape in the render batcher.
+	 *
+	 * Consecutive shapes sharing texture and render states are drawn together
+	 * with a single draw call when the batch is flushed.
+	 *
+	 * @param shape The shape to render.
+	 * @param states Render states to apply (default is sf::RenderStates::Default).
+	 */
+	void
+		drawBatched(const sf::Shape& shape,
+			const sf::RenderStates& states = sf::RenderStates::Default);
+
 	/**
 	 * @brief Displays the rendered frame on the screen.
 	 *
-	 * This should be called after all draw calls to present the final image.
+	 * Flushes the render batcher, then presents the final image. This should
+	 * be called after all draw calls.
 	 */
 	void
 		display();
 
+	/**
+	 * @brief Returns the render batcher, e.g. to read its draw call statistics.
+	 */
+	const RenderBatcher&
+		getBatcher() const { return m_batcher; }
+
+	/**
+	 * @brief Limits the number of frames presented per second.
+	 * @param limit Maximum frames per second (0 disables the limit).
+	 */
+	void
+		setFramerateLimit(unsigned int limit);
+
+	/**
+	 * @brief Enables or disables vertical synchronization.
+	 * @param enabled True to wait for the monitor refresh on display().
+	 */
+	void
+		setVerticalSyncEnabled(bool enabled);
+
+	/**
+	 * @brief Returns the area of the world visible through the current view.
+	 *
+	 * Axis-aligned box of the view; rotated views get their enclosing box.
+	 */
+	sf::FloatRect
+		getViewBounds() const;
+
+	/**
+	 * @brief Converts a pixel of the window to world coordinates.
+	 * @param pixel Pixel position (e.g. the mouse position).
+	 */
+	sf::Vector2f
+		mapPixelToCoords(const sf::Vector2i& pixel) const;
+
+	/**
+	 * @brief Starts a new frame: measures the delta time and resets the
+	 * frame arena.
+	 */
 	void
 		update();
 
+	/**
+	 * @brief Returns the arena for data that only lives during the current frame.
+	 *
+	 * Everything allocated from it is discarded on the next update().
+	 */
+	EngineUtilities::FrameArena&
+		getFrameArena() { return m_frameArena; }
+
 	/**
 	 * @brief Destroys the window and releases resources.
 	 *
@@ -86,6 +151,12 @@ private:
 
 	sf::View
 		m_view; ///< Current view used for rendering.
+
+	EngineUtilities::FrameArena
+		m_frameArena; ///< Transient per-frame allocations.
+
+	RenderBatcher
+		m_batcher; ///< Groups shape draws into few vertex array draws.
 public:
 	sf::Time deltaTime; ///< Time elapsed since the last frame.
 	sf::Clock
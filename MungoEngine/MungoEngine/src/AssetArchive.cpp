@@ -0,0 +1,506 @@
+#include "AssetArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#define NOGDI
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	const char ARCHIVE_MAGIC[4] = { 'M', 'P', 'A', 'K' };
+	const uint32_t ARCHIVE_VERSION = 1;
+
+	/**
+	 * @brief Entry flag: the blob is an LZ4 block.
+	 */
+	const uint32_t ENTRY_LZ4 = 1;
+
+	/**
+	 * @brief Start of the file.
+	 */
+	struct
+		ArchiveHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t alignment;
+		uint64_t tocOffset;    ///< Table of contents (ArchiveEntry array).
+		uint64_t namesOffset;  ///< Names, not null terminated.
+		uint64_t namesSize;
+	};
+
+	/**
+	 * @brief One row of the table of contents.
+	 */
+	struct
+		ArchiveEntry {
+		uint64_t offset;       ///< Blob position in the file.
+		uint64_t storedSize;   ///< Blob size in the file.
+		uint64_t size;         ///< Size once decompressed.
+		uint32_t nameOffset;   ///< Position in the name table.
+		uint32_t nameLength;
+		uint32_t flags;
+		uint32_t reserved;
+	};
+
+	std::string
+		normalizeName(const std::string& name) {
+		std::string normalized = name;
+		std::replace(normalized.begin(), normalized.end(), '\\', '/');
+		return normalized;
+	}
+
+	uint32_t
+		read32(const uint8_t* bytes) {
+		uint32_t value;
+		std::memcpy(&value, bytes, sizeof(value));
+		return value;
+	}
+
+	void
+		writeLength(std::vector<char>& out, size_t length) {
+		while (length >= 255) {
+			out.push_back(static_cast<char>(255));
+			length -= 255;
+		}
+		out.push_back(static_cast<char>(length));
+	}
+
+	/**
+	 * @brief Greedy LZ4 block compressor (4 KB hash table, 64 KB window).
+	 *
+	 * Keeps the block format rules: the last 5 bytes are literals and no
+	 * match starts in the last 12 bytes.
+	 */
+	std::vector<char>
+		lz4Compress(const char* data, size_t size) {
+		const uint8_t* source = reinterpret_cast<const uint8_t*>(data);
+		std::vector<char> out;
+		out.reserve(size + size / 255 + 16);
+
+		std::vector<uint32_t> table(4096, 0);
+		size_t anchor = 0;
+		size_t position = 0;
+		const size_t matchStartLimit = size > 12 ? size - 12 : 0;
+		const size_t matchEndLimit = size > 5 ? size - 5 : 0;
+
+		while (position < matchStartLimit) {
+			const uint32_t sequence = read32(source + position);
+			const uint32_t hash = (sequence * 2654435761u) >> 20;
+			const size_t candidate = table[hash];
+			table[hash] = static_cast<uint32_t>(position);
+
+			if (candidate >= position || position - candidate > 65535 ||
+				read32(source + candidate) != sequence) {
+				++position;
+				continue;
+			}
+
+			size_t matchLength = 4;
+			while (position + matchLength < matchEndLimit &&
+				source[candidate + matchLength] == source[position + matchLength]) {
+				++matchLength;
+			}
+
+			const size_t literals = position - anchor;
+			const size_t extraMatch = matchLength - 4;
+			out.push_back(static_cast<char>((std::min<size_t>(literals, 15) << 4) |
+				std::min<size_t>(extraMatch, 15)));
+			if (literals >= 15) {
+				writeLength(out, literals - 15);
+			}
+			out.insert(out.end(), data + anchor, data + position);
+			const uint16_t offset = static_cast<uint16_t>(position - candidate);
+			out.push_back(static_cast<char>(offset & 0xFF));
+			out.push_back(static_cast<char>(offset >> 8));
+			if (extraMatch >= 15) {
+				writeLength(out, extraMatch - 15);
+			}
+
+			position += matchLength;
+			anchor = position;
+		}
+
+		// Last sequence: literals only
+		const size_t literals = size - anchor;
+		out.push_back(static_cast<char>(std::min<size_t>(literals, 15) << 4));
+		if (literals >= 15) {
+			writeLength(out, literals - 15);
+		}
+		out.insert(out.end(), data + anchor, data + size);
+		return out;
+	}
+
+	/**
+	 * @brief Decodes an LZ4 block, checking every read and write.
+	 * @return False if the block is corrupt or does not give exactly @p size bytes.
+	 */
+	bool
+		lz4Decompress(const char* data, size_t storedSize, char* out, size_t size) {
+		const uint8_t* source = reinterpret_cast<const uint8_t*>(data);
+		size_t in = 0;
+		size_t written = 0;
+
+		while (in < storedSize) {
+			const uint8_t token = source[in++];
+
+			size_t literals = token >> 4;
+			if (literals == 15) {
+				uint8_t extra;
+				do {
+					if (in >= storedSize) return false;
+					extra = source[in++];
+					literals += extra;
+				} while (extra == 255);
+			}
+			if (literals > storedSize - in || literals > size - written) {
+				return false;
+			}
+			std::memcpy(out + written, source + in, literals);
+			in += literals;
+			written += literals;
+			if (in == storedSize) {
+				break;
+			}
+
+			if (storedSize - in < 2) return false;
+			const size_t offset = source[in] | (source[in + 1] << 8);
+			in += 2;
+			if (offset == 0 || offset > written) {
+				return false;
+			}
+
+			size_t matchLength = token & 15;
+			if (matchLength == 15) {
+				uint8_t extra;
+				do {
+					if (in >= storedSize) return false;
+					extra = source[in++];
+					matchLength += extra;
+				} while (extra == 255);
+			}
+			matchLength += 4;
+			if (matchLength > size - written) {
+				return false;
+			}
+
+			// Byte by byte: the match may overlap the bytes it produces
+			const char* match = out + written - offset;
+			for (size_t i = 0; i < matchLength; ++i) {
+				out[written + i] = match[i];
+			}
+			written += matchLength;
+		}
+		return written == size;
+	}
+}
+
+AssetArchive::~AssetArchive() {
+	close();
+}
+
+bool
+AssetArchive::open(const std::string& path) {
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		LOG_WARNING("AssetArchive", "open", "Could not open " << path);
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	HANDLE mapping = nullptr;
+	const void* view = nullptr;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		}
+	}
+	if (!view) {
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		LOG_WARNING("AssetArchive", "open", "Could not map " << path);
+		return false;
+	}
+	m_file = file;
+	m_mapping = mapping;
+	m_data = static_cast<const char*>(view);
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		LOG_WARNING("AssetArchive", "open", "Could not open " << path);
+		return false;
+	}
+	struct stat status;
+	void* view = MAP_FAILED;
+	if (fstat(file, &status) == 0 && status.st_size > 0) {
+		view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	}
+	// The mapping stays valid after closing the descriptor
+	::close(file);
+	if (view == MAP_FAILED) {
+		LOG_WARNING("AssetArchive", "open", "Could not map " << path);
+		return false;
+	}
+	m_data = static_cast<const char*>(view);
+	m_size = static_cast<size_t>(status.st_size);
+#endif
+	m_path = path;
+
+	// Validate everything once, so lookups can trust the offsets
+	ArchiveHeader header;
+	bool valid = m_size >= sizeof(header);
+	if (valid) {
+		std::memcpy(&header, m_data, sizeof(header));
+		valid = std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) == 0 &&
+			header.version == ARCHIVE_VERSION &&
+			header.tocOffset % alignof(ArchiveEntry) == 0 &&
+			header.tocOffset <= m_size &&
+			header.entryCount <= (m_size - header.tocOffset) / sizeof(ArchiveEntry) &&
+			header.namesOffset <= m_size &&
+			header.namesSize <= m_size - header.namesOffset;
+	}
+	if (valid) {
+		m_toc = m_data + header.tocOffset;
+		m_names = m_data + header.namesOffset;
+		m_entryCount = header.entryCount;
+		const ArchiveEntry* entries = reinterpret_cast<const ArchiveEntry*>(m_toc);
+		for (size_t i = 0; i < m_entryCount && valid; ++i) {
+			const ArchiveEntry& entry = entries[i];
+			valid = entry.offset <= m_size &&
+				entry.storedSize <= m_size - entry.offset &&
+				entry.nameOffset <= header.namesSize &&
+				entry.nameLength <= header.namesSize - entry.nameOffset &&
+				((entry.flags & ENTRY_LZ4) != 0 || entry.storedSize == entry.size);
+		}
+	}
+	if (!valid) {
+		LOG_WARNING("AssetArchive", "open", path << " is not a valid asset archive");
+		close();
+		return false;
+	}
+
+	m_decompressed.resize(m_entryCount);
+	LOG_INFO("AssetArchive", "open", path << ": " << m_entryCount << " entries");
+	return true;
+}
+
+void
+AssetArchive::close() {
+	if (m_data) {
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+		CloseHandle(static_cast<HANDLE>(m_mapping));
+		CloseHandle(static_cast<HANDLE>(m_file));
+#else
+		munmap(const_cast<char*>(m_data), m_size);
+#endif
+	}
+	m_file = nullptr;
+	m_mapping = nullptr;
+	m_data = nullptr;
+	m_size = 0;
+	m_toc = nullptr;
+	m_names = nullptr;
+	m_entryCount = 0;
+	m_path.clear();
+
+	std::lock_guard<std::mutex> lock(m_decompressMutex);
+	m_decompressed.clear();
+}
+
+bool
+AssetArchive::contains(const std::string& name) const {
+	return findIndex(name) >= 0;
+}
+
+AssetBlob
+AssetArchive::find(const std::string& name) const {
+	const ptrdiff_t index = findIndex(name);
+	if (index < 0) {
+		return AssetBlob();
+	}
+
+	const ArchiveEntry& entry = reinterpret_cast<const ArchiveEntry*>(m_toc)[index];
+	AssetBlob blob;
+	blob.size = static_cast<size_t>(entry.size);
+	if (!(entry.flags & ENTRY_LZ4)) {
+		blob.data = m_data + entry.offset;
+		return blob;
+	}
+
+	std::lock_guard<std::mutex> lock(m_decompressMutex);
+	std::unique_ptr<char[]>& buffer = m_decompressed[index];
+	if (!buffer) {
+		std::unique_ptr<char[]> decompressed(new char[blob.size > 0 ? blob.size : 1]);
+		if (!lz4Decompress(m_data + entry.offset, static_cast<size_t>(entry.storedSize),
+			decompressed.get(), blob.size)) {
+			LOG_WARNING("AssetArchive", "find", name << " is corrupt in " << m_path);
+			return AssetBlob();
+		}
+		buffer = std::move(decompressed);
+	}
+	blob.data = buffer.get();
+	return blob;
+}
+
+ptrdiff_t
+AssetArchive::findIndex(const std::string& name) const {
+	if (!m_data) {
+		return -1;
+	}
+	const std::string key = name.find('\\') == std::string::npos ? name : normalizeName(name);
+	const ArchiveEntry* entries = reinterpret_cast<const ArchiveEntry*>(m_toc);
+
+	// The table is sorted by name
+	size_t first = 0;
+	size_t last = m_entryCount;
+	while (first < last) {
+		const size_t middle = first + (last - first) / 2;
+		const ArchiveEntry& entry = entries[middle];
+		const int order = key.compare(0, std::string::npos, m_names + entry.nameOffset, entry.nameLength);
+		if (order == 0) {
+			return static_cast<ptrdiff_t>(middle);
+		}
+		if (order < 0) {
+			last = middle;
+		}
+		else {
+			first = middle + 1;
+		}
+	}
+	return -1;
+}
+
+void
+AssetArchiveBuilder::setAlignment(uint32_t bytes) {
+	// Round up to a power of two
+	uint32_t alignment = 1;
+	while (alignment < bytes && alignment < (1u << 16)) {
+		alignment <<= 1;
+	}
+	m_alignment = alignment;
+}
+
+bool
+AssetArchiveBuilder::addFile(const std::string& name, const std::string& filePath) {
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file) {
+		LOG_WARNING("AssetArchiveBuilder", "addFile", "Could not read " << filePath);
+		return false;
+	}
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	m_sources[normalizeName(name)] = std::move(data);
+	return true;
+}
+
+size_t
+AssetArchiveBuilder::addDirectory(const std::string& directory) {
+	std::error_code error;
+	std::filesystem::recursive_directory_iterator it(directory, error);
+	if (error) {
+		LOG_WARNING("AssetArchiveBuilder", "addDirectory", "Could not list " << directory);
+		return 0;
+	}
+
+	size_t added = 0;
+	for (const auto& file : it) {
+		if (file.is_regular_file() &&
+			addFile(file.path().generic_string(), file.path().string())) {
+			++added;
+		}
+	}
+	return added;
+}
+
+void
+AssetArchiveBuilder::addData(const std::string& name, const void* data, size_t size) {
+	const char* bytes = static_cast<const char*>(data);
+	m_sources[normalizeName(name)].assign(bytes, bytes + size);
+}
+
+bool
+AssetArchiveBuilder::write(const std::string& archivePath) const {
+	std::ofstream file(archivePath, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		LOG_WARNING("AssetArchiveBuilder", "write", "Could not create " << archivePath);
+		return false;
+	}
+
+	auto pad = [&file](uint64_t alignment) {
+		const uint64_t position = static_cast<uint64_t>(file.tellp());
+		const uint64_t padding = (alignment - position % alignment) % alignment;
+		static const char zeros[1 << 16] = {};
+		file.write(zeros, static_cast<std::streamsize>(padding));
+	};
+
+	ArchiveHeader header = {};
+	std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+	header.version = ARCHIVE_VERSION;
+	header.entryCount = static_cast<uint32_t>(m_sources.size());
+	header.alignment = m_alignment;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	// Blobs, in name order (std::map is sorted)
+	std::vector<ArchiveEntry> entries;
+	std::string names;
+	entries.reserve(m_sources.size());
+	size_t compressedCount = 0;
+	for (const auto& source : m_sources) {
+		const std::vector<char>& data = source.second;
+		ArchiveEntry entry = {};
+		entry.size = data.size();
+		entry.nameOffset = static_cast<uint32_t>(names.size());
+		entry.nameLength = static_cast<uint32_t>(source.first.size());
+		names += source.first;
+
+		std::vector<char> compressed;
+		if (m_compress && !data.empty()) {
+			compressed = lz4Compress(data.data(), data.size());
+			// Only worth a copy on load if it saves at least 1/16
+			if (compressed.size() < data.size() - data.size() / 16) {
+				entry.flags = ENTRY_LZ4;
+				++compressedCount;
+			}
+		}
+		const std::vector<char>& stored = (entry.flags & ENTRY_LZ4) ? compressed : data;
+
+		pad(m_alignment);
+		entry.offset = static_cast<uint64_t>(file.tellp());
+		entry.storedSize = stored.size();
+		file.write(stored.data(), static_cast<std::streamsize>(stored.size()));
+		entries.push_back(entry);
+	}
+
+	pad(alignof(ArchiveEntry));
+	header.tocOffset = static_cast<uint64_t>(file.tellp());
+	file.write(reinterpret_cast<const char*>(entries.data()),
+		static_cast<std::streamsize>(entries.size() * sizeof(ArchiveEntry)));
+	header.namesOffset = static_cast<uint64_t>(file.tellp());
+	header.namesSize = names.size();
+	file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+	file.seekp(0);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (!file) {
+		LOG_WARNING("AssetArchiveBuilder", "write", "Could not write " << archivePath);
+		return false;
+	}
+
+	LOG_INFO("AssetArchiveBuilder", "write", archivePath << ": " << entries.size()
+		<< " entries, " << compressedCount << " compressed");
+	return true;
+}
@@ -0,0 +1,119 @@
+#include "AsyncTextureLoader.h"
+#include <algorithm>
+
+AsyncTextureLoader::~AsyncTextureLoader() {
+	waitForDecodes();
+}
+
+AsyncTextureLoader::Handle
+AsyncTextureLoader::request(const std::string& path) {
+	// Same file already loading or loaded
+	for (const auto& load : m_loads) {
+		if (load->path == path) {
+			return load->texture;
+		}
+	}
+	if (m_cache.contains(path)) {
+		return m_cache.load(path);
+	}
+
+	auto load = std::make_unique<PendingLoad>();
+	load->path = path;
+	load->archive = m_cache.getArchive();
+	load->texture = EngineUtilities::MakeShared<Texture>();
+	Handle texture = load->texture;
+
+	// Background jobs never run inside a frame's wait(). Without workers
+	// they would run right here: decode in processUploads() instead
+	if (m_jobs.getThreadCount() > 1) {
+		PendingLoad* pending = load.get();
+		m_jobs.scheduleBackground([pending]() { decode(*pending); }, &m_decodeJobs);
+	}
+	m_loads.push_back(std::move(load));
+	return texture;
+}
+
+size_t
+AsyncTextureLoader::processUploads(float budgetMilliseconds) {
+	PROFILE_SCOPE("AsyncTextureLoader::processUploads");
+	if (m_loads.empty()) {
+		return 0;
+	}
+
+	sf::Clock clock;
+	const sf::Time budget = sf::microseconds(static_cast<sf::Int64>(budgetMilliseconds * 1000.f));
+	const bool inlineDecode = m_jobs.getThreadCount() <= 1;
+	size_t completed = 0;
+	bool worked = false;
+
+	// Oldest requests first, so textures become ready in request order
+	for (size_t i = 0; i < m_loads.size();) {
+		if (worked && clock.getElapsedTime() >= budget) {
+			break;
+		}
+
+		PendingLoad& load = *m_loads[i];
+		int state = load.state.load(std::memory_order_acquire);
+		if (state == LOAD_QUEUED && inlineDecode) {
+			decode(load);
+			worked = true;
+			state = load.state.load(std::memory_order_acquire);
+		}
+
+		if (state == LOAD_FAILED) {
+			LOG_WARNING("AsyncTextureLoader", "processUploads", "Could not load " << load.path);
+			m_loads.erase(m_loads.begin() + i);
+			continue;
+		}
+		if (state == LOAD_QUEUED) {
+			++i;
+			continue;
+		}
+
+		worked = true;
+		if (uploadStep(load)) {
+			m_cache.insert(load.path, load.texture);
+			m_loads.erase(m_loads.begin() + i);
+			++completed;
+			continue;
+		}
+		// Still uploading: keep working on it while there is budget
+	}
+	return completed;
+}
+
+void
+AsyncTextureLoader::decode(PendingLoad& load) {
+	bool decoded;
+	AssetBlob blob = load.archive ? load.archive->find(load.path) : AssetBlob();
+	if (blob) {
+		decoded = load.image.loadFromMemory(blob.data, blob.size);
+	}
+	else {
+		decoded = load.image.loadFromFile(load.path);
+	}
+	load.state.store(decoded ? LOAD_DECODED : LOAD_FAILED, std::memory_order_release);
+}
+
+bool
+AsyncTextureLoader::uploadStep(PendingLoad& load) {
+	const sf::Vector2u size = load.image.getSize();
+	if (load.state.load(std::memory_order_relaxed) == LOAD_DECODED) {
+		if (!load.texture->beginUpload(size)) {
+			load.state.store(LOAD_FAILED, std::memory_order_relaxed);
+			return false;
+		}
+		load.state.store(LOAD_UPLOADING, std::memory_order_relaxed);
+	}
+
+	const unsigned int rows = std::min(m_rowsPerStep, size.y - load.uploadedRows);
+	load.texture->uploadRows(load.image, load.uploadedRows, rows);
+	load.uploadedRows += rows;
+	if (load.uploadedRows < size.y) {
+		return false;
+	}
+
+	load.texture->endUpload();
+	load.image = sf::Image();
+	return true;
+}
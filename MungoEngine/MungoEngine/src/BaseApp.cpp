@@ -1,4 +1,5 @@
 #include "BaseApp.h"
+#include <algorithm>
 
 
 BaseApp::~BaseApp() {}
@@ -8,76 +9,257 @@ int BaseApp::run() {
         ERROR("BaseApp", "run", "Initialization failed. Please check method validations.");
     }
 
+    if (m_backend == HEADLESS) {
+        return runHeadless();
+    }
+
     while (m_windowPtr->isOpen()) {
-        m_windowPtr->handleEvents();
-        update();
-        render();
+        {
+            PROFILE_SCOPE("BaseApp::run");
+            m_windowPtr->handleEvents();
+
+            // Measure real frame time and bank it for the fixed-step simulation
+            m_windowPtr->update();
+            m_accumulator += m_windowPtr->deltaTime.asSeconds();
+
+            int steps = 0;
+            while (m_accumulator >= m_fixedTimeStep && steps < m_maxCatchUpSteps) {
+                update(m_fixedTimeStep);
+                m_accumulator -= m_fixedTimeStep;
+                ++steps;
+            }
+
+            // Too far behind: drop the whole steps we could not simulate
+            if (m_accumulator >= m_fixedTimeStep) {
+                m_accumulator = std::fmod(m_accumulator, m_fixedTimeStep);
+            }
+
+            render(m_accumulator / m_fixedTimeStep);
+        }
+
+        // The frame zone is closed: fold this frame into the statistics
+        Profiler::getInstance().endFrame();
+    }
+
+    destroy();
+    return 0;
+}
+
+int BaseApp::runHeadless() {
+    sf::Clock realClock;
+
+    for (uint64_t frame = 0; frame < m_headlessFrameCount; ++frame) {
+        {
+            PROFILE_SCOPE("BaseApp::run");
+            update(m_fixedTimeStep);
+        }
+        Profiler::getInstance().endFrame();
     }
 
+    float seconds = realClock.getElapsedTime().asSeconds();
+    m_headlessSeconds = seconds;
+    LOG_INFO("BaseApp", "runHeadless", m_headlessFrameCount << " frames in " << seconds << " s ("
+        << (seconds > 0.f ? m_headlessFrameCount / seconds : 0.f) << " frames/s, "
+        << m_world.getEntityCount() << " entities)");
+
     destroy();
     return 0;
 }
 
 bool BaseApp::init() {
-    m_windowPtr = EngineUtilities::MakeShared<Window>(1920, 1080, "MungoEngine");
-    if (!m_windowPtr) {
-        ERROR("BaseApp", "init", "Failed to create window pointer, check memory allocation");
-        return false;
+    if (m_backend == WINDOWED) {
+        m_windowPtr = EngineUtilities::MakeShared<Window>(1920, 1080, "MungoEngine");
+        if (!m_windowPtr) {
+            ERROR("BaseApp", "init", "Failed to create window pointer, check memory allocation");
+            return false;
+        }
     }
 
-    m_ACircle = EngineUtilities::MakeShared<Actor>("Circle Actor");
+    // Destroyed ids are recycled: drop them from the systems indexed by id
+    m_world.addDestroyListener([this](EntityID entity) {
+        m_shapeTree.remove(entity);
+        m_collisionSystem.remove(entity);
+        m_hierarchy.remove(entity);
+    });
+
+    m_ACircle = EngineUtilities::MakeShared<Actor>(&m_world, "Circle Actor");
     if (m_ACircle) {
         m_ACircle->getComponent<CShape>()->createShape(CIRCLE);
         m_ACircle->getComponent<CShape>()->setFillColor(sf::Color::Red);
         m_ACircle->getComponent<Transform>()->setPosition(sf::Vector2f(100.f, 150.f));
+        m_ACircle->addComponent<Collider>()->fitToShape(*m_ACircle->getComponent<CShape>());
+        m_ACircle->addComponent<PathFollower>()->setPath({
+            sf::Vector2f(600.f, 150.f), sf::Vector2f(400.f, 300.f),
+            sf::Vector2f(300.f, 200.f), sf::Vector2f(300.f, 150.f) });
     }
 
-    m_waypoints.push_back(sf::Vector2f(600.f, 150.f));
-    m_waypoints.push_back(sf::Vector2f(400.f, 300.f));
-    m_waypoints.push_back(sf::Vector2f(300.f, 200.f));
-    m_waypoints.push_back(sf::Vector2f(300.f, 150.f));
+    // Agents request paths on this grid through getPathfinding(); a grid
+    // set up before run() is kept
+    if (m_navigationGrid.getCellCount() == 0) {
+        m_navigationGrid.resize(1920 / 16, 1080 / 16, 16.f);
+    }
+    m_pathfinding.setGrid(&m_navigationGrid);
 
-    m_currentWaypointIndex = 0;
+    if (m_vsync && m_windowPtr) {
+        m_windowPtr->setFramerateLimit(0);
+        m_windowPtr->setVerticalSyncEnabled(true);
+    }
+
+    // Start interpolation from the initial state, not from the origin
+    m_world.forEach<Transform>([](Transform& transform) {
+        transform.savePreviousState();
+    });
+    m_accumulator = 0.f;
 
     return true;
 }
 
-void BaseApp::update() {
-    if (!m_windowPtr.isNull()) {
-        m_windowPtr->update();
+void BaseApp::update(float deltaTime) {
+    PROFILE_SCOPE("BaseApp::update");
+
+    if (m_stepCallback) {
+        m_stepCallback(deltaTime);
     }
 
-    if (!m_ACircle.isNull()) {
-        m_ACircle->update(m_windowPtr->deltaTime.asSeconds());
+    // Keep the state of the previous step for render interpolation
+    m_world.parallelForEach<Transform>(m_jobSystem, 1024, [](Transform& transform) {
+        transform.savePreviousState();
+    });
 
-        if (m_currentWaypointIndex < m_waypoints.size()) {
-            sf::Vector2f targetPos = m_waypoints[m_currentWaypointIndex];
+    // New particles start where their entity is now
+    m_world.forEach<Transform, ParticleEmitter>(
+        [](Transform& transform, ParticleEmitter& emitter) {
+            emitter.setPosition(transform.getPosition());
+        });
 
-            float distanceToTarget = std::sqrt(
-                std::pow(targetPos.x - m_ACircle->getComponent<Transform>()->getPosition().x, 2) +
-                std::pow(targetPos.y - m_ACircle->getComponent<Transform>()->getPosition().y, 2)
-            );
+    // Update every component, walking the archetype arrays linearly
+    // instead of actor by actor, split across the worker threads.
+    m_world.update(deltaTime, &m_jobSystem);
 
-            if (distanceToTarget < 10.0f) {
-                m_currentWaypointIndex++;
-            }
-            else {
-                m_ACircle->getComponent<Transform>()->seek(
-                    targetPos, 100.f, m_windowPtr->deltaTime.asSeconds(), 10.f);
+    // Hand finished searches to their followers, start the next batch and
+    // move every agent along its path on the workers
+    m_pathfinding.update(m_world);
+    m_world.parallelForEach<Transform, PathFollower>(m_jobSystem, 1024,
+        [deltaTime](Transform& transform, PathFollower& follower) {
+            follower.follow(transform, deltaTime);
+        });
+
+    // Positions are final for this step: report overlaps and refresh the
+    // proximity index
+    m_collisionSystem.update(m_world);
+    m_spatialGrid.rebuild(m_world);
+}
+
+void BaseApp::render(float alpha) {
+    PROFILE_SCOPE("BaseApp::render");
+    if (!m_windowPtr) return;
+
+    // Finish a bounded amount of background texture loading
+    m_textureLoader.processUploads(m_textureUploadBudget);
+
+    // Push the interpolated transforms of the actors that moved to their
+    // shapes and keep the quadtree in sync; static actors cost one compare.
+    m_world.forEachEntity<Transform, CShape>(
+        [this, alpha](EntityID entity, Transform& transform, CShape& shape) {
+            if (shape.syncTransform(transform, alpha)) {
+                m_shapeTree.update(entity, shape.getGlobalBounds());
             }
+        });
+
+    // Children of moved parents pick up the new parent matrix; detached or
+    // orphaned entities get the identity back
+    m_hierarchy.update(m_world, alpha);
+    for (EntityID entity : m_hierarchy.getChangedChildren()) {
+        CShape* shape = m_world.getComponent<CShape>(entity);
+        if (shape) {
+            const EntityID parent = m_hierarchy.getParent(entity);
+            shape->setParentTransform(parent == INVALID_ENTITY
+                ? sf::Transform::Identity
+                : m_hierarchy.getWorldTransform(parent));
+            m_shapeTree.update(entity, shape->getGlobalBounds());
         }
     }
-}
 
-void BaseApp::render() {
-    if (!m_windowPtr) return;
+    // Only draw the shapes overlapping the view, in entity order so the
+    // batcher keeps a stable draw order between frames. The list lives in
+    // the frame arena; reserving the worst case up front means it never
+    // regrows (arena memory is only reclaimed at the next frame).
+    EngineUtilities::TFrameVector<EntityID> visibleEntities{
+        EngineUtilities::TFrameAllocator<EntityID>(m_windowPtr->getFrameArena()) };
+    visibleEntities.reserve(m_shapeTree.size());
+    m_shapeTree.query(m_windowPtr->getViewBounds(), visibleEntities);
+    std::sort(visibleEntities.begin(), visibleEntities.end());
 
     m_windowPtr->clear();
 
     if (m_shapePtr) m_shapePtr->render(m_windowPtr);
-    if (m_ACircle)  m_ACircle->render(m_windowPtr);
+    for (EntityID entity : visibleEntities) {
+        CShape* shape = m_world.getComponent<CShape>(entity);
+        if (shape) {
+            shape->render(m_windowPtr);
+        }
+    }
+
+    // Particle effects on top, one draw call per emitter
+    m_world.forEach<ParticleEmitter>([this](ParticleEmitter& emitter) {
+        emitter.render(m_windowPtr, &m_jobSystem);
+    });
 
     m_windowPtr->display();
 }
 
-void BaseApp::destroy() {}
+void BaseApp::destroy() {
+    Profiler& profiler = Profiler::getInstance();
+    profiler.printSummary();
+    if (!m_tracePath.empty()) {
+        if (profiler.writeChromeTrace(m_tracePath)) {
+            LOG_INFO("BaseApp", "destroy", "Profiler trace written to " << m_tracePath);
+        }
+        else {
+            LOG_WARNING("BaseApp", "destroy", "Could not write profiler trace to " << m_tracePath);
+        }
+    }
+
+    const ResourceManager<Texture>::Stats& textureStats = m_textures.getStats();
+    LOG_INFO("BaseApp", "destroy", "Texture cache: " << textureStats.hits << " hits, "
+        << textureStats.misses << " misses, " << textureStats.evictions << " evictions");
+
+    m_shapeTree.clear();
+    if (m_ACircle) m_ACircle->destroy();
+    m_textures.clear();
+}
+
+bool BaseApp::mountArchive(const std::string& path) {
+    // open() unmaps the current archive, which decode jobs may be reading
+    m_textureLoader.waitForDecodes();
+    if (!m_assets.open(path)) {
+        m_textures.setArchive(nullptr);
+        return false;
+    }
+    m_textures.setArchive(&m_assets);
+    return true;
+}
+
+bool BaseApp::pick(const sf::Vector2i& pixel, EntityID& entity) const {
+    if (!m_windowPtr) return false;
+    return m_shapeTree.pick(m_windowPtr->mapPixelToCoords(pixel), entity);
+}
+
+void BaseApp::setSimulationRate(float stepsPerSecond) {
+    if (stepsPerSecond <= 0.f) {
+        ERROR("BaseApp", "setSimulationRate", "Simulation rate must be positive");
+    }
+    m_fixedTimeStep = 1.f / stepsPerSecond;
+}
+
+void BaseApp::setMaxCatchUpSteps(int maxSteps) {
+    m_maxCatchUpSteps = maxSteps > 0 ? maxSteps : 1;
+}
+
+void BaseApp::setVSync(bool enabled) {
+    m_vsync = enabled;
+    if (m_windowPtr) {
+        m_windowPtr->setFramerateLimit(enabled ? 0 : 60);
+        m_windowPtr->setVerticalSyncEnabled(enabled);
+    }
+}
@@ -0,0 +1,51 @@
+#include "Benchmark.h"
+#include <cstdio>
+
+bool
+Benchmark::add(const char* name, const char* description, Function function) {
+	getEntries().push_back({ name, description, function });
+	return true;
+}
+
+int
+Benchmark::run(const std::string& name) {
+	std::vector<Entry> entries = getEntries();
+	std::sort(entries.begin(), entries.end(),
+		[](const Entry& a, const Entry& b) { return std::string(a.name) < b.name; });
+
+	if (name == "list") {
+		for (const Entry& entry : entries) {
+			std::printf("%-14s %s\n", entry.name, entry.description);
+		}
+		return 0;
+	}
+
+	bool found = false;
+	for (const Entry& entry : entries) {
+		if (name != "all" && name != entry.name) {
+			continue;
+		}
+		found = true;
+		std::printf("== %s: %s\n", entry.name, entry.description);
+		std::fflush(stdout);
+		Benchmark bench(entry.name);
+		entry.function(bench);
+	}
+	if (!found) {
+		std::printf("Unknown benchmark '%s' (see --bench list)\n", name.c_str());
+	}
+	Logger::getInstance().flush();
+	return found ? 0 : 1;
+}
+
+void
+Benchmark::report(const std::string& label, double value, const std::string& unit) {
+	std::printf("%-14s %-44s %12.3f %s\n", m_name, label.c_str(), value, unit.c_str());
+	std::fflush(stdout);
+}
+
+std::vector<Benchmark::Entry>&
+Benchmark::getEntries() {
+	static std::vector<Entry> entries;
+	return entries;
+}
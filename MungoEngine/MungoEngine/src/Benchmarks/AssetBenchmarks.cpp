@@ -0,0 +1,275 @@
+#include "Benchmark.h"
+#include "AsyncTextureLoader.h"
+#include "AssetArchive.h"
+#include "BaseApp.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+namespace {
+	volatile size_t s_sink = 0;
+
+	/**
+	 * @brief Empty directory in the system temp folder, removed with the object.
+	 */
+	struct
+		ScratchDirectory {
+		std::filesystem::path path;
+
+		explicit
+			ScratchDirectory(const std::string& name)
+			: path(std::filesystem::temp_directory_path() / name) {
+			std::filesystem::remove_all(path);
+			std::filesystem::create_directories(path);
+		}
+
+		~ScratchDirectory() {
+			std::error_code error;
+			std::filesystem::remove_all(path, error);
+		}
+	};
+
+	/**
+	 * @brief Writes @p count noisy PNG images of @p size x @p size pixels.
+	 * @return Their paths, or an empty list if one could not be written.
+	 */
+	std::vector<std::string>
+		writeImages(const ScratchDirectory& directory, size_t count, unsigned int size) {
+		std::mt19937 random(17);
+		std::vector<std::string> paths;
+		sf::Image image;
+		image.create(size, size);
+		for (size_t i = 0; i < count; ++i) {
+			for (unsigned int y = 0; y < size; ++y) {
+				for (unsigned int x = 0; x < size; ++x) {
+					const sf::Uint32 value = random();
+					image.setPixel(x, y, sf::Color(value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF));
+				}
+			}
+			const std::string path = (directory.path / ("image" + std::to_string(i) + ".png")).generic_string();
+			if (!image.saveToFile(path)) {
+				std::printf("Could not write %s\n", path.c_str());
+				return std::vector<std::string>();
+			}
+			paths.push_back(path);
+		}
+		return paths;
+	}
+
+	/**
+	 * @brief Touches one byte per cache line, so mapped pages are read in.
+	 */
+	size_t
+		checksum(const void* data, size_t size) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		size_t sum = 0;
+		for (size_t i = 0; i < size; i += 64) {
+			sum += bytes[i];
+		}
+		return sum;
+	}
+}
+
+BENCHMARK(streaming, "Worst frame while loading 500 textures: blocking loads vs AsyncTextureLoader") {
+	const size_t textureCount = 500;
+	const float uploadBudgetMs = 2.f;
+	const auto framePeriod = std::chrono::microseconds(16667);
+
+	ScratchDirectory directory("mungo_bench_streaming");
+	const std::vector<std::string> paths = writeImages(directory, textureCount, 256);
+	if (paths.empty()) {
+		return;
+	}
+
+	// Blocking: the level load happens inside one frame
+	{
+		ResourceManager<Texture> cache;
+		const double blockingMs = Benchmark::time([&]() {
+			for (const std::string& path : paths) {
+				cache.load(path);
+			}
+		});
+		bench.report("blocking: worst frame (all loads in one)", blockingMs, "ms");
+		bench.report("blocking: per texture", blockingMs / textureCount, "ms");
+	}
+
+	// Async: request everything, then run 60 Hz frames that only upload
+	// within the budget until every texture is ready
+	JobSystem jobs;
+	ResourceManager<Texture> cache;
+	AsyncTextureLoader loader(jobs, cache);
+	std::vector<AsyncTextureLoader::Handle> textures;
+	double worstFrameMs = Benchmark::time([&]() {
+		for (const std::string& path : paths) {
+			textures.push_back(loader.request(path));
+		}
+	});
+	const double requestMs = worstFrameMs;
+
+	size_t frames = 0;
+	const auto start = std::chrono::steady_clock::now();
+	while (loader.getPendingCount() > 0) {
+		std::this_thread::sleep_until(start + framePeriod * frames);
+		worstFrameMs = std::max(worstFrameMs, Benchmark::time([&]() {
+			loader.processUploads(uploadBudgetMs);
+		}));
+		++frames;
+	}
+	const double streamingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	size_t ready = 0;
+	for (const AsyncTextureLoader::Handle& texture : textures) {
+		ready += texture->isReady();
+	}
+
+	std::printf("%u job system threads\n", jobs.getThreadCount());
+	bench.report("async: requesting all", requestMs, "ms");
+	bench.report("async: worst frame", worstFrameMs, "ms");
+	bench.report("async: frames until all ready", double(frames), "frames");
+	bench.report("async: time until all ready", streamingSeconds, "s");
+	bench.report("async: textures ready", double(ready), "textures");
+}
+
+BENCHMARK(decodes, "Worst headless step of a 20k-actor scene while 500 texture decodes run on the workers") {
+	const size_t actorCount = 20000;
+	const size_t textureCount = 500;
+	const uint64_t frames = 120;
+	const unsigned int threads = std::max(2u, std::thread::hardware_concurrency());
+
+	ScratchDirectory directory("mungo_bench_decodes");
+	const std::vector<std::string> paths = writeImages(directory, textureCount, 256);
+	if (paths.empty()) {
+		return;
+	}
+
+	// The same scene with and without the requests; decodes run on the
+	// workers while the steps wait on their own parallel jobs
+	auto runScene = [&](bool loading, double& worstStepMs, double& remainingMs) {
+		BaseApp app(HEADLESS, threads);
+		app.setHeadlessFrameCount(frames);
+		World& world = app.getWorld();
+		for (size_t i = 0; i < actorCount; ++i) {
+			const float angle = 6.2831853f * i / actorCount;
+			const sf::Vector2f direction(std::cos(angle), std::sin(angle));
+			EntityID entity = world.createEntity();
+			world.addComponent<Transform>(entity)->setPosition(direction * 500.f);
+			world.addComponent<PathFollower>(entity)->setPath({ direction * -100000.f });
+		}
+		if (loading) {
+			for (const std::string& path : paths) {
+				app.getTextureLoader().request(path);
+			}
+		}
+
+		worstStepMs = 0.0;
+		bool firstStep = true;
+		auto lastStep = std::chrono::steady_clock::now();
+		app.setStepCallback([&](float) {
+			const auto now = std::chrono::steady_clock::now();
+			if (!firstStep) {
+				worstStepMs = std::max(worstStepMs,
+					std::chrono::duration<double, std::milli>(now - lastStep).count());
+			}
+			firstStep = false;
+			lastStep = now;
+		});
+		app.run();
+
+		// Decodes still running after the last step were in flight the
+		// whole time
+		remainingMs = Benchmark::time([&]() {
+			app.getTextureLoader().waitForDecodes();
+		});
+		return app.getHeadlessSeconds() * 1000.0 / frames;
+	};
+
+	double idleWorstMs = 0.0;
+	double loadingWorstMs = 0.0;
+	double remainingMs = 0.0;
+	const double idleMs = runScene(false, idleWorstMs, remainingMs);
+	const double loadingMs = runScene(true, loadingWorstMs, remainingMs);
+
+	std::printf("%u job system threads\n", threads);
+	bench.report("no loads: frame time", idleMs, "ms");
+	bench.report("no loads: worst step", idleWorstMs, "ms");
+	bench.report("decoding: frame time", loadingMs, "ms");
+	bench.report("decoding: worst step", loadingWorstMs, "ms");
+	bench.report("decoding: left after the last step", remainingMs, "ms");
+}
+
+BENCHMARK(archive, "Startup with 2000 small images: loose files vs a mapped pack file, plain and LZ4") {
+	const size_t imageCount = 2000;
+
+	ScratchDirectory directory("mungo_bench_archive");
+	const std::vector<std::string> paths = writeImages(directory, imageCount, 32);
+	if (paths.empty()) {
+		return;
+	}
+
+	// Packed next to the images, with the image paths as entry names
+	const std::string plainPath = (directory.path / "plain.pak").generic_string();
+	const std::string compressedPath = (directory.path / "compressed.pak").generic_string();
+	AssetArchiveBuilder builder;
+	for (const std::string& path : paths) {
+		builder.addFile(path, path);
+	}
+	if (!builder.write(plainPath)) {
+		return;
+	}
+	builder.setCompression(true);
+	if (!builder.write(compressedPath)) {
+		return;
+	}
+
+	// Reading the bytes: one open/stat/read per loose file against one
+	// mapping and a lookup in the sorted table
+	size_t sum = 0;
+	std::vector<char> buffer;
+	const double looseReadMs = Benchmark::best(3, [&]() {
+		for (const std::string& path : paths) {
+			std::ifstream file(path, std::ios::binary);
+			buffer.resize(static_cast<size_t>(std::filesystem::file_size(path)));
+			file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			sum += checksum(buffer.data(), buffer.size());
+		}
+	});
+	auto readArchive = [&](const std::string& archivePath) {
+		return Benchmark::best(3, [&]() {
+			AssetArchive archive;
+			archive.open(archivePath);
+			for (const std::string& path : paths) {
+				const AssetBlob blob = archive.find(path);
+				sum += blob ? checksum(blob.data, blob.size) : 0;
+			}
+		});
+	};
+	const double plainReadMs = readArchive(plainPath);
+	const double compressedReadMs = readArchive(compressedPath);
+
+	// Full startup: the same bytes decoded into images
+	sf::Image image;
+	const double looseDecodeMs = Benchmark::best(3, [&]() {
+		for (const std::string& path : paths) {
+			sum += image.loadFromFile(path);
+		}
+	});
+	const double plainDecodeMs = Benchmark::best(3, [&]() {
+		AssetArchive archive;
+		archive.open(plainPath);
+		for (const std::string& path : paths) {
+			sum += archive.load(path, image);
+		}
+	});
+
+	bench.report("read: loose files", looseReadMs, "ms");
+	bench.report("read: pack file", plainReadMs, "ms");
+	bench.report("read: pack file, LZ4", compressedReadMs, "ms");
+	bench.report("read: speedup (pack vs loose)", looseReadMs / plainReadMs, "x");
+	bench.report("decode: loose files", looseDecodeMs, "ms");
+	bench.report("decode: pack file", plainDecodeMs, "ms");
+	bench.report("pack file size", std::filesystem::file_size(plainPath) / 1024.0, "KiB");
+	bench.report("LZ4 pack file size", std::filesystem::file_size(compressedPath) / 1024.0, "KiB");
+	s_sink = sum;
+}
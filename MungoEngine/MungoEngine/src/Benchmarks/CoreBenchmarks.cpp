@@ -0,0 +1,145 @@
+#include "Benchmark.h"
+#include "Utilities/CVector2.h"
+#include "Utilities/VectorBatch.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+namespace {
+	volatile float s_sink = 0.f;
+}
+
+BENCHMARK(simd, "VectorBatch normalize and seek vs a CVector2 loop, 64k (in cache) and 1M vectors") {
+	const int repetitions = 5;
+	const float step = 100.f / 60.f;
+	const float range = 10.f;
+	std::printf("VectorBatch backend: %s\n", EngineUtilities::VectorBatch::getBackendName());
+
+	for (size_t count : { size_t(1) << 16, size_t(1000000) }) {
+		const std::string prefix = count < 1000000 ? "64k " : "1M ";
+
+		std::mt19937 random(9);
+		std::uniform_real_distribution<float> coordinate(-1000.f, 1000.f);
+		std::vector<CVector2> vectors(count);
+		std::vector<CVector2> targets(count);
+		std::vector<float> x(count), y(count), targetX(count), targetY(count);
+		for (size_t i = 0; i < count; ++i) {
+			vectors[i] = CVector2(coordinate(random), coordinate(random));
+			targets[i] = CVector2(coordinate(random), coordinate(random));
+			x[i] = vectors[i].x;
+			y[i] = vectors[i].y;
+			targetX[i] = targets[i].x;
+			targetY[i] = targets[i].y;
+		}
+		std::vector<CVector2> normalized(count);
+		std::vector<float> normalizedX(count), normalizedY(count);
+
+		const double scalarNormalizeMs = Benchmark::best(repetitions, [&]() {
+			for (size_t i = 0; i < count; ++i) {
+				normalized[i] = vectors[i].normalized();
+			}
+		});
+		const double batchNormalizeMs = Benchmark::best(repetitions, [&]() {
+			EngineUtilities::VectorBatch::normalize(x.data(), y.data(),
+				normalizedX.data(), normalizedY.data(), count);
+		});
+
+		// Transform::seek written with CVector2; positions move every call, so
+		// each repetition seeks from where the last one stopped
+		std::vector<CVector2> positions = vectors;
+		std::vector<float> positionX = x, positionY = y;
+		const double scalarSeekMs = Benchmark::best(repetitions, [&]() {
+			for (size_t i = 0; i < count; ++i) {
+				const CVector2 direction = targets[i] - positions[i];
+				const float length = direction.length();
+				if (length > range) {
+					positions[i] += direction / length * step;
+				}
+			}
+		});
+		const double batchSeekMs = Benchmark::best(repetitions, [&]() {
+			EngineUtilities::VectorBatch::seek(positionX.data(), positionY.data(),
+				targetX.data(), targetY.data(), step, range, nullptr, count);
+		});
+
+		float maxError = 0.f;
+		for (size_t i = 0; i < count; ++i) {
+			maxError = std::max(maxError, std::abs(normalized[i].x - normalizedX[i]));
+			maxError = std::max(maxError, std::abs(positions[i].x - positionX[i]));
+		}
+
+		bench.report(prefix + "normalize: CVector2::normalized() loop", scalarNormalizeMs, "ms");
+		bench.report(prefix + "normalize: VectorBatch", batchNormalizeMs, "ms");
+		bench.report(prefix + "normalize: speedup", scalarNormalizeMs / batchNormalizeMs, "x");
+		bench.report(prefix + "seek: CVector2 loop", scalarSeekMs, "ms");
+		bench.report(prefix + "seek: VectorBatch", batchSeekMs, "ms");
+		bench.report(prefix + "seek: speedup", scalarSeekMs / batchSeekMs, "x");
+		bench.report(prefix + "largest difference from CVector2", maxError, "units");
+		s_sink = normalized[count / 2].x + positions[count / 2].y;
+	}
+}
+
+BENCHMARK(logging, "Caller-side latency of 1M LOG_INFO calls paced over one second, and a 1M-call burst") {
+	const size_t callCount = 1000000;
+	const size_t callsPerMillisecond = 1000;
+
+	// Messages go to a scratch file instead of the console
+	Logger& logger = Logger::getInstance();
+	const std::string logPath = (std::filesystem::temp_directory_path() / "mungo_bench.log").string();
+	logger.flush();
+	logger.setConsoleOutput(false);
+	if (!logger.setLogFile(logPath)) {
+		std::printf("Could not open %s\n", logPath.c_str());
+		logger.setConsoleOutput(true);
+		return;
+	}
+
+	// A thousand calls at the start of every millisecond, the rest of it
+	// left to the logger thread
+	std::vector<float> latencies(callCount);
+	const uint64_t droppedBefore = logger.getDroppedCount();
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < callCount; ++i) {
+		if (i % callsPerMillisecond == 0) {
+			std::this_thread::sleep_until(start + std::chrono::milliseconds(i / callsPerMillisecond));
+		}
+		const float x = i * 0.5f;
+		latencies[i] = static_cast<float>(Benchmark::time([&]() {
+			LOG_INFO("Benchmark", "logging", "Actor " << i << " at " << x << ", " << -x);
+		}) * 1e6);
+	}
+	const double pacedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	logger.flush();
+	const uint64_t pacedDrops = logger.getDroppedCount() - droppedBefore;
+
+	// Cost of reading the clock, included in every latency above
+	const double clockNs = Benchmark::time([&]() {
+		for (size_t i = 0; i < callsPerMillisecond; ++i) {
+			Benchmark::time([]() {});
+		}
+	}) * 1e6 / callsPerMillisecond;
+
+	const double burstMs = Benchmark::time([&]() {
+		for (size_t i = 0; i < callCount; ++i) {
+			LOG_INFO("Benchmark", "logging", "Burst " << i);
+		}
+	});
+	logger.flush();
+	const uint64_t burstDrops = logger.getDroppedCount() - droppedBefore - pacedDrops;
+
+	logger.setLogFile("");
+	logger.setConsoleOutput(true);
+	std::filesystem::remove(logPath);
+
+	std::sort(latencies.begin(), latencies.end());
+	bench.report("paced: duration", pacedSeconds, "s");
+	bench.report("paced: p50 latency", latencies[callCount / 2], "ns");
+	bench.report("paced: p99 latency", latencies[callCount * 99 / 100], "ns");
+	bench.report("paced: p99.9 latency", latencies[callCount * 999 / 1000], "ns");
+	bench.report("paced: max latency", latencies.back(), "ns");
+	bench.report("paced: dropped", double(pacedDrops), "messages");
+	bench.report("clock overhead per measurement", clockNs, "ns");
+	bench.report("burst: calls per second", callCount / (burstMs / 1000.0) / 1e6, "M calls/s");
+	bench.report("burst: dropped", double(burstDrops), "messages");
+}
@@ -0,0 +1,152 @@
+#include "Benchmark.h"
+#include "ESC/World.h"
+#include "ESC/Transform.h"
+#include "ESC/Collider.h"
+#include "ESC/PathFollower.h"
+#include "TransformHierarchy.h"
+
+namespace {
+	/**
+	 * @brief Results land here so the compiler cannot drop the timed work.
+	 */
+	volatile size_t s_sink = 0;
+
+	/**
+	 * @brief The per-entity component vector that World replaced, with the
+	 * dynamic_cast scan of the old Entity::getComponent<T>().
+	 */
+	struct
+		LegacyEntity {
+		std::vector<EngineUtilities::TSharedPointer<Component>> components;
+
+		template<typename T>
+		EngineUtilities::TSharedPointer<T>
+			getComponent() {
+			for (auto& component : components) {
+				EngineUtilities::TSharedPointer<T> specific = component.template dynamic_pointer_cast<T>();
+				if (specific) {
+					return specific;
+				}
+			}
+			return EngineUtilities::TSharedPointer<T>();
+		}
+	};
+}
+
+BENCHMARK(components, "getComponent<T>: World slot tables vs the old dynamic_cast scan, 10k entities") {
+	const size_t entityCount = 10000;
+	const int passes = 100;
+
+	World world;
+	std::vector<EntityID> entities;
+	std::vector<LegacyEntity> legacy(entityCount);
+	for (size_t i = 0; i < entityCount; ++i) {
+		EntityID entity = world.createEntity();
+		world.addComponent<Transform>(entity);
+		world.addComponent<Collider>(entity);
+		world.addComponent<PathFollower>(entity);
+		entities.push_back(entity);
+
+		legacy[i].components.push_back(EngineUtilities::MakeShared<Transform>());
+		legacy[i].components.push_back(EngineUtilities::MakeShared<Collider>());
+		legacy[i].components.push_back(EngineUtilities::MakeShared<PathFollower>());
+	}
+
+	// Three lookups per entity per pass, as an update touching three
+	// components would do
+	size_t found = 0;
+	const double worldMs = Benchmark::best(3, [&]() {
+		for (int pass = 0; pass < passes; ++pass) {
+			for (EntityID entity : entities) {
+				found += world.getComponent<Transform>(entity) != nullptr;
+				found += world.getComponent<Collider>(entity) != nullptr;
+				found += world.getComponent<PathFollower>(entity) != nullptr;
+			}
+		}
+	});
+	const double legacyMs = Benchmark::best(3, [&]() {
+		for (int pass = 0; pass < passes; ++pass) {
+			for (LegacyEntity& entity : legacy) {
+				found += !entity.getComponent<Transform>().isNull();
+				found += !entity.getComponent<Collider>().isNull();
+				found += !entity.getComponent<PathFollower>().isNull();
+			}
+		}
+	});
+
+	const double lookups = static_cast<double>(entityCount) * passes * 3;
+	bench.report("World::getComponent", worldMs * 1e6 / lookups, "ns/lookup");
+	bench.report("dynamic_cast scan (old Entity)", legacyMs * 1e6 / lookups, "ns/lookup");
+	bench.report("speedup", legacyMs / worldMs, "x");
+	s_sink = found;
+}
+
+BENCHMARK(hierarchy, "TransformHierarchy::update on a 1000-level chain and a 100k-child fan") {
+	const int iterations = 100;
+
+	// Times update() with nothing moved, with the root moved (every world
+	// matrix recomputed) and with one leaf moved
+	auto measure = [&](const std::string& shape, World& world, TransformHierarchy& hierarchy,
+		EntityID root, EntityID leaf) {
+		// Settle: no transform interpolating, every version recorded
+		world.forEach<Transform>([](Transform& transform) { transform.savePreviousState(); });
+		const double firstMs = Benchmark::time([&]() { hierarchy.update(world); });
+
+		const double cleanMs = Benchmark::time([&]() {
+			for (int i = 0; i < iterations; ++i) {
+				hierarchy.update(world);
+			}
+		});
+
+		auto moveAndUpdate = [&](EntityID entity) {
+			Transform* transform = world.getComponent<Transform>(entity);
+			for (int i = 0; i < iterations; ++i) {
+				transform->savePreviousState();
+				transform->setPosition(sf::Vector2f(float(i), 0.f));
+				hierarchy.update(world);
+			}
+			transform->savePreviousState();
+			hierarchy.update(world);
+		};
+		const double rootMs = Benchmark::time([&]() { moveAndUpdate(root); });
+		const double leafMs = Benchmark::time([&]() { moveAndUpdate(leaf); });
+
+		bench.report(shape + ": first update (sort + all)", firstMs, "ms");
+		bench.report(shape + ": nothing moved", cleanMs / iterations, "ms");
+		bench.report(shape + ": root moved", rootMs / (iterations + 1), "ms");
+		bench.report(shape + ": one leaf moved", leafMs / (iterations + 1), "ms");
+	};
+
+	{
+		World world;
+		TransformHierarchy hierarchy;
+		EntityID parent = INVALID_ENTITY;
+		EntityID root = INVALID_ENTITY;
+		for (int depth = 0; depth < 1000; ++depth) {
+			EntityID entity = world.createEntity();
+			world.addComponent<Transform>(entity)->setPosition(sf::Vector2f(1.f, 0.f));
+			if (parent == INVALID_ENTITY) {
+				root = entity;
+			}
+			else {
+				hierarchy.setParent(entity, parent);
+			}
+			parent = entity;
+		}
+		measure("deep", world, hierarchy, root, parent);
+	}
+
+	{
+		World world;
+		TransformHierarchy hierarchy;
+		EntityID root = world.createEntity();
+		world.addComponent<Transform>(root);
+		EntityID child = INVALID_ENTITY;
+		for (int i = 0; i < 100000; ++i) {
+			child = world.createEntity();
+			world.addComponent<Transform>(child)->setPosition(sf::Vector2f(float(i % 100), float(i / 100)));
+			hierarchy.setParent(child, root);
+		}
+		measure("wide", world, hierarchy, root, child);
+	}
+}
@@ -0,0 +1,273 @@
+#include "Benchmark.h"
+#include "ESC/Transform.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+/**
+ * Global operator new/delete replaced so the memory benchmarks can count heap
+ * allocations. The counter is a relaxed atomic increment, cheap enough to
+ * leave in the engine build.
+ */
+namespace {
+	std::atomic<size_t> s_allocationCount{ 0 };
+}
+
+void*
+operator new(std::size_t size) {
+	s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size ? size : 1)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void
+operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void
+operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+namespace {
+	volatile size_t s_sink = 0;
+
+	size_t
+		allocationCount() {
+		return s_allocationCount.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Object that counts its live instances and poisons itself when
+	 * destroyed, so a use after free or a double destroy shows up.
+	 */
+	struct
+		Tracked {
+		static std::atomic<int> s_live;
+		int value;
+
+		explicit
+			Tracked(int value) : value(value) { s_live.fetch_add(1, std::memory_order_relaxed); }
+		~Tracked() {
+			value = -1;
+			s_live.fetch_sub(1, std::memory_order_relaxed);
+		}
+	};
+
+	std::atomic<int> Tracked::s_live{ 0 };
+
+	/**
+	 * @brief Weak pointer with the counting policy of @p shared.
+	 */
+	template<typename T, typename Policy>
+	EngineUtilities::TWeakPointer<T, Policy>
+		makeWeak(const EngineUtilities::TSharedPointer<T, Policy>& shared) {
+		return EngineUtilities::TWeakPointer<T, Policy>(shared);
+	}
+}
+
+BENCHMARK(shared, "MakeShared (one allocation) vs TSharedPointer(new T) (two), 100k Transforms") {
+	const size_t objectCount = 100000;
+	std::vector<EngineUtilities::TSharedPointer<Transform>> objects;
+	objects.reserve(objectCount);
+
+	size_t before = allocationCount();
+	const double makeSharedMs = Benchmark::time([&]() {
+		for (size_t i = 0; i < objectCount; ++i) {
+			objects.push_back(EngineUtilities::MakeShared<Transform>());
+		}
+		objects.clear();
+	});
+	const size_t makeSharedAllocations = allocationCount() - before;
+
+	before = allocationCount();
+	const double rawMs = Benchmark::time([&]() {
+		for (size_t i = 0; i < objectCount; ++i) {
+			objects.push_back(EngineUtilities::TSharedPointer<Transform>(new Transform()));
+		}
+		objects.clear();
+	});
+	const size_t rawAllocations = allocationCount() - before;
+
+	bench.report("MakeShared allocations per object", double(makeSharedAllocations) / objectCount, "allocs");
+	bench.report("TSharedPointer(new T) allocations per object", double(rawAllocations) / objectCount, "allocs");
+	bench.report("MakeShared create + release", makeSharedMs * 1e6 / objectCount, "ns/object");
+	bench.report("TSharedPointer(new T) create + release", rawMs * 1e6 / objectCount, "ns/object");
+	s_sink = objects.capacity();
+}
+
+BENCHMARK(weaklock, "TWeakPointer::lock() on a live and an expired object, single-thread and atomic counts") {
+	const size_t lockCount = 10000000;
+
+	// Each lock is released right away, as a caller checking on its target
+	// every frame does; the object is then destroyed and locked again
+	auto measure = [&](auto object, const std::string& prefix) {
+		auto observer = makeWeak(object);
+		size_t alive = 0;
+		const double liveMs = Benchmark::best(3, [&]() {
+			for (size_t i = 0; i < lockCount; ++i) {
+				alive += static_cast<bool>(observer.lock());
+			}
+		});
+		object.reset();
+		const double expiredMs = Benchmark::best(3, [&]() {
+			for (size_t i = 0; i < lockCount; ++i) {
+				alive += static_cast<bool>(observer.lock());
+			}
+		});
+		bench.report(prefix + "lock() on a live object", liveMs * 1e6 / lockCount, "ns/lock");
+		bench.report(prefix + "lock() on an expired object", expiredMs * 1e6 / lockCount, "ns/lock");
+		s_sink = alive;
+	};
+	measure(EngineUtilities::MakeShared<Transform>(), "single-thread: ");
+	measure(EngineUtilities::MakeAtomicShared<Transform>(), "atomic: ");
+}
+
+BENCHMARK(pool, "Spawn/despawn churn at 100k objects/s, 10 s at 60 fps: heap vs TSharedPool") {
+	const int framesPerSecond = 60;
+	const int frameCount = 10 * framesPerSecond;
+	const int spawnsPerFrame = 100000 / framesPerSecond;
+	const int maxLifetimeFrames = 2 * framesPerSecond;
+
+	// Objects despawn when the frame reaches their bucket, after a random
+	// lifetime of up to two seconds, so frees come in a shuffled order
+	auto churn = [&](auto&& spawn, double& worstFrameMs, size_t& allocations) {
+		std::vector<std::vector<EngineUtilities::TSharedPointer<Transform>>> buckets(maxLifetimeFrames);
+		std::mt19937 random(1234);
+		std::uniform_int_distribution<int> lifetime(1, maxLifetimeFrames - 1);
+		worstFrameMs = 0.0;
+		const size_t before = allocationCount();
+		const double totalMs = Benchmark::time([&]() {
+			for (int frame = 0; frame < frameCount; ++frame) {
+				const double frameMs = Benchmark::time([&]() {
+					buckets[frame % maxLifetimeFrames].clear();
+					for (int i = 0; i < spawnsPerFrame; ++i) {
+						buckets[(frame + lifetime(random)) % maxLifetimeFrames].push_back(spawn());
+					}
+				});
+				worstFrameMs = std::max(worstFrameMs, frameMs);
+			}
+		});
+		allocations = allocationCount() - before;
+		return totalMs;
+	};
+
+	double heapWorstMs = 0.0;
+	double poolWorstMs = 0.0;
+	size_t heapAllocations = 0;
+	size_t poolAllocations = 0;
+	const double heapMs = churn([]() { return EngineUtilities::MakeShared<Transform>(); },
+		heapWorstMs, heapAllocations);
+
+	EngineUtilities::TSharedPool<Transform> transformPool(1024);
+	const double poolMs = churn([&]() { return EngineUtilities::MakeShared(transformPool); },
+		poolWorstMs, poolAllocations);
+
+	const double spawned = double(frameCount) * spawnsPerFrame;
+	bench.report("heap: spawn + despawn", heapMs * 1e6 / spawned, "ns/object");
+	bench.report("heap: worst frame", heapWorstMs, "ms");
+	bench.report("heap: allocations per object", heapAllocations / spawned, "allocs");
+	bench.report("pool: spawn + despawn", poolMs * 1e6 / spawned, "ns/object");
+	bench.report("pool: worst frame", poolWorstMs, "ms");
+	bench.report("pool: allocations per object", poolAllocations / spawned, "allocs");
+	bench.report("pool: slots reserved", double(transformPool.getCapacity()), "slots");
+	s_sink = transformPool.getUsedCount();
+}
+
+BENCHMARK(sharedthreads, "Stress test: 8 threads copy, move, reset and lock the same TAtomicSharedPointer (run under TSan)") {
+	const unsigned int threadCount = 8;
+	const int roundCount = 2000;
+	const int stepsPerRound = 200;
+
+	// Every round, each thread starts with its own strong and weak copy of
+	// a new object; the main thread lets go of it before the round starts,
+	// so the last release and the destruction race with the locks
+	std::vector<EngineUtilities::TAtomicSharedPointer<Tracked>> strong(threadCount);
+	std::vector<EngineUtilities::TAtomicWeakPointer<Tracked>> weak(threadCount);
+	std::atomic<int> startedRound{ -1 };
+	std::atomic<unsigned int> finishedThreads{ 0 };
+	std::atomic<size_t> badValues{ 0 };
+	std::atomic<size_t> lockedCount{ 0 };
+
+	auto worker = [&](unsigned int index) {
+		for (int round = 0; round < roundCount; ++round) {
+			while (startedRound.load(std::memory_order_acquire) < round) {
+				std::this_thread::yield();
+			}
+
+			EngineUtilities::TAtomicSharedPointer<Tracked> mine = std::move(strong[index]);
+			EngineUtilities::TAtomicWeakPointer<Tracked> observer = weak[index];
+			size_t bad = 0;
+			size_t locked = 0;
+			for (int step = 0; step < stepsPerRound; ++step) {
+				EngineUtilities::TAtomicSharedPointer<Tracked> copy = mine;
+				EngineUtilities::TAtomicSharedPointer<Tracked> moved = std::move(copy);
+				EngineUtilities::TAtomicWeakPointer<Tracked> weakCopy = observer;
+				moved.reset();
+
+				// Threads drop their reference at different steps, so the
+				// object dies while the others are still locking it
+				if (step == stepsPerRound / 2 + static_cast<int>(index) * 8) {
+					mine.reset();
+				}
+				EngineUtilities::TAtomicSharedPointer<Tracked> lockedCopy = weakCopy.lock();
+				if (lockedCopy) {
+					++locked;
+					bad += lockedCopy->value != round;
+				}
+			}
+			mine.reset();
+			badValues.fetch_add(bad, std::memory_order_relaxed);
+			lockedCount.fetch_add(locked, std::memory_order_relaxed);
+			finishedThreads.fetch_add(1, std::memory_order_acq_rel);
+		}
+	};
+
+	size_t leakedRounds = 0;
+	size_t unexpiredRounds = 0;
+	std::vector<std::thread> threads;
+	const double totalMs = Benchmark::time([&]() {
+		for (unsigned int i = 0; i < threadCount; ++i) {
+			threads.emplace_back(worker, i);
+		}
+		for (int round = 0; round < roundCount; ++round) {
+			{
+				EngineUtilities::TAtomicSharedPointer<Tracked> object =
+					EngineUtilities::MakeAtomicShared<Tracked>(round);
+				for (unsigned int i = 0; i < threadCount; ++i) {
+					strong[i] = object;
+					weak[i] = object;
+				}
+			}
+			startedRound.store(round, std::memory_order_release);
+			while (finishedThreads.load(std::memory_order_acquire) < threadCount * (round + 1)) {
+				std::this_thread::yield();
+			}
+
+			// Every strong reference is gone: the object must be too
+			leakedRounds += Tracked::s_live.load(std::memory_order_relaxed) != 0;
+			for (unsigned int i = 0; i < threadCount; ++i) {
+				unexpiredRounds += !weak[i].expired();
+				weak[i].reset();
+			}
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+	});
+
+	// Copy, move, weak copy, reset and lock per step
+	const double operations = 5.0 * threadCount * roundCount * stepsPerRound;
+	bench.report("reference count operations", operations / (totalMs / 1000.0) / 1e6, "M ops/s");
+	bench.report("successful locks", double(lockedCount.load()), "locks");
+	bench.report("locks that saw a wrong value", double(badValues.load()), "locks");
+	bench.report("rounds with an object still alive", double(leakedRounds), "rounds");
+	bench.report("weak pointers not expired at round end", double(unexpiredRounds), "pointers");
+	if (badValues.load() != 0 || leakedRounds != 0 || unexpiredRounds != 0) {
+		std::printf("FAILED: TAtomicSharedPointer lost or reused a reference\n");
+	}
+}
@@ -0,0 +1,347 @@
+#include "Benchmark.h"
+#include "RenderBatcher.h"
+#include "LooseQuadtree.h"
+#include "TextureAtlas.h"
+#include "JobSystem.h"
+#include "ESC/ParticleEmitter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace {
+	const unsigned int s_targetWidth = 1920;
+	const unsigned int s_targetHeight = 1080;
+
+	/**
+	 * @brief Offscreen target the size of the default window; false (and a
+	 * message) if the machine has no GL context to render with.
+	 */
+	bool
+		createTarget(sf::RenderTexture& target) {
+		if (!target.create(s_targetWidth, s_targetHeight)) {
+			std::printf("Could not create a %ux%u render texture\n", s_targetWidth, s_targetHeight);
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Circles, rectangles and triangles scattered over an area
+	 * starting at the origin.
+	 */
+	struct
+		ShapeSet {
+		std::vector<sf::CircleShape> circles;
+		std::vector<sf::RectangleShape> rectangles;
+		std::vector<sf::ConvexShape> triangles;
+		std::vector<const sf::Shape*> drawOrder;
+
+		explicit
+			ShapeSet(size_t count, const sf::Vector2f& area) {
+			std::mt19937 random(42);
+			std::uniform_real_distribution<float> x(0.f, area.x);
+			std::uniform_real_distribution<float> y(0.f, area.y);
+			std::uniform_int_distribution<int> channel(0, 255);
+			circles.reserve(count / 3 + 1);
+			rectangles.reserve(count / 3 + 1);
+			triangles.reserve(count / 3 + 1);
+
+			for (size_t i = 0; i < count; ++i) {
+				sf::Shape* shape = nullptr;
+				switch (i % 3) {
+				case 0:
+					circles.emplace_back(4.f, 12);
+					shape = &circles.back();
+					break;
+				case 1:
+					rectangles.emplace_back(sf::Vector2f(8.f, 6.f));
+					shape = &rectangles.back();
+					break;
+				default:
+					triangles.emplace_back(3);
+					triangles.back().setPoint(0, sf::Vector2f(0.f, 0.f));
+					triangles.back().setPoint(1, sf::Vector2f(8.f, 0.f));
+					triangles.back().setPoint(2, sf::Vector2f(4.f, 7.f));
+					shape = &triangles.back();
+					break;
+				}
+				shape->setPosition(x(random), y(random));
+				shape->setFillColor(sf::Color(channel(random), channel(random), channel(random)));
+				drawOrder.push_back(shape);
+			}
+		}
+	};
+}
+
+BENCHMARK(batcher, "50k shapes to a 1920x1080 render texture: one draw per shape vs RenderBatcher") {
+	const size_t shapeCount = 50000;
+	const int frames = 20;
+
+	sf::RenderTexture target;
+	if (!createTarget(target)) {
+		return;
+	}
+	ShapeSet shapes(shapeCount, sf::Vector2f(float(s_targetWidth), float(s_targetHeight)));
+
+	// CPU time of a frame; display() flushes the commands to the driver
+	const double directMs = Benchmark::time([&]() {
+		for (int frame = 0; frame < frames; ++frame) {
+			target.clear();
+			for (const sf::Shape* shape : shapes.drawOrder) {
+				target.draw(*shape);
+			}
+			target.display();
+		}
+	});
+
+	RenderBatcher batcher;
+	const double batchedMs = Benchmark::time([&]() {
+		for (int frame = 0; frame < frames; ++frame) {
+			target.clear();
+			for (const sf::Shape* shape : shapes.drawOrder) {
+				batcher.submit(*shape);
+			}
+			batcher.flush(target);
+			target.display();
+		}
+	});
+
+	bench.report("direct: draw calls per frame", double(shapeCount), "calls");
+	bench.report("direct: frame time", directMs / frames, "ms");
+	bench.report("RenderBatcher: draw calls per frame", double(batcher.getDrawCallCount()) / frames, "calls");
+	bench.report("RenderBatcher: frame time", batchedMs / frames, "ms");
+	bench.report("speedup", directMs / batchedMs, "x");
+}
+
+BENCHMARK(culling, "50k shapes over 10x the screen area: draw all vs LooseQuadtree view culling, and picking") {
+	const size_t shapeCount = 50000;
+	const int frames = 20;
+	const int pickCount = 10000;
+
+	sf::RenderTexture target;
+	if (!createTarget(target)) {
+		return;
+	}
+
+	// World of ten screens, viewed through one screen at its center
+	const float side = std::sqrt(10.f);
+	const sf::Vector2f worldSize(s_targetWidth * side, s_targetHeight * side);
+	ShapeSet shapes(shapeCount, worldSize);
+	sf::View view(worldSize / 2.f, sf::Vector2f(float(s_targetWidth), float(s_targetHeight)));
+	target.setView(view);
+	const sf::FloatRect viewBounds(view.getCenter() - view.getSize() / 2.f, view.getSize());
+
+	LooseQuadtree tree(sf::FloatRect(0.f, 0.f, worldSize.x, worldSize.y));
+	for (size_t i = 0; i < shapeCount; ++i) {
+		tree.update(static_cast<EntityID>(i), shapes.drawOrder[i]->getGlobalBounds());
+	}
+
+	RenderBatcher batcher;
+	const double allMs = Benchmark::time([&]() {
+		for (int frame = 0; frame < frames; ++frame) {
+			target.clear();
+			for (const sf::Shape* shape : shapes.drawOrder) {
+				batcher.submit(*shape);
+			}
+			batcher.flush(target);
+			target.display();
+		}
+	});
+
+	// Same steps as BaseApp::render: query the view, keep entity order
+	std::vector<EntityID> visible;
+	const double culledMs = Benchmark::time([&]() {
+		for (int frame = 0; frame < frames; ++frame) {
+			visible.clear();
+			tree.query(viewBounds, visible);
+			std::sort(visible.begin(), visible.end());
+			target.clear();
+			for (EntityID entity : visible) {
+				batcher.submit(*shapes.drawOrder[entity]);
+			}
+			batcher.flush(target);
+			target.display();
+		}
+	});
+
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> x(0.f, worldSize.x);
+	std::uniform_real_distribution<float> y(0.f, worldSize.y);
+	std::vector<sf::Vector2f> points(pickCount);
+	for (sf::Vector2f& point : points) {
+		point = sf::Vector2f(x(random), y(random));
+	}
+
+	size_t treeHits = 0;
+	const double treePickMs = Benchmark::time([&]() {
+		EntityID entity = INVALID_ENTITY;
+		for (const sf::Vector2f& point : points) {
+			treeHits += tree.pick(point, entity);
+		}
+	});
+
+	// Topmost is the last one drawn, so scan from the back
+	size_t scanHits = 0;
+	const double scanPickMs = Benchmark::time([&]() {
+		for (const sf::Vector2f& point : points) {
+			for (size_t i = shapeCount; i-- > 0;) {
+				if (shapes.drawOrder[i]->getGlobalBounds().contains(point)) {
+					++scanHits;
+					break;
+				}
+			}
+		}
+	});
+
+	if (treeHits != scanHits) {
+		std::printf("quadtree and linear picking disagree (%zu vs %zu hits)\n", treeHits, scanHits);
+	}
+	bench.report("shapes in view", double(visible.size()), "shapes");
+	bench.report("draw all: frame time", allMs / frames, "ms");
+	bench.report("culled: frame time", culledMs / frames, "ms");
+	bench.report("speedup", allMs / culledMs, "x");
+	bench.report("pick: quadtree", treePickMs * 1e6 / pickCount, "ns/pick");
+	bench.report("pick: linear scan", scanPickMs * 1e6 / pickCount, "ns/pick");
+}
+
+BENCHMARK(atlas, "Texture binds per frame for 1000 sprites over 32 images: one texture each vs a TextureAtlas") {
+	const size_t spriteCount = 1000;
+	const size_t imageCount = 32;
+	const int frames = 100;
+
+	sf::RenderTexture target;
+	if (!createTarget(target)) {
+		return;
+	}
+
+	// Each image gets its own Texture and a region in the atlas
+	TextureAtlas atlas(512);
+	std::vector<EngineUtilities::TSharedPointer<Texture>> textures;
+	for (size_t i = 0; i < imageCount; ++i) {
+		sf::Image image;
+		image.create(32, 32, sf::Color(static_cast<sf::Uint8>(i * 8), 128, static_cast<sf::Uint8>(255 - i * 8)));
+		textures.push_back(EngineUtilities::MakeShared<Texture>());
+		textures.back()->loadFromImage(image);
+		atlas.addImage("sprite" + std::to_string(i), image);
+	}
+	if (!atlas.build()) {
+		std::printf("Could not build the atlas\n");
+		return;
+	}
+
+	// Sprites in entity order cycle through the images, as a scene would;
+	// the textures are bound like CShape::setTexture() does
+	std::mt19937 random(8);
+	std::uniform_real_distribution<float> x(0.f, float(s_targetWidth));
+	std::uniform_real_distribution<float> y(0.f, float(s_targetHeight));
+	std::vector<sf::RectangleShape> separate(spriteCount, sf::RectangleShape(sf::Vector2f(32.f, 32.f)));
+	std::vector<sf::RectangleShape> atlased(spriteCount, sf::RectangleShape(sf::Vector2f(32.f, 32.f)));
+	for (size_t i = 0; i < spriteCount; ++i) {
+		const sf::Vector2f position(x(random), y(random));
+		separate[i].setPosition(position);
+		separate[i].setTexture(&textures[i % imageCount]->getTexture(), true);
+
+		const AtlasRegion* region = atlas.findRegion("sprite" + std::to_string(i % imageCount));
+		atlased[i].setPosition(position);
+		atlased[i].setTexture(&region->texture->getTexture());
+		atlased[i].setTextureRect(region->rect);
+	}
+
+	auto measure = [&](const std::string& label, const std::vector<sf::RectangleShape>& sprites) {
+		// Statistics restart every frame, as in Window::clear()
+		RenderBatcher batcher;
+		unsigned int binds = 0;
+		unsigned int drawCalls = 0;
+		const double ms = Benchmark::time([&]() {
+			for (int frame = 0; frame < frames; ++frame) {
+				target.clear();
+				batcher.resetStats();
+				for (const sf::RectangleShape& sprite : sprites) {
+					batcher.submit(sprite);
+				}
+				batcher.flush(target);
+				target.display();
+				binds += batcher.getTextureBindCount();
+				drawCalls += batcher.getDrawCallCount();
+			}
+		});
+		bench.report(label + ": texture binds per frame", double(binds) / frames, "binds");
+		bench.report(label + ": draw calls per frame", double(drawCalls) / frames, "calls");
+		bench.report(label + ": frame time", ms / frames, "ms");
+	};
+
+	measure("one texture per image", separate);
+	measure("atlas (" + std::to_string(atlas.getPageCount()) + " page)", atlased);
+}
+
+BENCHMARK(particles, "1M particles: update, vertex fill on one thread and on the JobSystem, and drawing") {
+	const size_t particleCount = 1000000;
+	const float step = 1.f / 60.f;
+	const int frames = 120;
+
+	// Lifetimes of 2-3 s with 400k births per second keep about 1M alive
+	// once the first four seconds have been simulated
+	ParticleEmitter emitter;
+	emitter.setMaxParticles(particleCount);
+	emitter.setLifetime(2.f, 3.f);
+	emitter.setEmissionRate(particleCount / 2.5f);
+	emitter.setDirection(-90.f, 360.f);
+	emitter.setSpeed(20.f, 200.f);
+	emitter.setAcceleration(sf::Vector2f(0.f, 50.f));
+	emitter.setSize(4.f, 1.f);
+	emitter.setColor(sf::Color(255, 200, 50), sf::Color(255, 50, 0, 0));
+	emitter.setPosition(sf::Vector2f(s_targetWidth / 2.f, s_targetHeight / 2.f));
+	for (int i = 0; i < 4 * 60; ++i) {
+		emitter.update(step);
+	}
+
+	JobSystem jobs;
+	size_t particles = 0;
+	const double updateMs = Benchmark::time([&]() {
+		for (int frame = 0; frame < frames; ++frame) {
+			emitter.update(step);
+			particles += emitter.getParticleCount();
+		}
+	});
+	const double fillMs = Benchmark::best(frames, [&]() { emitter.buildVertices(); });
+	const double jobsFillMs = Benchmark::best(frames, [&]() { emitter.buildVertices(&jobs); });
+
+	// A color that does not fade is written once per particle, like the
+	// texture coordinates
+	emitter.setColor(sf::Color(255, 200, 50), sf::Color(255, 200, 50));
+	emitter.buildVertices(&jobs);
+	const double constantColorFillMs = Benchmark::best(frames, [&]() { emitter.buildVertices(&jobs); });
+
+	const double averageParticles = double(particles) / frames;
+	const double frameMs = updateMs / frames + std::min(fillMs, jobsFillMs);
+	bench.report("live particles (average)", averageParticles, "particles");
+	bench.report("update", updateMs / frames, "ms");
+	bench.report("vertex fill, one thread", fillMs, "ms");
+	bench.report("vertex fill, " + std::to_string(jobs.getThreadCount()) + " threads", jobsFillMs, "ms");
+	bench.report("vertex fill, constant color", constantColorFillMs, "ms");
+	bench.report("update + fill", frameMs, "ms");
+	bench.report("particles in a 60 FPS frame (update + fill)", averageParticles * (1000.0 / 60.0) / frameMs, "particles");
+
+	// Drawing runs on whatever OpenGL the machine has: run with a software
+	// implementation (e.g. Mesa llvmpipe, LIBGL_ALWAYS_SOFTWARE=1) to
+	// measure the fallback
+	sf::RenderTexture target;
+	if (!createTarget(target)) {
+		return;
+	}
+	sf::RenderStates states;
+	states.texture = emitter.getDrawTexture();
+	const double drawMs = Benchmark::time([&]() {
+		for (int frame = 0; frame < frames; ++frame) {
+			target.clear();
+			target.draw(emitter.getVertices(), states);
+			target.display();
+		}
+	});
+	// Reading the texture back waits for the GPU to finish the queued
+	// frames; the read itself is spread over all of them
+	const double finishMs = Benchmark::time([&]() { target.getTexture().copyToImage(); });
+	bench.report("draw (CPU side)", drawMs / frames, "ms");
+	bench.report("draw (including GPU, amortized)", (drawMs + finishMs) / frames, "ms");
+}
@@ -0,0 +1,186 @@
+#include "Benchmark.h"
+#include "BaseApp.h"
+#include <cmath>
+#include <random>
+
+BENCHMARK(jobs, "Headless frames with 100k seeking actors at 1, 2, 4, 8 and 16 threads") {
+	const size_t actorCount = 100000;
+	const uint64_t frames = 300;
+
+	double singleThreadMs = 0.0;
+	for (unsigned int threads : { 1u, 2u, 4u, 8u, 16u }) {
+		BaseApp app(HEADLESS, threads);
+		app.setHeadlessFrameCount(frames);
+
+		// Actors on a ring seek the opposite side, far enough to keep
+		// moving for the whole run
+		World& world = app.getWorld();
+		for (size_t i = 0; i < actorCount; ++i) {
+			const float angle = 6.2831853f * i / actorCount;
+			const sf::Vector2f direction(std::cos(angle), std::sin(angle));
+			EntityID entity = world.createEntity();
+			world.addComponent<Transform>(entity)->setPosition(direction * 500.f);
+			world.addComponent<PathFollower>(entity)->setPath({ direction * -100000.f });
+		}
+
+		app.run();
+		const double frameMs = app.getHeadlessSeconds() * 1000.0 / frames;
+		if (threads == 1) {
+			singleThreadMs = frameMs;
+		}
+		bench.report(std::to_string(threads) + " threads: frame time", frameMs, "ms");
+		bench.report(std::to_string(threads) + " threads: speedup", singleThreadMs / frameMs, "x");
+	}
+}
+
+BENCHMARK(collisions, "Headless frames with 20k moving colliders (circles, boxes, triangles) vs the same movers without") {
+	const size_t colliderCount = 20000;
+	const uint64_t frames = 300;
+	const float areaSize = 5000.f;
+
+	// Runs the same scene with and without Collider components; the
+	// difference is the cost of the collision step
+	auto runScene = [&](bool withColliders, size_t& contacts, size_t& pairs) {
+		BaseApp app(HEADLESS);
+		app.setHeadlessFrameCount(frames);
+		World& world = app.getWorld();
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> coordinate(0.f, areaSize);
+		for (size_t i = 0; i < colliderCount; ++i) {
+			EntityID entity = world.createEntity();
+			world.addComponent<Transform>(entity)->setPosition(
+				sf::Vector2f(coordinate(random), coordinate(random)));
+			world.addComponent<PathFollower>(entity)->setPath({
+				sf::Vector2f(coordinate(random), coordinate(random)),
+				sf::Vector2f(coordinate(random), coordinate(random)) });
+			if (!withColliders) {
+				continue;
+			}
+			Collider* collider = world.addComponent<Collider>(entity);
+			switch (i % 3) {
+			case 0:
+				collider->setCircle(6.f);
+				break;
+			case 1:
+				collider->setBox(sf::Vector2f(12.f, 12.f));
+				break;
+			default:
+				collider->setPolygon({ sf::Vector2f(0.f, 0.f), sf::Vector2f(12.f, 0.f), sf::Vector2f(6.f, 10.f) });
+				break;
+			}
+		}
+
+		contacts = 0;
+		pairs = 0;
+		CollisionSystem& collisions = app.getCollisionSystem();
+		collisions.addListener([&](const std::vector<Contact>& stepContacts) {
+			contacts += stepContacts.size();
+			pairs += collisions.getBroadPhasePairCount();
+		});
+		app.run();
+		return app.getHeadlessSeconds() * 1000.0 / frames;
+	};
+
+	size_t contacts = 0;
+	size_t pairs = 0;
+	const double moversMs = runScene(false, contacts, pairs);
+	const double collidersMs = runScene(true, contacts, pairs);
+
+	bench.report("movers only: frame time", moversMs, "ms");
+	bench.report("with colliders: frame time", collidersMs, "ms");
+	bench.report("collision step", collidersMs - moversMs, "ms");
+	bench.report("collision throughput", colliderCount / ((collidersMs - moversMs) / 1000.0) / 1e6, "M colliders/s");
+	bench.report("broad-phase pairs per step", double(pairs) / frames, "pairs");
+	bench.report("contacts per step", double(contacts) / frames, "contacts");
+}
+
+BENCHMARK(pathfinding, "Headless frames with 1000 agents repathing per second on a 1024x1024 grid, JPS and A*") {
+	const size_t agentCount = 1000;
+	const float repathsPerSecond = 1000.f;
+	const uint64_t frames = 600;
+	const int gridSize = 1024;
+	const float cellSize = 16.f;
+
+	for (PathAlgorithm algorithm : { PATH_JUMP_POINT, PATH_ASTAR }) {
+		const std::string name = algorithm == PATH_JUMP_POINT ? "JPS" : "A*";
+		BaseApp app(HEADLESS);
+		app.setHeadlessFrameCount(frames);
+
+		// About a tenth of the cells blocked by walls and square blocks, short
+		// enough that nearly all open cells stay reachable from each other
+		NavigationGrid& grid = app.getNavigationGrid();
+		grid.resize(gridSize, gridSize, cellSize);
+		std::mt19937 random(21);
+		std::uniform_int_distribution<int> cell(0, gridSize - 1);
+		std::uniform_int_distribution<int> extent(1, 20);
+		for (int i = 0; i < 1200; ++i) {
+			sf::Vector2f size;
+			switch (i % 3) {
+			case 0:
+				size = sf::Vector2f(1.f, extent(random) * 4.f);
+				break;
+			case 1:
+				size = sf::Vector2f(extent(random) * 4.f, 1.f);
+				break;
+			default:
+				size = sf::Vector2f(float(extent(random)), float(extent(random)));
+				break;
+			}
+			const sf::Vector2f corner(float(cell(random)), float(cell(random)));
+			grid.setWalkable(sf::FloatRect(corner * cellSize, size * cellSize), false);
+		}
+		auto randomWalkable = [&]() {
+			sf::Vector2i target(cell(random), cell(random));
+			while (!grid.isWalkable(target.x, target.y)) {
+				target = sf::Vector2i(cell(random), cell(random));
+			}
+			return grid.cellToWorld(target);
+		};
+
+		World& world = app.getWorld();
+		std::vector<EntityID> agents;
+		for (size_t i = 0; i < agentCount; ++i) {
+			EntityID entity = world.createEntity();
+			world.addComponent<Transform>(entity)->setPosition(randomWalkable());
+			world.addComponent<PathFollower>(entity)->setSpeed(200.f);
+			agents.push_back(entity);
+		}
+
+		// Every step repaths the next agents in turn, and times the step
+		// that ran since the previous call
+		PathfindingService& pathfinding = app.getPathfinding();
+		float repathBudget = 0.f;
+		size_t nextAgent = 0;
+		double worstStepMs = 0.0;
+		bool firstStep = true;
+		auto lastStep = std::chrono::steady_clock::now();
+		app.setStepCallback([&](float deltaTime) {
+			const auto now = std::chrono::steady_clock::now();
+			if (!firstStep) {
+				worstStepMs = std::max(worstStepMs,
+					std::chrono::duration<double, std::milli>(now - lastStep).count());
+			}
+			firstStep = false;
+			lastStep = now;
+
+			repathBudget += repathsPerSecond * deltaTime;
+			for (; repathBudget >= 1.f; repathBudget -= 1.f) {
+				const EntityID agent = agents[nextAgent];
+				nextAgent = (nextAgent + 1) % agents.size();
+				pathfinding.requestPath(agent, world.getComponent<Transform>(agent)->getPosition(),
+					randomWalkable(), algorithm);
+			}
+		});
+
+		app.run();
+		const PathfindingService::Stats& stats = pathfinding.getStats();
+		const double seconds = app.getHeadlessSeconds();
+		bench.report(name + ": frame time", seconds * 1000.0 / frames, "ms");
+		bench.report(name + ": worst step", worstStepMs, "ms");
+		bench.report(name + ": searches", double(stats.searches), "paths");
+		bench.report(name + ": search capacity", stats.searches / seconds, "paths/s");
+		bench.report(name + ": expanded nodes per search",
+			stats.searches > 0 ? double(stats.expandedNodes) / stats.searches : 0.0, "nodes");
+		bench.report(name + ": failed requests", double(stats.failures), "requests");
+	}
+}
@@ -0,0 +1,102 @@
+#include "Benchmark.h"
+#include "SpatialHashGrid.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace {
+	volatile size_t s_sink = 0;
+
+	/**
+	 * @brief Points spread uniformly over a square of side @p worldSize.
+	 */
+	std::vector<sf::Vector2f>
+		scatterPoints(size_t count, float worldSize, unsigned int seed) {
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> coordinate(0.f, worldSize);
+		std::vector<sf::Vector2f> points(count);
+		for (sf::Vector2f& point : points) {
+			point = sf::Vector2f(coordinate(random), coordinate(random));
+		}
+		return points;
+	}
+
+	float
+		distanceSquared(const sf::Vector2f& a, const sf::Vector2f& b) {
+		const sf::Vector2f offset = a - b;
+		return offset.x * offset.x + offset.y * offset.y;
+	}
+}
+
+BENCHMARK(grid, "SpatialHashGrid vs brute force, 10k to 1M points: build, radius and k-nearest queries") {
+	const int queryCount = 200;
+	const float radius = 64.f;
+	const size_t k = 8;
+
+	for (size_t pointCount : { size_t(10000), size_t(100000), size_t(1000000) }) {
+		// About one point per 16x16 units, so every size has the same density
+		const float worldSize = std::sqrt(static_cast<float>(pointCount)) * 16.f;
+		const std::vector<sf::Vector2f> points = scatterPoints(pointCount, worldSize, 7);
+		const std::vector<sf::Vector2f> centers = scatterPoints(queryCount, worldSize, 11);
+		const std::string prefix = std::to_string(pointCount / 1000) + "k ";
+
+		// About four points per bucket, as a caller sizing the grid would do
+		SpatialHashGrid grid(radius, pointCount / 4);
+		const double buildMs = Benchmark::best(3, [&]() {
+			grid.clear();
+			for (size_t i = 0; i < pointCount; ++i) {
+				grid.insert(static_cast<EntityID>(i), points[i]);
+			}
+			grid.build();
+		});
+
+		std::vector<EntityID> found;
+		size_t gridHits = 0;
+		const double gridRadiusMs = Benchmark::time([&]() {
+			for (const sf::Vector2f& center : centers) {
+				found.clear();
+				grid.queryRadius(center, radius, found);
+				gridHits += found.size();
+			}
+		});
+
+		size_t bruteHits = 0;
+		const float radiusSquared = radius * radius;
+		const double bruteRadiusMs = Benchmark::time([&]() {
+			for (const sf::Vector2f& center : centers) {
+				for (const sf::Vector2f& point : points) {
+					bruteHits += distanceSquared(point, center) <= radiusSquared;
+				}
+			}
+		});
+
+		const double gridNearestMs = Benchmark::time([&]() {
+			for (const sf::Vector2f& center : centers) {
+				found.clear();
+				grid.queryKNearest(center, k, found);
+				gridHits += found.size();
+			}
+		});
+
+		std::vector<std::pair<float, EntityID>> candidates(pointCount);
+		const double bruteNearestMs = Benchmark::time([&]() {
+			for (const sf::Vector2f& center : centers) {
+				for (size_t i = 0; i < pointCount; ++i) {
+					candidates[i] = { distanceSquared(points[i], center), static_cast<EntityID>(i) };
+				}
+				std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
+				bruteHits += k;
+			}
+		});
+
+		if (gridHits != bruteHits) {
+			std::printf("grid and brute force disagree (%zu vs %zu hits)\n", gridHits, bruteHits);
+		}
+		bench.report(prefix + "grid build", buildMs, "ms");
+		bench.report(prefix + "radius query: grid", gridRadiusMs * 1000.0 / queryCount, "us/query");
+		bench.report(prefix + "radius query: brute force", bruteRadiusMs * 1000.0 / queryCount, "us/query");
+		bench.report(prefix + "8-nearest: grid", gridNearestMs * 1000.0 / queryCount, "us/query");
+		bench.report(prefix + "8-nearest: brute force", bruteNearestMs * 1000.0 / queryCount, "us/query");
+		s_sink = gridHits;
+	}
+}
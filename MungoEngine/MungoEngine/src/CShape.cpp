@@ -1,26 +1,40 @@
 #include "CShape.h"
 #include "Window.h"
 #include <ESC/Texture.h>
+#include <ESC/Transform.h>
+#include "TextureAtlas.h"
+#include "JobSystem.h"
+
+// Shapes are created and destroyed with their actors; pooling them keeps
+// actor churn off the global heap. The pools and the shape reference counts
+// are not thread safe, so shapes are only created and destroyed on the main
+// thread, never from a component update running on a JobSystem worker.
+static EngineUtilities::TSharedPool<sf::CircleShape> s_circlePool;
+static EngineUtilities::TSharedPool<sf::RectangleShape> s_rectanglePool;
+static EngineUtilities::TSharedPool<sf::ConvexShape> s_convexPool;
 
 void
 CShape::createShape(ShapeType type) {
+    if (JobSystem::isWorkerThread()) {
+        ERROR("CShape", "createShape", "Shapes can only be created on the main thread");
+    }
     m_shapeType = type;
     switch (type) {
     case ShapeType::CIRCLE: {
-        auto circleSP = EngineUtilities::MakeShared<sf::CircleShape>(10.f);
+        auto circleSP = EngineUtilities::MakeShared<sf::CircleShape>(s_circlePool, 10.f);
         circleSP->setFillColor(sf::Color::White);
         m_shapePtr = circleSP.dynamic_pointer_cast<sf::Shape>();
         break;
     }
     case ShapeType::RECTANGLE: {
         auto rectSP = EngineUtilities::MakeShared<sf::RectangleShape>
-            (sf::Vector2f(100.f, 50.f));
+            (s_rectanglePool, sf::Vector2f(100.f, 50.f));
         rectSP->setFillColor(sf::Color::White);
         m_shapePtr = rectSP.dynamic_pointer_cast<sf::Shape>();
         break;
     }
     case ShapeType::TRIANGLE: {
-        auto triSP = EngineUtilities::MakeShared<sf::ConvexShape>(3);
+        auto triSP = EngineUtilities::MakeShared<sf::ConvexShape>(s_convexPool, 3);
         triSP->setPoint(0, { 0,0 });
         triSP->setPoint(1, { 50,100 });
         triSP->setPoint(2, { 100,0 });
@@ -29,7 +43,7 @@ CShape::createShape(ShapeType type) {
         break;
     }
     case ShapeType::POLYGON: {
-        auto polySP = EngineUtilities::MakeShared<sf::ConvexShape>(5);
+        auto polySP = EngineUtilities::MakeShared<sf::ConvexShape>(s_convexPool, 5);
         polySP->setPoint(0, { 0,0 });
         polySP->setPoint(1, { 50,100 });
         polySP->setPoint(2, { 100,0 });
@@ -56,13 +70,19 @@ CShape::update(float deltaTime) {
 
 void
 CShape::render(const EngineUtilities::TSharedPointer<Window>& window) {
+    if (m_shapePtr && !m_textureBound && !m_texture.isNull() && m_texture->isReady()) {
+        bindTexture();
+    }
     if (m_shapePtr) {
-        window->draw(*m_shapePtr);
+        window->drawBatched(*m_shapePtr, sf::RenderStates(m_parentTransform));
     }
 }
 
 void
 CShape::destroy() {
+    if (JobSystem::isWorkerThread()) {
+        ERROR("CShape", "destroy", "Shapes can only be destroyed on the main thread");
+    }
     m_shapePtr.reset();
 }
 
@@ -97,8 +117,81 @@ CShape::setScale(const sf::Vector2f& scale) {
     else ERROR("CShape", "setScale", "Shape no inicializado");
 }
 
+sf::FloatRect
+CShape::getGlobalBounds() const {
+    return m_shapePtr
+        ? m_parentTransform.transformRect(m_shapePtr->getGlobalBounds())
+        : sf::FloatRect();
+}
+
+bool
+CShape::syncTransform(const Transform& transform, float alpha) {
+    if (!m_shapePtr) {
+        return false;
+    }
+    if (transform.getVersion() == m_syncedVersion && !transform.isInterpolating()) {
+        return false;
+    }
+
+    m_shapePtr->setPosition(transform.getInterpolatedPosition(alpha));
+    m_shapePtr->setRotation(transform.getInterpolatedRotation(alpha).x);
+    m_shapePtr->setScale(transform.getInterpolatedScale(alpha));
+    m_syncedVersion = transform.getVersion();
+    return true;
+}
+
+sf::FloatRect
+CShape::getLocalBounds() const {
+    return m_shapePtr ? m_shapePtr->getLocalBounds() : sf::FloatRect();
+}
+
+size_t
+CShape::getPointCount() const {
+    return m_shapePtr ? m_shapePtr->getPointCount() : 0;
+}
+
+sf::Vector2f
+CShape::getPoint(size_t index) const {
+    if (!m_shapePtr) {
+        ERROR("CShape", "getPoint", "Shape no inicializado");
+    }
+    return m_shapePtr->getPoint(index);
+}
+
 void CShape::setTexture(const EngineUtilities::TSharedPointer<Texture>& texture) {
-    if (!texture.isNull()) {
-        m_shapePtr->setTexture(&texture->getTexture());
+    if (!m_shapePtr) {
+        ERROR("CShape", "setTexture", "Shape no inicializado");
+    }
+    m_texture = texture;
+    m_useTextureRect = false;
+    m_textureBound = false;
+    m_shapePtr->setTexture(nullptr);
+
+    // Textures still loading are bound later by render()
+    if (!texture.isNull() && texture->isReady()) {
+        bindTexture();
+    }
+}
+
+void CShape::setTexture(const AtlasRegion& region) {
+    if (!m_shapePtr) {
+        ERROR("CShape", "setTexture", "Shape no inicializado");
+    }
+    m_texture = region.texture;
+    m_textureRect = region.rect;
+    m_useTextureRect = true;
+    m_textureBound = false;
+    m_shapePtr->setTexture(nullptr);
+
+    if (!m_texture.isNull() && m_texture->isReady()) {
+        bindTexture();
+    }
+}
+
+void CShape::bindTexture() {
+    m_shapePtr->setTexture(&m_texture->getTexture(), !m_useTextureRect);
+    if (m_useTextureRect) {
+        m_shapePtr->setTextureRect(m_textureRect);
     }
+    m_textureBound = true;
 }
@@ -0,0 +1,429 @@
+#include "CollisionSystem.h"
+#include "ESC/Transform.h"
+#include "ESC/Collider.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+/**
+ * @brief Separation advantage needed to switch the reference polygon, which
+ * keeps the chosen face from flickering between steps.
+ */
+static const float s_referenceTolerance = 0.01f;
+
+static float
+dot(const sf::Vector2f& a, const sf::Vector2f& b) {
+	return a.x * b.x + a.y * b.y;
+}
+
+/**
+ * @brief Keeps the part of a segment behind a plane (dot(normal, p) <= offset).
+ * @return Number of points written to @p out.
+ */
+static int
+clipSegment(const sf::Vector2f in[2], sf::Vector2f out[2],
+	const sf::Vector2f& normal, float offset) {
+	const float distance0 = dot(normal, in[0]) - offset;
+	const float distance1 = dot(normal, in[1]) - offset;
+
+	int count = 0;
+	if (distance0 <= 0.f) out[count++] = in[0];
+	if (distance1 <= 0.f) out[count++] = in[1];
+
+	// The ends are on different sides: add the intersection point
+	if (distance0 * distance1 < 0.f) {
+		const float t = distance0 / (distance0 - distance1);
+		out[count++] = in[0] + (in[1] - in[0]) * t;
+	}
+	return count;
+}
+
+void
+CollisionSystem::update(World& world) {
+	m_contacts.clear();
+
+	gatherProxies(world);
+	broadPhase();
+
+	m_pairCount = m_pairs.size();
+	for (const auto& pair : m_pairs) {
+		narrowPhase(m_proxies[pair.first], m_proxies[pair.second]);
+	}
+
+	if (m_contacts.empty()) {
+		return;
+	}
+	for (const ContactListener& listener : m_listeners) {
+		listener(m_contacts);
+	}
+}
+
+void
+CollisionSystem::addListener(ContactListener listener) {
+	m_listeners.push_back(std::move(listener));
+}
+
+void
+CollisionSystem::remove(EntityID entity) {
+	m_contacts.erase(std::remove_if(m_contacts.begin(), m_contacts.end(),
+		[entity](const Contact& contact) {
+			return contact.entityA == entity || contact.entityB == entity;
+		}), m_contacts.end());
+	m_order.clear();
+}
+
+void
+CollisionSystem::gatherProxies(World& world) {
+	m_proxies.clear();
+	m_vertices.clear();
+	m_normals.clear();
+
+	world.forEachEntity<Transform, Collider>(
+		[this](EntityID entity, Transform& transform, Collider& collider) {
+			const sf::Transform& toWorld = transform.getTransform();
+
+			Proxy proxy{};
+			proxy.entity = entity;
+			proxy.layer = collider.getLayer();
+			proxy.mask = collider.getMask();
+
+			if (collider.isCircle()) {
+				const sf::Vector2f& scale = transform.getScale();
+				proxy.isCircle = true;
+				proxy.center = toWorld.transformPoint(collider.getCenter());
+				proxy.radius = collider.getRadius() * std::max(std::abs(scale.x), std::abs(scale.y));
+				proxy.minX = proxy.center.x - proxy.radius;
+				proxy.maxX = proxy.center.x + proxy.radius;
+				proxy.minY = proxy.center.y - proxy.radius;
+				proxy.maxY = proxy.center.y + proxy.radius;
+				m_proxies.push_back(proxy);
+				return;
+			}
+
+			// World vertices without repeated points
+			const uint32_t first = static_cast<uint32_t>(m_vertices.size());
+			for (const sf::Vector2f& point : collider.getPoints()) {
+				sf::Vector2f vertex = toWorld.transformPoint(point);
+				if (m_vertices.size() > first && m_vertices.back() == vertex) {
+					continue;
+				}
+				m_vertices.push_back(vertex);
+			}
+			if (m_vertices.size() - first > 1 && m_vertices.back() == m_vertices[first]) {
+				m_vertices.pop_back();
+			}
+
+			// Merge collinear edges: the circle test assumes each face is a
+			// different direction
+			for (size_t i = first; i < m_vertices.size() && m_vertices.size() - first > 3;) {
+				const size_t size = m_vertices.size() - first;
+				const sf::Vector2f& previous = m_vertices[first + (i - first + size - 1) % size];
+				const sf::Vector2f& next = m_vertices[first + (i - first + 1) % size];
+				const sf::Vector2f e1 = m_vertices[i] - previous;
+				const sf::Vector2f e2 = next - m_vertices[i];
+				const float cross = e1.x * e2.y - e1.y * e2.x;
+				if (std::abs(cross) <= 1e-5f * std::sqrt(dot(e1, e1) * dot(e2, e2))) {
+					m_vertices.erase(m_vertices.begin() + i);
+				}
+				else {
+					++i;
+				}
+			}
+
+			const uint32_t count = static_cast<uint32_t>(m_vertices.size()) - first;
+			if (count < 3) {
+				m_vertices.resize(first);
+				return;
+			}
+
+			// Counter-clockwise order (positive area), whatever the scale sign
+			float area = 0.f;
+			for (uint32_t i = 0; i < count; ++i) {
+				const sf::Vector2f& p1 = m_vertices[first + i];
+				const sf::Vector2f& p2 = m_vertices[first + (i + 1) % count];
+				area += p1.x * p2.y - p2.x * p1.y;
+			}
+			if (area < 0.f) {
+				std::reverse(m_vertices.begin() + first, m_vertices.end());
+			}
+
+			proxy.isCircle = false;
+			proxy.firstVertex = first;
+			proxy.vertexCount = count;
+			proxy.minX = proxy.maxX = m_vertices[first].x;
+			proxy.minY = proxy.maxY = m_vertices[first].y;
+			for (uint32_t i = 0; i < count; ++i) {
+				const sf::Vector2f& p1 = m_vertices[first + i];
+				const sf::Vector2f& p2 = m_vertices[first + (i + 1) % count];
+				sf::Vector2f normal(p2.y - p1.y, p1.x - p2.x);
+				float length = std::sqrt(dot(normal, normal));
+				m_normals.push_back(length > 0.f ? normal / length : normal);
+
+				proxy.minX = std::min(proxy.minX, p1.x);
+				proxy.maxX = std::max(proxy.maxX, p1.x);
+				proxy.minY = std::min(proxy.minY, p1.y);
+				proxy.maxY = std::max(proxy.maxY, p1.y);
+			}
+			m_proxies.push_back(proxy);
+		});
+}
+
+void
+CollisionSystem::broadPhase() {
+	m_pairs.clear();
+	const size_t count = m_proxies.size();
+
+	auto minX = [this](uint32_t index) { return m_proxies[index].minX; };
+	if (m_order.size() != count) {
+		m_order.resize(count);
+		std::iota(m_order.begin(), m_order.end(), 0u);
+		std::sort(m_order.begin(), m_order.end(),
+			[&minX](uint32_t a, uint32_t b) { return minX(a) < minX(b); });
+	}
+	else {
+		// Nearly sorted from the last step: insertion sort is close to O(n)
+		for (size_t i = 1; i < count; ++i) {
+			uint32_t index = m_order[i];
+			float key = minX(index);
+			size_t j = i;
+			while (j > 0 && minX(m_order[j - 1]) > key) {
+				m_order[j] = m_order[j - 1];
+				--j;
+			}
+			m_order[j] = index;
+		}
+	}
+
+	// Sweep: only proxies starting before this one ends can overlap it
+	for (size_t i = 0; i < count; ++i) {
+		const Proxy& a = m_proxies[m_order[i]];
+		for (size_t j = i + 1; j < count; ++j) {
+			const Proxy& b = m_proxies[m_order[j]];
+			if (b.minX > a.maxX) {
+				break;
+			}
+			if (b.minY > a.maxY || a.minY > b.maxY) {
+				continue;
+			}
+			if ((a.layer & b.mask) == 0 || (b.layer & a.mask) == 0) {
+				continue;
+			}
+			m_pairs.emplace_back(m_order[i], m_order[j]);
+		}
+	}
+}
+
+void
+CollisionSystem::narrowPhase(const Proxy& a, const Proxy& b) {
+	Contact contact{};
+	bool touching = false;
+
+	if (a.isCircle && b.isCircle) {
+		touching = collideCircles(a, b, contact);
+	}
+	else if (!a.isCircle && b.isCircle) {
+		touching = collidePolygonCircle(a, b, contact);
+	}
+	else if (a.isCircle && !b.isCircle) {
+		touching = collidePolygonCircle(b, a, contact);
+		contact.normal = -contact.normal;
+	}
+	else {
+		touching = collidePolygons(a, b, contact);
+	}
+
+	if (touching) {
+		contact.entityA = a.entity;
+		contact.entityB = b.entity;
+		m_contacts.push_back(contact);
+	}
+}
+
+bool
+CollisionSystem::collideCircles(const Proxy& a, const Proxy& b, Contact& contact) const {
+	const sf::Vector2f delta = b.center - a.center;
+	const float distanceSquared = dot(delta, delta);
+	const float radii = a.radius + b.radius;
+	if (distanceSquared > radii * radii) {
+		return false;
+	}
+
+	const float distance = std::sqrt(distanceSquared);
+	contact.normal = distance > 0.f ? delta / distance : sf::Vector2f(1.f, 0.f);
+	contact.penetration = radii - distance;
+	contact.points[0] = a.center + contact.normal * (a.radius - contact.penetration / 2.f);
+	contact.pointCount = 1;
+	return true;
+}
+
+bool
+CollisionSystem::collidePolygonCircle(const Proxy& polygon, const Proxy& circle, Contact& contact) const {
+	const sf::Vector2f* vertices = &m_vertices[polygon.firstVertex];
+	const sf::Vector2f* normals = &m_normals[polygon.firstVertex];
+	const uint32_t count = polygon.vertexCount;
+
+	// Face closest to the circle center
+	float separation = -std::numeric_limits<float>::max();
+	uint32_t face = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		float s = dot(normals[i], circle.center - vertices[i]);
+		if (s > circle.radius) {
+			return false;
+		}
+		if (s > separation) {
+			separation = s;
+			face = i;
+		}
+	}
+
+	const sf::Vector2f& v1 = vertices[face];
+	const sf::Vector2f& v2 = vertices[(face + 1) % count];
+
+	// Center inside the polygon: push out through the closest face
+	if (separation <= 0.f) {
+		contact.normal = normals[face];
+		contact.penetration = circle.radius - separation;
+		contact.points[0] = circle.center - normals[face] * separation;
+		contact.pointCount = 1;
+		return true;
+	}
+
+	// Otherwise the closest feature is either end of the face or the face itself
+	auto vertexContact = [&](const sf::Vector2f& vertex) {
+		sf::Vector2f delta = circle.center - vertex;
+		float distanceSquared = dot(delta, delta);
+		if (distanceSquared > circle.radius * circle.radius) {
+			return false;
+		}
+		float distance = std::sqrt(distanceSquared);
+		contact.normal = distance > 0.f ? delta / distance : normals[face];
+		contact.penetration = circle.radius - distance;
+		contact.points[0] = vertex;
+		contact.pointCount = 1;
+		return true;
+	};
+
+	if (dot(circle.center - v1, v2 - v1) <= 0.f) {
+		return vertexContact(v1);
+	}
+	if (dot(circle.center - v2, v1 - v2) <= 0.f) {
+		return vertexContact(v2);
+	}
+
+	contact.normal = normals[face];
+	contact.penetration = circle.radius - separation;
+	contact.points[0] = circle.center - normals[face] * separation;
+	contact.pointCount = 1;
+	return true;
+}
+
+float
+CollisionSystem::findMaxSeparation(const Proxy& a, const Proxy& b, uint32_t& edge) const {
+	float maxSeparation = -std::numeric_limits<float>::max();
+	edge = 0;
+	for (uint32_t i = 0; i < a.vertexCount; ++i) {
+		const sf::Vector2f& normal = m_normals[a.firstVertex + i];
+		const sf::Vector2f& vertex = m_vertices[a.firstVertex + i];
+
+		// Deepest vertex of b along this face normal
+		float separation = std::numeric_limits<float>::max();
+		for (uint32_t j = 0; j < b.vertexCount; ++j) {
+			separation = std::min(separation, dot(normal, m_vertices[b.firstVertex + j] - vertex));
+		}
+
+		if (separation > maxSeparation) {
+			maxSeparation = separation;
+			edge = i;
+		}
+	}
+	return maxSeparation;
+}
+
+bool
+CollisionSystem::collidePolygons(const Proxy& a, const Proxy& b, Contact& contact) const {
+	uint32_t edgeA = 0;
+	const float separationA = findMaxSeparation(a, b, edgeA);
+	if (separationA > 0.f) {
+		return false;
+	}
+
+	uint32_t edgeB = 0;
+	const float separationB = findMaxSeparation(b, a, edgeB);
+	if (separationB > 0.f) {
+		return false;
+	}
+
+	// The reference face is the one with the least penetration
+	const Proxy* reference = &a;
+	const Proxy* incident = &b;
+	uint32_t edge = edgeA;
+	bool flip = false;
+	if (separationB > separationA + s_referenceTolerance) {
+		reference = &b;
+		incident = &a;
+		edge = edgeB;
+		flip = true;
+	}
+
+	const sf::Vector2f& referenceNormal = m_normals[reference->firstVertex + edge];
+	const sf::Vector2f& v11 = m_vertices[reference->firstVertex + edge];
+	const sf::Vector2f& v12 = m_vertices[reference->firstVertex + (edge + 1) % reference->vertexCount];
+
+	// Incident face: the one most opposed to the reference normal
+	uint32_t incidentEdge = 0;
+	float minDot = std::numeric_limits<float>::max();
+	for (uint32_t i = 0; i < incident->vertexCount; ++i) {
+		float d = dot(referenceNormal, m_normals[incident->firstVertex + i]);
+		if (d < minDot) {
+			minDot = d;
+			incidentEdge = i;
+		}
+	}
+	sf::Vector2f incidentPoints[2] = {
+		m_vertices[incident->firstVertex + incidentEdge],
+		m_vertices[incident->firstVertex + (incidentEdge + 1) % incident->vertexCount]
+	};
+
+	contact.normal = flip ? -referenceNormal : referenceNormal;
+
+	// Clip the incident face to the side planes of the reference face and
+	// keep the points behind it
+	sf::Vector2f tangent = v12 - v11;
+	const float tangentLength = std::sqrt(dot(tangent, tangent));
+	const float frontOffset = dot(referenceNormal, v11);
+	contact.pointCount = 0;
+	contact.penetration = 0.f;
+
+	sf::Vector2f clipped1[2];
+	sf::Vector2f clipped2[2];
+	if (tangentLength > 0.f) {
+		tangent /= tangentLength;
+		if (clipSegment(incidentPoints, clipped1, -tangent, -dot(tangent, v11)) == 2 &&
+			clipSegment(clipped1, clipped2, tangent, dot(tangent, v12)) == 2) {
+			for (const sf::Vector2f& point : clipped2) {
+				float separation = dot(referenceNormal, point) - frontOffset;
+				if (separation <= 0.f) {
+					contact.points[contact.pointCount++] = point;
+					contact.penetration = std::max(contact.penetration, -separation);
+				}
+			}
+		}
+	}
+
+	// Deep overlaps can leave the incident face outside the reference face;
+	// fall back to the incident vertex furthest behind it
+	if (contact.pointCount == 0) {
+		const sf::Vector2f* deepest = &m_vertices[incident->firstVertex];
+		for (uint32_t i = 1; i < incident->vertexCount; ++i) {
+			const sf::Vector2f& vertex = m_vertices[incident->firstVertex + i];
+			if (dot(referenceNormal, vertex) < dot(referenceNormal, *deepest)) {
+				deepest = &vertex;
+			}
+		}
+		contact.points[0] = *deepest;
+		contact.pointCount = 1;
+		contact.penetration = -(flip ? separationB : separationA);
+	}
+	return true;
+}
@@ -5,28 +5,32 @@
 #include <ESC/Transform.h>
 
 Actor::
-Actor(const std::string& actorName) {
+Actor(World* world, const std::string& actorName) {
     // Setup Actor Name
     m_name = actorName;
 
+    // Bind the actor to its entity in the world
+    m_world = world;
+    if (m_world != nullptr) {
+        id = m_world->createEntity();
+    }
+
     // Setup Shape
-    EngineUtilities::TSharedPointer<CShape>
-        shape = EngineUtilities::MakeShared<CShape>();
-    addComponent(shape);
+    addComponent<CShape>();
 
     // Setup Transform
-    EngineUtilities::TSharedPointer<Transform>
-        transform = EngineUtilities::MakeShared<Transform>();
-    addComponent(transform);
+    addComponent<Transform>();
 }
 
 void
 Actor::render(const EngineUtilities::TSharedPointer<Window>& window) {
-    for (unsigned int i = 0; i < components.size(); i++) {
-        auto component = components[i];
-        if (component) {
-            component->render(window);
+    auto shape = getComponent<CShape>();
+    if (shape && !window.isNull()) {
+        // Skip shapes entirely outside the view
+        if (!shape->getGlobalBounds().intersects(window->getViewBounds())) {
+            return;
         }
+        shape->render(window);
     }
 }
 
@@ -41,18 +45,32 @@ Actor::update(float deltaTime) {
     auto shape = getComponent<CShape>();
 
     if (transform && shape) {
-        shape->setPosition(transform->getPosition());
-        shape->setRotation(transform->getRotation().x);
-        shape->setScale(transform->getScale());
+        // No-op unless the transform changed since the last sync
+        shape->syncTransform(*transform);
     }
 
 }
 
 void
 Actor::destroy() {
-
+    if (m_world != nullptr) {
+        m_world->destroyEntity(id);
+        m_world = nullptr;
+    }
 }
 
 void Actor::setTexture(const EngineUtilities::TSharedPointer<Texture>& texture)
 {
+    CShape* shape = getComponent<CShape>();
+    if (shape) {
+        shape->setTexture(texture);
+    }
+}
+
+void Actor::setTexture(const AtlasRegion& region)
+{
+    CShape* shape = getComponent<CShape>();
+    if (shape) {
+        shape->setTexture(region);
+    }
 }
@@ -0,0 +1,46 @@
+#include <ESC/Collider.h>
+#include "CShape.h"
+
+void
+Collider::setCircle(float radius, const sf::Vector2f& center) {
+	if (radius <= 0.f) {
+		ERROR("Collider", "setCircle", "Radius must be positive");
+	}
+	m_isCircle = true;
+	m_radius = radius;
+	m_center = center;
+	m_points.clear();
+}
+
+void
+Collider::setBox(const sf::Vector2f& size) {
+	setPolygon({ sf::Vector2f(0.f, 0.f),
+		sf::Vector2f(size.x, 0.f),
+		sf::Vector2f(size.x, size.y),
+		sf::Vector2f(0.f, size.y) });
+}
+
+void
+Collider::setPolygon(const std::vector<sf::Vector2f>& points) {
+	if (points.size() < 3) {
+		ERROR("Collider", "setPolygon", "A polygon needs at least 3 points");
+	}
+	m_isCircle = false;
+	m_points = points;
+}
+
+void
+Collider::fitToShape(const CShape& shape) {
+	if (shape.getShapeType() == CIRCLE) {
+		sf::FloatRect bounds = shape.getLocalBounds();
+		setCircle(bounds.width / 2.f,
+			sf::Vector2f(bounds.left + bounds.width / 2.f, bounds.top + bounds.height / 2.f));
+		return;
+	}
+
+	std::vector<sf::Vector2f> points(shape.getPointCount());
+	for (size_t i = 0; i < points.size(); ++i) {
+		points[i] = shape.getPoint(i);
+	}
+	setPolygon(points);
+}
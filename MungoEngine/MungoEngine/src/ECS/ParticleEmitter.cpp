@@ -0,0 +1,308 @@
+#include <ESC/ParticleEmitter.h>
+#include "TextureAtlas.h"
+#include "Window.h"
+#include "JobSystem.h"
+#include "Utilities/VectorBatch.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+/**
+ * @brief Particles written by one job in render().
+ */
+static const size_t s_fillGrainSize = 16384;
+
+void
+ParticleEmitter::update(float deltaTime) {
+	PROFILE_SCOPE("ParticleEmitter::update");
+
+	for (size_t i = 0; i < m_count; ++i) {
+		m_age[i] += deltaTime;
+	}
+
+	// Remove dead particles, moving the last live one into their slot
+	for (size_t i = 0; i < m_count;) {
+		if (m_age[i] < m_lifetime[i]) {
+			++i;
+			continue;
+		}
+		--m_count;
+		m_positionX[i] = m_positionX[m_count];
+		m_positionY[i] = m_positionY[m_count];
+		m_velocityX[i] = m_velocityX[m_count];
+		m_velocityY[i] = m_velocityY[m_count];
+		m_age[i] = m_age[m_count];
+		m_lifetime[i] = m_lifetime[m_count];
+	}
+
+	if (m_acceleration.x != 0.f || m_acceleration.y != 0.f) {
+		const float accelerationX = m_acceleration.x * deltaTime;
+		const float accelerationY = m_acceleration.y * deltaTime;
+		for (size_t i = 0; i < m_count; ++i) {
+			m_velocityX[i] += accelerationX;
+			m_velocityY[i] += accelerationY;
+		}
+	}
+	EngineUtilities::VectorBatch::addScaled(m_positionX.data(), m_positionY.data(),
+		m_velocityX.data(), m_velocityY.data(), deltaTime,
+		m_positionX.data(), m_positionY.data(), m_count);
+
+	m_emissionAccumulator += m_emissionRate * deltaTime;
+	if (m_emissionAccumulator >= 1.f) {
+		const size_t count = static_cast<size_t>(m_emissionAccumulator);
+		m_emissionAccumulator -= static_cast<float>(count);
+		emit(count);
+	}
+}
+
+void
+ParticleEmitter::render(const EngineUtilities::TSharedPointer<Window>& window) {
+	render(window, nullptr);
+}
+
+void
+ParticleEmitter::render(const EngineUtilities::TSharedPointer<Window>& window, JobSystem* jobs) {
+	if (m_count == 0 || window.isNull()) {
+		return;
+	}
+	PROFILE_SCOPE("ParticleEmitter::render");
+
+	buildVertices(jobs);
+	sf::RenderStates states;
+	states.texture = getDrawTexture();
+	window->draw(m_vertices, states);
+}
+
+void
+ParticleEmitter::buildVertices(JobSystem* jobs) {
+	if (m_count == 0) {
+		m_vertices.resize(0);
+		return;
+	}
+
+	const sf::Texture* texture = getDrawTexture();
+	sf::FloatRect uv;
+	if (texture != nullptr) {
+		if (m_useTextureRect) {
+			uv = sf::FloatRect(m_textureRect);
+		}
+		else {
+			const sf::Vector2u size = texture->getSize();
+			uv = sf::FloatRect(0.f, 0.f, static_cast<float>(size.x), static_cast<float>(size.y));
+		}
+	}
+	const sf::Vector2f uv0(uv.left, uv.top);
+	const sf::Vector2f uv1(uv.left + uv.width, uv.top);
+	const sf::Vector2f uv2(uv.left + uv.width, uv.top + uv.height);
+	const sf::Vector2f uv3(uv.left, uv.top + uv.height);
+
+	const float sizeDelta = m_endSize - m_startSize;
+	const float red = m_startColor.r, redDelta = static_cast<float>(m_endColor.r) - red;
+	const float green = m_startColor.g, greenDelta = static_cast<float>(m_endColor.g) - green;
+	const float blue = m_startColor.b, blueDelta = static_cast<float>(m_endColor.b) - blue;
+	const float alpha = m_startColor.a, alphaDelta = static_cast<float>(m_endColor.a) - alpha;
+
+	// Two triangles per particle, written in place. Texture coordinates,
+	// and the color when it does not fade, are the same for every particle,
+	// so they are only written for vertices that are new or when they change.
+	const bool constantColor = m_startColor == m_endColor;
+	m_vertices.resize(m_count * 6);
+	size_t staticFrom = std::min(m_staticFieldsWritten, m_count);
+	if (uv != m_texCoordsRect || constantColor != m_constantColorWritten ||
+		(constantColor && m_startColor != m_writtenColor)) {
+		m_texCoordsRect = uv;
+		m_constantColorWritten = constantColor;
+		m_writtenColor = m_startColor;
+		staticFrom = 0;
+	}
+	m_staticFieldsWritten = m_count;
+
+	sf::Vertex* vertices = &m_vertices[0];
+	auto fill = [&](size_t first, size_t last) {
+		sf::Vertex* vertex = vertices + first * 6;
+		for (size_t i = first; i < last; ++i, vertex += 6) {
+			const float t = m_age[i] / m_lifetime[i];
+			const float half = (m_startSize + sizeDelta * t) * 0.5f;
+			const float left = m_positionX[i] - half;
+			const float right = m_positionX[i] + half;
+			const float top = m_positionY[i] - half;
+			const float bottom = m_positionY[i] + half;
+
+			// Plain field writes: the sf::Vertex constructors are not inline.
+			// Corners: 0 and 3 top left, 1 top right, 2 and 4 bottom right,
+			// 5 bottom left
+			vertex[0].position.x = left;
+			vertex[0].position.y = top;
+			vertex[1].position.x = right;
+			vertex[1].position.y = top;
+			vertex[2].position.x = right;
+			vertex[2].position.y = bottom;
+			vertex[3].position.x = left;
+			vertex[3].position.y = top;
+			vertex[4].position.x = right;
+			vertex[4].position.y = bottom;
+			vertex[5].position.x = left;
+			vertex[5].position.y = bottom;
+			if (!constantColor) {
+				sf::Color color;
+				color.r = static_cast<sf::Uint8>(red + redDelta * t);
+				color.g = static_cast<sf::Uint8>(green + greenDelta * t);
+				color.b = static_cast<sf::Uint8>(blue + blueDelta * t);
+				color.a = static_cast<sf::Uint8>(alpha + alphaDelta * t);
+				for (int corner = 0; corner < 6; ++corner) {
+					vertex[corner].color = color;
+				}
+			}
+			if (i >= staticFrom) {
+				if (constantColor) {
+					for (int corner = 0; corner < 6; ++corner) {
+						vertex[corner].color = m_startColor;
+					}
+				}
+				vertex[0].texCoords = uv0;
+				vertex[1].texCoords = uv1;
+				vertex[2].texCoords = uv2;
+				vertex[3].texCoords = uv0;
+				vertex[4].texCoords = uv2;
+				vertex[5].texCoords = uv3;
+			}
+		}
+	};
+
+	// The fill is bound by memory bandwidth: split it across the workers
+	if (jobs != nullptr) {
+		jobs->parallelFor(0, m_count, s_fillGrainSize, fill);
+	}
+	else {
+		fill(0, m_count);
+	}
+}
+
+const sf::Texture*
+ParticleEmitter::getDrawTexture() const {
+	if (m_texture.isNull() || !m_texture->isReady()) {
+		return nullptr;
+	}
+	return &m_texture->getTexture();
+}
+
+void
+ParticleEmitter::setMaxParticles(size_t maxParticles) {
+	m_maxParticles = maxParticles;
+	m_count = std::min(m_count, maxParticles);
+	if (m_positionX.size() > maxParticles) {
+		m_positionX.resize(maxParticles);
+		m_positionY.resize(maxParticles);
+		m_velocityX.resize(maxParticles);
+		m_velocityY.resize(maxParticles);
+		m_age.resize(maxParticles);
+		m_lifetime.resize(maxParticles);
+	}
+}
+
+void
+ParticleEmitter::burst(size_t count) {
+	emit(count);
+}
+
+void
+ParticleEmitter::setLifetime(float minSeconds, float maxSeconds) {
+	if (minSeconds <= 0.f || maxSeconds < minSeconds) {
+		ERROR("ParticleEmitter", "setLifetime", "Invalid lifetime range");
+	}
+	m_minLifetime = minSeconds;
+	m_maxLifetime = maxSeconds;
+}
+
+void
+ParticleEmitter::setSpeed(float minSpeed, float maxSpeed) {
+	m_minSpeed = minSpeed;
+	m_maxSpeed = maxSpeed;
+}
+
+void
+ParticleEmitter::setDirection(float angle, float spread) {
+	m_angle = angle;
+	m_spread = spread;
+}
+
+void
+ParticleEmitter::setSize(float startSize, float endSize) {
+	m_startSize = startSize;
+	m_endSize = endSize;
+}
+
+void
+ParticleEmitter::setColor(const sf::Color& startColor, const sf::Color& endColor) {
+	m_startColor = startColor;
+	m_endColor = endColor;
+}
+
+void
+ParticleEmitter::setTexture(const EngineUtilities::TSharedPointer<Texture>& texture) {
+	m_texture = texture;
+	m_useTextureRect = false;
+}
+
+void
+ParticleEmitter::setTexture(const AtlasRegion& region) {
+	m_texture = region.texture;
+	m_textureRect = region.rect;
+	m_useTextureRect = true;
+}
+
+void
+ParticleEmitter::emit(size_t count) {
+	count = std::min(count, m_maxParticles - m_count);
+	if (count == 0) {
+		return;
+	}
+
+	// Storage grows to the capacity once, on first use
+	if (m_positionX.size() < m_maxParticles) {
+		m_positionX.resize(m_maxParticles);
+		m_positionY.resize(m_maxParticles);
+		m_velocityX.resize(m_maxParticles);
+		m_velocityY.resize(m_maxParticles);
+		m_age.resize(m_maxParticles);
+		m_lifetime.resize(m_maxParticles);
+	}
+
+	const float degreesToRadians = 3.14159265f / 180.f;
+	for (size_t i = m_count; i < m_count + count; ++i) {
+		const float angle = (m_angle + (random() - 0.5f) * m_spread) * degreesToRadians;
+		const float speed = m_minSpeed + (m_maxSpeed - m_minSpeed) * random();
+		m_positionX[i] = m_position.x;
+		m_positionY[i] = m_position.y;
+		m_velocityX[i] = std::cos(angle) * speed;
+		m_velocityY[i] = std::sin(angle) * speed;
+		m_age[i] = 0.f;
+		m_lifetime[i] = m_minLifetime + (m_maxLifetime - m_minLifetime) * random();
+	}
+	m_count += count;
+}
+
+void
+ParticleEmitter::setSeed(uint32_t seed) {
+	// Spread nearby seeds over the whole state; xorshift must not start at 0
+	seed ^= seed >> 16;
+	seed *= 0x7FEB352Du;
+	seed ^= seed >> 15;
+	seed *= 0x846CA68Bu;
+	seed ^= seed >> 16;
+	m_randomState = seed != 0 ? seed : 0x9E3779B9u;
+}
+
+uint32_t
+ParticleEmitter::nextSeed() {
+	static std::atomic<uint32_t> counter{ 0 };
+	return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+float
+ParticleEmitter::random() {
+	m_randomState ^= m_randomState << 13;
+	m_randomState ^= m_randomState >> 17;
+	m_randomState ^= m_randomState << 5;
+	return static_cast<float>(m_randomState >> 8) * (1.f / 16777216.f);
+}
@@ -0,0 +1,45 @@
+#include <ESC/PathFollower.h>
+#include <cmath>
+
+void
+PathFollower::follow(Transform& transform, float deltaTime) {
+	if (!hasPath()) {
+		return;
+	}
+
+	const sf::Vector2f target = m_path[m_currentWaypointIndex];
+	const sf::Vector2f offset = target - transform.getPosition();
+	const float distanceToTarget = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+	if (distanceToTarget < m_arrivalRadius) {
+		++m_currentWaypointIndex;
+	}
+	else {
+		transform.seek(target, m_speed, deltaTime, m_arrivalRadius);
+	}
+}
+
+void
+PathFollower::setPath(const std::vector<sf::Vector2f>& path) {
+	m_path = path;
+	m_currentWaypointIndex = 0;
+	m_failed = false;
+}
+
+void
+PathFollower::setPath(std::vector<sf::Vector2f>&& path) {
+	m_path = std::move(path);
+	m_currentWaypointIndex = 0;
+	m_failed = false;
+}
+
+void
+PathFollower::clearPath() {
+	m_path.clear();
+	m_currentWaypointIndex = 0;
+}
+
+void
+PathFollower::setPathFailed() {
+	clearPath();
+	m_failed = true;
+}
@@ -0,0 +1,154 @@
+#include <ESC/World.h>
+#include "Window.h"
+
+/**
+ * @brief Components updated by one job in World::update.
+ */
+static const size_t s_updateGrainSize = 1024;
+
+World::World() {
+	// Archetype 0 is always the empty signature, used by fresh entities.
+	EngineUtilities::TUniquePtr<Archetype> empty(new Archetype());
+	registerArchetype(std::move(empty));
+}
+
+World::~World() {
+	// The systems listening may already be gone
+	m_destroyListeners.clear();
+	for (EntityID entity = 0; entity < m_records.size(); ++entity) {
+		if (m_records[entity].alive) {
+			destroyEntity(entity);
+		}
+	}
+}
+
+EntityID
+World::createEntity() {
+	EntityID entity;
+	if (!m_freeEntities.empty()) {
+		entity = m_freeEntities.back();
+		m_freeEntities.pop_back();
+	}
+	else {
+		entity = static_cast<EntityID>(m_records.size());
+		m_records.emplace_back();
+	}
+
+	Archetype& empty = *m_archetypes[0];
+	EntityRecord& record = m_records[entity];
+	record.archetype = 0;
+	record.row = static_cast<uint32_t>(empty.entities.size());
+	record.alive = true;
+	empty.entities.push_back(entity);
+
+	++m_entityCount;
+	return entity;
+}
+
+void
+World::destroyEntity(EntityID entity) {
+	if (!isAlive(entity)) {
+		return;
+	}
+
+	for (const DestroyListener& listener : m_destroyListeners) {
+		listener(entity);
+	}
+
+	EntityRecord& record = m_records[entity];
+	Archetype& archetype = *m_archetypes[record.archetype];
+	for (auto& column : archetype.columns) {
+		column->getComponent(record.row)->destroy();
+	}
+
+	removeRow(record.archetype, record.row);
+	record.alive = false;
+	m_freeEntities.push_back(entity);
+	--m_entityCount;
+}
+
+bool
+World::isAlive(EntityID entity) const {
+	return entity < m_records.size() && m_records[entity].alive;
+}
+
+void
+World::update(float deltaTime, JobSystem* jobs) {
+	for (auto& archetype : m_archetypes) {
+		for (auto& column : archetype->columns) {
+			if (jobs == nullptr) {
+				column->updateAll(deltaTime);
+				continue;
+			}
+
+			IComponentColumn* target = column.get();
+			jobs->parallelFor(0, target->size(), s_updateGrainSize,
+				[target, deltaTime](size_t first, size_t last) {
+					target->updateRange(first, last, deltaTime);
+				});
+		}
+	}
+}
+
+void
+World::render(const EngineUtilities::TSharedPointer<Window>& window) {
+	for (auto& archetype : m_archetypes) {
+		for (auto& column : archetype->columns) {
+			column->renderAll(window);
+		}
+	}
+}
+
+int
+World::findArchetype(ComponentSignature signature) const {
+	auto it = m_archetypeLookup.find(signature);
+	return it != m_archetypeLookup.end() ? static_cast<int>(it->second) : -1;
+}
+
+uint32_t
+World::registerArchetype(EngineUtilities::TUniquePtr<Archetype> archetype) {
+	uint32_t index = static_cast<uint32_t>(m_archetypes.size());
+	m_archetypeLookup.emplace(archetype->signature, index);
+	m_archetypes.push_back(std::move(archetype));
+	return index;
+}
+
+void
+World::moveEntity(EntityID entity, uint32_t targetArchetype) {
+	EntityRecord& record = m_records[entity];
+	Archetype& source = *m_archetypes[record.archetype];
+	Archetype& target = *m_archetypes[targetArchetype];
+
+	for (size_t i = 0; i < target.columns.size(); ++i) {
+		int sourceColumn = source.findColumn(target.columns[i]->getTypeID());
+		if (sourceColumn >= 0) {
+			target.columns[i]->moveFrom(*source.columns[sourceColumn], record.row);
+		}
+	}
+
+	uint32_t sourceArchetype = record.archetype;
+	uint32_t sourceRow = record.row;
+
+	record.archetype = targetArchetype;
+	record.row = static_cast<uint32_t>(target.entities.size());
+	target.entities.push_back(entity);
+
+	removeRow(sourceArchetype, sourceRow);
+}
+
+void
+World::removeRow(uint32_t archetypeIndex, uint32_t row) {
+	Archetype& archetype = *m_archetypes[archetypeIndex];
+	for (auto& column : archetype.columns) {
+		column->removeSwap(row);
+	}
+
+	EntityID last = archetype.entities.back();
+	archetype.entities[row] = last;
+	archetype.entities.pop_back();
+
+	// The last entity now lives in the removed row.
+	if (row < archetype.entities.size()) {
+		m_records[last].row = row;
+	}
+}
@@ -0,0 +1,207 @@
+#include "JobSystem.h"
+
+/**
+ * @brief Slot of the current thread in the JobSystem that owns it.
+ */
+static thread_local const JobSystem* t_owner = nullptr;
+static thread_local unsigned int t_index = 0;
+
+JobSystem::JobSystem(unsigned int threadCount) {
+	if (threadCount == 0) {
+		threadCount = std::thread::hardware_concurrency();
+	}
+	if (threadCount == 0) {
+		threadCount = 1;
+	}
+
+	m_queues.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; ++i) {
+		m_queues.emplace_back(new WorkQueue());
+	}
+
+	// Slot 0 belongs to the creating thread, which helps while waiting
+	m_workers.reserve(threadCount - 1);
+	for (unsigned int i = 1; i < threadCount; ++i) {
+		m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+	}
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_running.store(false);
+	}
+	m_wakeUp.notify_all();
+
+	for (std::thread& worker : m_workers) {
+		worker.join();
+	}
+}
+
+void
+JobSystem::schedule(std::function<void()> job, JobCounter* counter) {
+	push(wrap(std::move(job), counter));
+}
+
+void
+JobSystem::scheduleBackground(std::function<void()> job, JobCounter* counter) {
+	std::function<void()> wrapped = wrap(std::move(job), counter);
+
+	// Nobody else would ever run it
+	if (m_workers.empty()) {
+		wrapped();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_background.mutex);
+		m_background.jobs.push_back(std::move(wrapped));
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_queuedJobs.fetch_add(1);
+	}
+	m_wakeUp.notify_one();
+}
+
+void
+JobSystem::scheduleAfter(JobCounter& dependency,
+	std::function<void()> job,
+	JobCounter* counter) {
+	std::function<void()> wrapped = wrap(std::move(job), counter);
+
+	{
+		// Same lock as the release in wrap(): either the job is parked before
+		// the counter drains, or the counter is already zero and it runs now.
+		std::lock_guard<std::mutex> lock(dependency.m_continuationMutex);
+		if (!dependency.isDone()) {
+			dependency.m_continuations.push_back(std::move(wrapped));
+			return;
+		}
+	}
+	push(std::move(wrapped));
+}
+
+void
+JobSystem::wait(JobCounter& counter) {
+	const unsigned int index = currentIndex();
+	while (!counter.isDone()) {
+		if (!runOneJob(index, false)) {
+			std::this_thread::yield();
+		}
+	}
+
+	// The last job may still hold the counter lock; let it leave before the
+	// caller is allowed to destroy the counter.
+	std::lock_guard<std::mutex> lock(counter.m_continuationMutex);
+}
+
+void
+JobSystem::workerLoop(unsigned int index) {
+	t_owner = this;
+	t_index = index;
+
+	while (m_running.load()) {
+		if (runOneJob(index, true)) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_wakeUp.wait(lock, [this]() {
+			return !m_running.load() || m_queuedJobs.load() > 0;
+		});
+	}
+}
+
+bool
+JobSystem::runOneJob(unsigned int index, bool background) {
+	std::function<void()> job;
+
+	// Own deque first, newest job (still hot in cache)
+	{
+		WorkQueue& own = *m_queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty()) {
+			job = std::move(own.jobs.back());
+			own.jobs.pop_back();
+		}
+	}
+
+	// Otherwise steal the oldest job of another thread
+	const unsigned int count = static_cast<unsigned int>(m_queues.size());
+	for (unsigned int offset = 1; !job && offset < count; ++offset) {
+		WorkQueue& victim = *m_queues[(index + offset) % count];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty()) {
+			job = std::move(victim.jobs.front());
+			victim.jobs.pop_front();
+		}
+	}
+
+	// Long jobs last, oldest first, so frame jobs never queue behind them
+	if (!job && background) {
+		std::lock_guard<std::mutex> lock(m_background.mutex);
+		if (!m_background.jobs.empty()) {
+			job = std::move(m_background.jobs.front());
+			m_background.jobs.pop_front();
+		}
+	}
+
+	if (!job) {
+		return false;
+	}
+
+	m_queuedJobs.fetch_sub(1);
+	job();
+	return true;
+}
+
+void
+JobSystem::push(std::function<void()> job) {
+	WorkQueue& queue = *m_queues[currentIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(std::move(job));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_queuedJobs.fetch_add(1);
+	}
+	m_wakeUp.notify_one();
+}
+
+std::function<void()>
+JobSystem::wrap(std::function<void()> job, JobCounter* counter) {
+	if (counter == nullptr) {
+		return job;
+	}
+
+	counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+	return [this, job = std::move(job), counter]() {
+		job();
+
+		std::vector<std::function<void()>> ready;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_continuationMutex);
+			if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				ready.swap(counter->m_continuations);
+			}
+		}
+
+		// The counter may be destroyed by its waiter from here on
+		for (std::function<void()>& next : ready) {
+			push(std::move(next));
+		}
+	};
+}
+
+bool
+JobSystem::isWorkerThread() {
+	return t_owner != nullptr;
+}
+
+unsigned int
+JobSystem::currentIndex() const {
+	return t_owner == this ? t_index : 0;
+}
@@ -0,0 +1,270 @@
+#include "Logger.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+
+/**
+ * @brief Messages the ring buffer holds (power of two).
+ */
+static const size_t s_ringCapacity = 8192;
+
+/**
+ * @brief How long the logger thread sleeps when there is nothing to write.
+ */
+static const std::chrono::milliseconds s_idleWait(5);
+
+static std::atomic<uint32_t> s_nextThreadId{ 0 };
+static thread_local uint32_t t_threadId = UINT32_MAX;
+
+static int64_t
+nowNanoseconds() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Logger&
+Logger::getInstance() {
+	static Logger s_instance;
+	return s_instance;
+}
+
+Logger::Logger()
+	: m_records(new Record[s_ringCapacity]),
+	m_mask(s_ringCapacity - 1),
+	m_epoch(nowNanoseconds()) {
+	for (size_t i = 0; i < s_ringCapacity; ++i) {
+		m_records[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	m_thread = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger() {
+	m_running.store(false, std::memory_order_release);
+	m_wakeCondition.notify_one();
+	if (m_thread.joinable()) {
+		m_thread.join();
+	}
+}
+
+bool
+Logger::setLogFile(const std::string& path) {
+	std::lock_guard<std::mutex> lock(m_fileMutex);
+	if (m_file.is_open()) {
+		m_file.close();
+	}
+	if (path.empty()) {
+		return true;
+	}
+	m_file.open(path, std::ios::out | std::ios::app);
+	return m_file.is_open();
+}
+
+void
+Logger::flush() {
+	const uint64_t target = m_enqueuePos.load(std::memory_order_acquire);
+	while (m_dequeuePos.load(std::memory_order_acquire) < target &&
+		m_running.load(std::memory_order_acquire)) {
+		m_wakeCondition.notify_one();
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+}
+
+Logger::Record*
+Logger::acquire(LogLevel level) {
+	if (t_threadId == UINT32_MAX) {
+		t_threadId = s_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Bounded MPMC queue: a slot is free when its sequence equals the position
+	uint64_t position = m_enqueuePos.load(std::memory_order_relaxed);
+	Record* record = nullptr;
+	while (true) {
+		record = &m_records[position & m_mask];
+		const uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+		const int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+		if (difference == 0) {
+			if (m_enqueuePos.compare_exchange_weak(position, position + 1,
+				std::memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if (difference < 0) {
+			// Full: drop, unless the message is fatal and worth waiting for
+			if (level < LOG_LEVEL_ERROR) {
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			m_wakeCondition.notify_one();
+			std::this_thread::yield();
+			position = m_enqueuePos.load(std::memory_order_relaxed);
+		}
+		else {
+			position = m_enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	record->time = nowNanoseconds() - m_epoch;
+	record->thread = t_threadId;
+	record->level = static_cast<uint8_t>(level);
+	record->truncated = false;
+	record->size = 0;
+	return record;
+}
+
+void
+Logger::commit(Record* record) {
+	const uint64_t position = record->sequence.load(std::memory_order_relaxed);
+	record->sequence.store(position + 1, std::memory_order_release);
+}
+
+void
+Logger::run() {
+	while (true) {
+		if (drain() > 0) {
+			continue;
+		}
+		if (!m_running.load(std::memory_order_acquire)) {
+			break;
+		}
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wakeCondition.wait_for(lock, s_idleWait);
+	}
+
+	// Messages published while stopping
+	drain();
+}
+
+size_t
+Logger::drain() {
+	std::string text;
+	size_t count = 0;
+
+	// At most one lap per call, so a busy producer cannot keep the text
+	// from being written
+	uint64_t position = m_dequeuePos.load(std::memory_order_relaxed);
+	while (count < s_ringCapacity) {
+		Record& record = m_records[position & m_mask];
+		if (record.sequence.load(std::memory_order_acquire) != position + 1) {
+			break;
+		}
+		format(record, text);
+
+		// Give the slot back for the next lap of the ring
+		record.sequence.store(position + s_ringCapacity, std::memory_order_release);
+		++position;
+		++count;
+	}
+
+	const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+	if (dropped != m_reportedDrops) {
+		text += "[WARNING] Logger::drain : " + std::to_string(dropped - m_reportedDrops) +
+			" messages dropped, the log buffer was full\n";
+		m_reportedDrops = dropped;
+	}
+
+	if (!text.empty()) {
+		if (m_console.load(std::memory_order_relaxed)) {
+			std::cerr << text;
+			std::cerr.flush();
+		}
+		std::lock_guard<std::mutex> lock(m_fileMutex);
+		if (m_file.is_open()) {
+			m_file << text;
+			m_file.flush();
+		}
+	}
+
+	// Published last, so flush() returns only once the text is out
+	m_dequeuePos.store(position, std::memory_order_release);
+	return count;
+}
+
+void
+Logger::format(const Record& record, std::string& text) const {
+	static const char* const s_levelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+	// to_chars instead of a stream or printf: this runs for every message
+	char number[64];
+	auto append = [&text, &number](const std::to_chars_result& result) {
+		text.append(number, result.ptr);
+	};
+
+	// [seconds.milliseconds][thread][level]
+	const int64_t milliseconds = record.time / 1000000;
+	const int fraction = static_cast<int>(milliseconds % 1000);
+	std::to_chars_result seconds = std::to_chars(number, number + sizeof(number), milliseconds / 1000);
+	text += '[';
+	text.append(std::max<ptrdiff_t>(0, 6 - (seconds.ptr - number)), ' ');
+	append(seconds);
+	text += '.';
+	text += static_cast<char>('0' + fraction / 100);
+	text += static_cast<char>('0' + fraction / 10 % 10);
+	text += static_cast<char>('0' + fraction % 10);
+	text += "][T";
+	append(std::to_chars(number, number + sizeof(number), record.thread));
+	text += "][";
+	text += s_levelNames[record.level & 3];
+	text += "] ";
+
+	// Fields: class, method, then the message
+	int field = 0;
+	size_t offset = 0;
+	while (offset < record.size) {
+		const uint8_t tag = static_cast<uint8_t>(record.data[offset++]);
+		switch (tag) {
+		case LogWriter::TAG_FIELD:
+			text += field++ == 0 ? "::" : " : ";
+			break;
+		case LogWriter::TAG_STRING: {
+			uint16_t length;
+			std::memcpy(&length, record.data + offset, sizeof(length));
+			offset += sizeof(length);
+			text.append(record.data + offset, length);
+			offset += length;
+			break;
+		}
+		case LogWriter::TAG_INT: {
+			int64_t value;
+			std::memcpy(&value, record.data + offset, sizeof(value));
+			offset += sizeof(value);
+			append(std::to_chars(number, number + sizeof(number), value));
+			break;
+		}
+		case LogWriter::TAG_UINT: {
+			uint64_t value;
+			std::memcpy(&value, record.data + offset, sizeof(value));
+			offset += sizeof(value);
+			append(std::to_chars(number, number + sizeof(number), value));
+			break;
+		}
+		case LogWriter::TAG_DOUBLE: {
+			// 6 significant digits, like the default ostream
+			double value;
+			std::memcpy(&value, record.data + offset, sizeof(value));
+			offset += sizeof(value);
+			append(std::to_chars(number, number + sizeof(number), value,
+				std::chars_format::general, 6));
+			break;
+		}
+		case LogWriter::TAG_CHAR:
+			text += record.data[offset++];
+			break;
+		case LogWriter::TAG_BOOL: {
+			bool value;
+			std::memcpy(&value, record.data + offset, sizeof(value));
+			offset += sizeof(value);
+			text += value ? '1' : '0';
+			break;
+		}
+		default:
+			// Unknown tag: the rest cannot be decoded
+			offset = record.size;
+			break;
+		}
+	}
+	if (record.truncated) {
+		text += "...";
+	}
+	text += '\n';
+}
@@ -0,0 +1,143 @@
+#include "LooseQuadtree.h"
+#include <algorithm>
+#include <cmath>
+
+LooseQuadtree::LooseQuadtree(const sf::FloatRect& worldBounds, unsigned int maxDepth) {
+	if (worldBounds.width <= 0.f || worldBounds.height <= 0.f) {
+		ERROR("LooseQuadtree", "LooseQuadtree", "World bounds must have a positive size");
+	}
+
+	// The traversal stack in visit() holds up to 3 nodes per level
+	m_maxDepth = std::min(maxDepth, 60u);
+
+	Node root;
+	root.center = sf::Vector2f(worldBounds.left + worldBounds.width / 2.f,
+		worldBounds.top + worldBounds.height / 2.f);
+	root.halfSize = std::max(worldBounds.width, worldBounds.height) / 2.f;
+	root.parent = -1;
+	std::fill(std::begin(root.children), std::end(root.children), -1);
+	root.subtreeCount = 0;
+	m_nodes.push_back(std::move(root));
+}
+
+void
+LooseQuadtree::update(EntityID entity, const sf::FloatRect& bounds) {
+	if (entity >= m_records.size()) {
+		m_records.resize(entity + 1);
+	}
+
+	Record& record = m_records[entity];
+	if (record.node >= 0) {
+		// Still fits the same node: just refresh the stored bounds
+		if (findNode(bounds, false) == record.node) {
+			m_nodes[record.node].items[record.slot].bounds = bounds;
+			return;
+		}
+		detach(record);
+	}
+
+	const int target = findNode(bounds, true);
+	Node& node = m_nodes[target];
+	record.node = target;
+	record.slot = static_cast<uint32_t>(node.items.size());
+	node.items.push_back({ entity, bounds });
+
+	for (int index = target; index >= 0; index = m_nodes[index].parent) {
+		++m_nodes[index].subtreeCount;
+	}
+	++m_itemCount;
+}
+
+void
+LooseQuadtree::remove(EntityID entity) {
+	if (entity < m_records.size() && m_records[entity].node >= 0) {
+		detach(m_records[entity]);
+	}
+}
+
+void
+LooseQuadtree::clear() {
+	for (Node& node : m_nodes) {
+		node.items.clear();
+		node.subtreeCount = 0;
+	}
+	m_records.clear();
+	m_itemCount = 0;
+}
+
+bool
+LooseQuadtree::pick(const sf::Vector2f& point, EntityID& entity) const {
+	bool found = false;
+	visit(
+		[&point](const sf::FloatRect& loose) { return loose.contains(point); },
+		[&](const Item& item) {
+			if (item.bounds.contains(point) && (!found || item.entity > entity)) {
+				entity = item.entity;
+				found = true;
+			}
+		});
+	return found;
+}
+
+int
+LooseQuadtree::findNode(const sf::FloatRect& bounds, bool create) {
+	const sf::Vector2f center(bounds.left + bounds.width / 2.f, bounds.top + bounds.height / 2.f);
+	const float extent = std::max(bounds.width, bounds.height) / 2.f;
+
+	int index = 0;
+	const Node& root = m_nodes[0];
+	if (std::abs(center.x - root.center.x) > root.halfSize ||
+		std::abs(center.y - root.center.y) > root.halfSize) {
+		return 0;
+	}
+
+	for (unsigned int depth = 0; depth < m_maxDepth; ++depth) {
+		const float childHalf = m_nodes[index].halfSize / 2.f;
+
+		// The object must fit the loose bounds of the child (2x its cell)
+		if (extent > childHalf) {
+			break;
+		}
+
+		const sf::Vector2f nodeCenter = m_nodes[index].center;
+		const int quadrant = (center.x >= nodeCenter.x ? 1 : 0) + (center.y >= nodeCenter.y ? 2 : 0);
+		int child = m_nodes[index].children[quadrant];
+		if (child < 0) {
+			if (!create) {
+				return -1;
+			}
+
+			Node node;
+			node.center = sf::Vector2f(nodeCenter.x + ((quadrant & 1) ? childHalf : -childHalf),
+				nodeCenter.y + ((quadrant & 2) ? childHalf : -childHalf));
+			node.halfSize = childHalf;
+			node.parent = index;
+			std::fill(std::begin(node.children), std::end(node.children), -1);
+			node.subtreeCount = 0;
+
+			child = static_cast<int>(m_nodes.size());
+			m_nodes.push_back(std::move(node));
+			m_nodes[index].children[quadrant] = child;
+		}
+		index = child;
+	}
+	return index;
+}
+
+void
+LooseQuadtree::detach(Record& record) {
+	Node& node = m_nodes[record.node];
+
+	// Swap-remove and fix the record of the item moved into the hole
+	if (record.slot + 1 != node.items.size()) {
+		node.items[record.slot] = node.items.back();
+		m_records[node.items[record.slot].entity].slot = record.slot;
+	}
+	node.items.pop_back();
+
+	for (int index = record.node; index >= 0; index = m_nodes[index].parent) {
+		--m_nodes[index].subtreeCount;
+	}
+	--m_itemCount;
+	record.node = -1;
+}
@@ -0,0 +1,103 @@
+#include "NavMesh.h"
+#include <algorithm>
+
+size_t
+NavMesh::addPolygon(const std::vector<sf::Vector2f>& points) {
+	if (points.size() < 3) {
+		ERROR("NavMesh", "addPolygon", "A polygon needs at least 3 points");
+	}
+
+	Polygon polygon;
+	polygon.points = points;
+
+	// Positive signed area, so the inside is on the left of every edge
+	float area = 0.f;
+	for (size_t i = 0; i < points.size(); ++i) {
+		const sf::Vector2f& a = points[i];
+		const sf::Vector2f& b = points[(i + 1) % points.size()];
+		area += a.x * b.y - b.x * a.y;
+	}
+	if (area < 0.f) {
+		std::reverse(polygon.points.begin(), polygon.points.end());
+	}
+
+	sf::Vector2f sum;
+	sf::Vector2f low = polygon.points[0];
+	sf::Vector2f high = polygon.points[0];
+	for (const sf::Vector2f& point : polygon.points) {
+		sum += point;
+		low.x = std::min(low.x, point.x);
+		low.y = std::min(low.y, point.y);
+		high.x = std::max(high.x, point.x);
+		high.y = std::max(high.y, point.y);
+	}
+	polygon.center = sum / static_cast<float>(polygon.points.size());
+	polygon.bounds = sf::FloatRect(low, high - low);
+
+	// Leaving through edge a -> b, the inside is behind: b is on the left
+	polygon.edges.resize(polygon.points.size());
+	for (size_t i = 0; i < polygon.points.size(); ++i) {
+		polygon.edges[i].right = polygon.points[i];
+		polygon.edges[i].left = polygon.points[(i + 1) % polygon.points.size()];
+	}
+
+	m_polygons.push_back(std::move(polygon));
+	++m_version;
+	return m_polygons.size() - 1;
+}
+
+void
+NavMesh::build() {
+	using Point = std::pair<float, float>;
+	std::map<std::pair<Point, Point>, std::pair<size_t, size_t>> openEdges;
+
+	for (size_t p = 0; p < m_polygons.size(); ++p) {
+		std::vector<Edge>& edges = m_polygons[p].edges;
+		for (size_t e = 0; e < edges.size(); ++e) {
+			edges[e].neighbor = -1;
+			Point a(edges[e].right.x, edges[e].right.y);
+			Point b(edges[e].left.x, edges[e].left.y);
+			auto key = a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+
+			auto found = openEdges.find(key);
+			if (found == openEdges.end()) {
+				openEdges.emplace(key, std::make_pair(p, e));
+				continue;
+			}
+			const size_t other = found->second.first;
+			edges[e].neighbor = static_cast<int>(other);
+			m_polygons[other].edges[found->second.second].neighbor = static_cast<int>(p);
+			openEdges.erase(found);
+		}
+	}
+	++m_version;
+}
+
+void
+NavMesh::clear() {
+	m_polygons.clear();
+	++m_version;
+}
+
+int
+NavMesh::findPolygon(const sf::Vector2f& point) const {
+	for (size_t p = 0; p < m_polygons.size(); ++p) {
+		const Polygon& polygon = m_polygons[p];
+		const sf::FloatRect& bounds = polygon.bounds;
+		if (point.x < bounds.left || point.y < bounds.top ||
+			point.x > bounds.left + bounds.width || point.y > bounds.top + bounds.height) {
+			continue;
+		}
+
+		bool inside = true;
+		for (size_t i = 0; i < polygon.points.size() && inside; ++i) {
+			const sf::Vector2f& a = polygon.points[i];
+			const sf::Vector2f& b = polygon.points[(i + 1) % polygon.points.size()];
+			inside = (b.x - a.x) * (point.y - a.y) - (b.y - a.y) * (point.x - a.x) >= 0.f;
+		}
+		if (inside) {
+			return static_cast<int>(p);
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,58 @@
+#include "NavigationGrid.h"
+#include <algorithm>
+#include <cmath>
+
+NavigationGrid::NavigationGrid(int width, int height, float cellSize, const sf::Vector2f& origin)
+	: m_cellSize(cellSize) {
+	resize(width, height, cellSize, origin);
+}
+
+void
+NavigationGrid::resize(int width, int height, float cellSize, const sf::Vector2f& origin) {
+	if (width < 0 || height < 0 || cellSize <= 0.f) {
+		ERROR("NavigationGrid", "resize", "Invalid grid size");
+	}
+	m_width = width;
+	m_height = height;
+	m_cellSize = cellSize;
+	m_origin = origin;
+	m_walkable.assign(static_cast<size_t>(width) * height, 1);
+	++m_version;
+}
+
+void
+NavigationGrid::setWalkable(int x, int y, bool walkable) {
+	if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+		return;
+	}
+	uint8_t& cell = m_walkable[static_cast<size_t>(y) * m_width + x];
+	if (cell != static_cast<uint8_t>(walkable)) {
+		cell = static_cast<uint8_t>(walkable);
+		++m_version;
+	}
+}
+
+void
+NavigationGrid::setWalkable(const sf::FloatRect& area, bool walkable) {
+	const sf::Vector2i first = worldToCell(sf::Vector2f(area.left, area.top));
+	const sf::Vector2i last = worldToCell(sf::Vector2f(area.left + area.width, area.top + area.height));
+	for (int y = std::max(first.y, 0); y <= std::min(last.y, m_height - 1); ++y) {
+		for (int x = std::max(first.x, 0); x <= std::min(last.x, m_width - 1); ++x) {
+			setWalkable(x, y, walkable);
+		}
+	}
+}
+
+sf::Vector2i
+NavigationGrid::worldToCell(const sf::Vector2f& position) const {
+	return sf::Vector2i(
+		static_cast<int>(std::floor((position.x - m_origin.x) / m_cellSize)),
+		static_cast<int>(std::floor((position.y - m_origin.y) / m_cellSize)));
+}
+
+sf::Vector2f
+NavigationGrid::cellToWorld(const sf::Vector2i& cell) const {
+	return sf::Vector2f(
+		m_origin.x + (cell.x + 0.5f) * m_cellSize,
+		m_origin.y + (cell.y + 0.5f) * m_cellSize);
+}
@@ -0,0 +1,679 @@
+#include "PathfindingService.h"
+#include "ESC/PathFollower.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace {
+	const uint32_t NO_NODE = UINT32_MAX;
+	const float DIAGONAL_COST = 1.41421356f;
+
+	/**
+	 * @brief Grid distance with 8 directions (octile), in cells.
+	 */
+	float
+		octileDistance(int ax, int ay, int bx, int by) {
+		const int dx = std::abs(ax - bx);
+		const int dy = std::abs(ay - by);
+		return static_cast<float>(std::max(dx, dy)) +
+			(DIAGONAL_COST - 1.f) * static_cast<float>(std::min(dx, dy));
+	}
+
+	float
+		distance(const sf::Vector2f& a, const sf::Vector2f& b) {
+		return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+	}
+
+	/**
+	 * @brief z of the cross product of two vectors (> 0: b is counter-clockwise of a).
+	 */
+	float
+		cross(const sf::Vector2f& a, const sf::Vector2f& b) {
+		return a.x * b.y - a.y * b.x;
+	}
+
+	int
+		sign(int value) {
+		return (value > 0) - (value < 0);
+	}
+
+	/**
+	 * @brief The request path ends at the exact goal instead of its cell center.
+	 */
+	void
+		endAtGoal(std::vector<sf::Vector2f>& path, const sf::Vector2f& goal) {
+		if (path.empty()) {
+			path.push_back(goal);
+		}
+		else {
+			path.back() = goal;
+		}
+	}
+}
+
+PathfindingService::PathfindingService(JobSystem& jobs)
+	: m_jobs(jobs) {
+}
+
+PathfindingService::~PathfindingService() {
+	m_jobs.wait(m_batchJobs);
+}
+
+void
+PathfindingService::setGrid(const NavigationGrid* grid) {
+	m_grid = grid;
+	m_cache.clear();
+	m_cacheOrder.clear();
+	m_cacheGridVersion = grid ? grid->getVersion() : 0;
+}
+
+void
+PathfindingService::setNavMesh(const NavMesh* navMesh) {
+	m_navMesh = navMesh;
+}
+
+bool
+PathfindingService::findPath(const sf::Vector2f& start, const sf::Vector2f& goal,
+	std::vector<sf::Vector2f>& path, PathAlgorithm algorithm) {
+	validateCache();
+	++m_stats.requests;
+
+	Request request;
+	request.start = start;
+	request.goal = goal;
+	request.algorithm = algorithm;
+	if (!readCache(request)) {
+		search(request);
+		++m_stats.searches;
+		m_stats.expandedNodes += request.expandedNodes;
+		if (request.found && algorithm != PATH_NAVMESH) {
+			writeCache(request);
+			endAtGoal(request.path, goal);
+		}
+	}
+	if (!request.found) {
+		++m_stats.failures;
+	}
+	path = std::move(request.path);
+	return request.found;
+}
+
+void
+PathfindingService::requestPath(EntityID entity, const sf::Vector2f& start, const sf::Vector2f& goal,
+	PathAlgorithm algorithm) {
+	++m_stats.requests;
+	auto found = m_pendingIndex.find(entity);
+	if (found == m_pendingIndex.end()) {
+		m_pendingIndex.emplace(entity, m_pending.size());
+		m_pending.emplace_back();
+	}
+	Request& request = found == m_pendingIndex.end() ? m_pending.back() : m_pending[found->second];
+	request.entity = entity;
+	request.start = start;
+	request.goal = goal;
+	request.algorithm = algorithm;
+}
+
+void
+PathfindingService::update(World& world) {
+	PROFILE_SCOPE("PathfindingService::update");
+	const bool workers = m_jobs.getThreadCount() > 1;
+
+	// Previous batch: deliver it once the workers are done with it
+	if (!m_batch.empty()) {
+		if (workers && !m_batchJobs.isDone()) {
+			return;
+		}
+		m_jobs.wait(m_batchJobs);
+		for (Request& request : m_batch) {
+			deliver(world, request);
+		}
+		m_batch.clear();
+	}
+
+	validateCache();
+	if (m_pending.empty()) {
+		return;
+	}
+
+	// Oldest requests first; cached paths need no search
+	const size_t count = std::min(m_pending.size(), m_maxBatchSize);
+	for (size_t i = 0; i < count; ++i) {
+		Request& request = m_pending[i];
+		if (readCache(request)) {
+			deliver(world, request);
+		}
+		else {
+			m_batch.push_back(std::move(request));
+		}
+	}
+	m_pending.erase(m_pending.begin(), m_pending.begin() + count);
+	m_pendingIndex.clear();
+	for (size_t i = 0; i < m_pending.size(); ++i) {
+		m_pendingIndex[m_pending[i].entity] = i;
+	}
+
+	if (m_batch.empty()) {
+		return;
+	}
+	if (!workers) {
+		// Jobs would only run inside wait(): search right away
+		for (Request& request : m_batch) {
+			search(request);
+			deliver(world, request);
+		}
+		m_batch.clear();
+		return;
+	}
+
+	// A few requests per job; results are picked up by a later update()
+	const size_t jobCount = std::min(m_batch.size(), static_cast<size_t>(m_jobs.getThreadCount()) * 4);
+	const size_t perJob = (m_batch.size() + jobCount - 1) / jobCount;
+	for (size_t first = 0; first < m_batch.size(); first += perJob) {
+		const size_t last = std::min(first + perJob, m_batch.size());
+		m_jobs.scheduleBackground([this, first, last]() {
+			for (size_t i = first; i < last; ++i) {
+				search(m_batch[i]);
+			}
+		}, &m_batchJobs);
+	}
+}
+
+void
+PathfindingService::flush(World& world) {
+	m_jobs.wait(m_batchJobs);
+	for (Request& request : m_batch) {
+		deliver(world, request);
+	}
+	m_batch.clear();
+}
+
+void
+PathfindingService::setCacheCapacity(size_t capacity) {
+	m_cacheCapacity = capacity;
+	while (m_cache.size() > m_cacheCapacity) {
+		m_cache.erase(m_cacheOrder.back());
+		m_cacheOrder.pop_back();
+	}
+}
+
+void
+PathfindingService::search(Request& request) {
+	SearchContext* context = acquireContext();
+	request.path.clear();
+	request.searched = true;
+	request.expandedNodes = 0;
+	if (request.algorithm == PATH_NAVMESH) {
+		request.found = m_navMesh &&
+			searchNavMesh(request.start, request.goal, *context, request.path, request.expandedNodes);
+	}
+	else {
+		request.found = m_grid &&
+			searchGrid(m_grid->worldToCell(request.start), m_grid->worldToCell(request.goal),
+				request.algorithm == PATH_JUMP_POINT, *context, request.path, request.expandedNodes);
+	}
+	releaseContext(context);
+}
+
+bool
+PathfindingService::searchGrid(const sf::Vector2i& start, const sf::Vector2i& goal, bool jumpPoints,
+	SearchContext& context, std::vector<sf::Vector2f>& path, uint64_t& expanded) const {
+	const NavigationGrid& grid = *m_grid;
+	if (!grid.isWalkable(start.x, start.y) || !grid.isWalkable(goal.x, goal.y)) {
+		return false;
+	}
+
+	const int width = grid.getWidth();
+	const uint32_t startNode = static_cast<uint32_t>(start.y * width + start.x);
+	const uint32_t goalNode = static_cast<uint32_t>(goal.y * width + goal.x);
+	beginSearch(context, grid.getCellCount());
+
+	auto touch = [&context](uint32_t node) {
+		if (context.stamp[node] != context.search) {
+			context.stamp[node] = context.search;
+			context.cost[node] = std::numeric_limits<float>::max();
+			context.closed[node] = 0;
+		}
+	};
+	auto relax = [&](uint32_t node, uint32_t from, float cost) {
+		touch(node);
+		if (context.closed[node] || cost >= context.cost[node]) {
+			return;
+		}
+		context.cost[node] = cost;
+		context.parent[node] = from;
+		const int x = static_cast<int>(node % width);
+		const int y = static_cast<int>(node / width);
+		context.open.push_back(OpenNode{ cost + octileDistance(x, y, goal.x, goal.y), node });
+		std::push_heap(context.open.begin(), context.open.end(), std::greater<OpenNode>());
+	};
+
+	touch(startNode);
+	context.cost[startNode] = 0.f;
+	context.parent[startNode] = NO_NODE;
+	context.open.push_back(OpenNode{ octileDistance(start.x, start.y, goal.x, goal.y), startNode });
+
+	static const int directions[8][2] = {
+		{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+
+	bool found = false;
+	while (!context.open.empty()) {
+		std::pop_heap(context.open.begin(), context.open.end(), std::greater<OpenNode>());
+		const uint32_t node = context.open.back().node;
+		context.open.pop_back();
+		if (context.closed[node]) {
+			continue;
+		}
+		if (node == goalNode) {
+			found = true;
+			break;
+		}
+		context.closed[node] = 1;
+		++expanded;
+
+		const int x = static_cast<int>(node % width);
+		const int y = static_cast<int>(node / width);
+		const float cost = context.cost[node];
+
+		if (!jumpPoints) {
+			for (const auto& direction : directions) {
+				const int dx = direction[0];
+				const int dy = direction[1];
+				if (!grid.isWalkable(x + dx, y + dy)) {
+					continue;
+				}
+				// No cutting blocked corners
+				if (dx != 0 && dy != 0 && (!grid.isWalkable(x + dx, y) || !grid.isWalkable(x, y + dy))) {
+					continue;
+				}
+				relax(static_cast<uint32_t>((y + dy) * width + x + dx), node,
+					cost + (dx != 0 && dy != 0 ? DIAGONAL_COST : 1.f));
+			}
+			continue;
+		}
+
+		// Jump point search: only the directions that can lead somewhere the
+		// parent could not reach as cheaply
+		int candidates[8][2];
+		int candidateCount = 0;
+		auto add = [&](int dx, int dy) {
+			candidates[candidateCount][0] = dx;
+			candidates[candidateCount][1] = dy;
+			++candidateCount;
+		};
+		const uint32_t parent = context.parent[node];
+		if (parent == NO_NODE) {
+			for (const auto& direction : directions) {
+				const int dx = direction[0];
+				const int dy = direction[1];
+				if (grid.isWalkable(x + dx, y + dy) &&
+					(dx == 0 || dy == 0 || (grid.isWalkable(x + dx, y) && grid.isWalkable(x, y + dy)))) {
+					add(dx, dy);
+				}
+			}
+		}
+		else {
+			const int dx = sign(x - static_cast<int>(parent % width));
+			const int dy = sign(y - static_cast<int>(parent / width));
+			if (dx != 0 && dy != 0) {
+				const bool vertical = grid.isWalkable(x, y + dy);
+				const bool horizontal = grid.isWalkable(x + dx, y);
+				if (vertical) add(0, dy);
+				if (horizontal) add(dx, 0);
+				if (vertical && horizontal && grid.isWalkable(x + dx, y + dy)) add(dx, dy);
+			}
+			else if (dx != 0) {
+				const bool next = grid.isWalkable(x + dx, y);
+				const bool below = grid.isWalkable(x, y + 1);
+				const bool above = grid.isWalkable(x, y - 1);
+				if (next) {
+					add(dx, 0);
+					if (below && grid.isWalkable(x + dx, y + 1)) add(dx, 1);
+					if (above && grid.isWalkable(x + dx, y - 1)) add(dx, -1);
+				}
+				if (below) add(0, 1);
+				if (above) add(0, -1);
+			}
+			else {
+				const bool next = grid.isWalkable(x, y + dy);
+				const bool right = grid.isWalkable(x + 1, y);
+				const bool left = grid.isWalkable(x - 1, y);
+				if (next) {
+					add(0, dy);
+					if (right && grid.isWalkable(x + 1, y + dy)) add(1, dy);
+					if (left && grid.isWalkable(x - 1, y + dy)) add(-1, dy);
+				}
+				if (right) add(1, 0);
+				if (left) add(-1, 0);
+			}
+		}
+
+		for (int i = 0; i < candidateCount; ++i) {
+			const uint32_t jumpNode = jump(x + candidates[i][0], y + candidates[i][1],
+				candidates[i][0], candidates[i][1], goal);
+			if (jumpNode == NO_NODE) {
+				continue;
+			}
+			const int jx = static_cast<int>(jumpNode % width);
+			const int jy = static_cast<int>(jumpNode / width);
+			relax(jumpNode, node, cost + octileDistance(x, y, jx, jy));
+		}
+	}
+	if (!found) {
+		return false;
+	}
+
+	// Walk back to the start, keeping only the cells where the direction
+	// changes (jump points already are)
+	std::vector<sf::Vector2i> cells;
+	for (uint32_t node = goalNode; node != NO_NODE; node = context.parent[node]) {
+		cells.push_back(sf::Vector2i(static_cast<int>(node % width), static_cast<int>(node / width)));
+	}
+	std::reverse(cells.begin(), cells.end());
+	for (size_t i = 1; i < cells.size(); ++i) {
+		if (i + 1 < cells.size()) {
+			const sf::Vector2i in(sign(cells[i].x - cells[i - 1].x), sign(cells[i].y - cells[i - 1].y));
+			const sf::Vector2i out(sign(cells[i + 1].x - cells[i].x), sign(cells[i + 1].y - cells[i].y));
+			if (in == out) {
+				continue;
+			}
+		}
+		path.push_back(grid.cellToWorld(cells[i]));
+	}
+	return true;
+}
+
+uint32_t
+PathfindingService::jump(int x, int y, int dx, int dy, const sf::Vector2i& goal) const {
+	const NavigationGrid& grid = *m_grid;
+	while (true) {
+		if (!grid.isWalkable(x, y)) {
+			return NO_NODE;
+		}
+		const uint32_t node = static_cast<uint32_t>(y * grid.getWidth() + x);
+		if (x == goal.x && y == goal.y) {
+			return node;
+		}
+
+		if (dx != 0 && dy != 0) {
+			// A diagonal stops where a straight jump finds something
+			if (jump(x + dx, y, dx, 0, goal) != NO_NODE || jump(x, y + dy, 0, dy, goal) != NO_NODE) {
+				return node;
+			}
+		}
+		else if (dx != 0) {
+			// Forced neighbour: a wall beside the path just ended
+			if ((grid.isWalkable(x, y - 1) && !grid.isWalkable(x - dx, y - 1)) ||
+				(grid.isWalkable(x, y + 1) && !grid.isWalkable(x - dx, y + 1))) {
+				return node;
+			}
+		}
+		else {
+			if ((grid.isWalkable(x - 1, y) && !grid.isWalkable(x - 1, y - dy)) ||
+				(grid.isWalkable(x + 1, y) && !grid.isWalkable(x + 1, y - dy))) {
+				return node;
+			}
+		}
+
+		// Diagonal steps may not cut corners
+		if (!grid.isWalkable(x + dx, y) || !grid.isWalkable(x, y + dy)) {
+			return NO_NODE;
+		}
+		x += dx;
+		y += dy;
+	}
+}
+
+bool
+PathfindingService::searchNavMesh(const sf::Vector2f& start, const sf::Vector2f& goal,
+	SearchContext& context, std::vector<sf::Vector2f>& path, uint64_t& expanded) const {
+	const NavMesh& mesh = *m_navMesh;
+	const int startPolygon = mesh.findPolygon(start);
+	const int goalPolygon = mesh.findPolygon(goal);
+	if (startPolygon < 0 || goalPolygon < 0) {
+		return false;
+	}
+	if (startPolygon == goalPolygon) {
+		path.push_back(goal);
+		return true;
+	}
+
+	// A* over the polygons, from center to center
+	beginSearch(context, mesh.getPolygonCount());
+	const uint32_t startNode = static_cast<uint32_t>(startPolygon);
+	const uint32_t goalNode = static_cast<uint32_t>(goalPolygon);
+	context.stamp[startNode] = context.search;
+	context.cost[startNode] = 0.f;
+	context.parent[startNode] = NO_NODE;
+	context.closed[startNode] = 0;
+	context.open.push_back(OpenNode{ distance(mesh.getCenter(startNode), goal), startNode });
+
+	bool found = false;
+	while (!context.open.empty()) {
+		std::pop_heap(context.open.begin(), context.open.end(), std::greater<OpenNode>());
+		const uint32_t node = context.open.back().node;
+		context.open.pop_back();
+		if (context.closed[node]) {
+			continue;
+		}
+		if (node == goalNode) {
+			found = true;
+			break;
+		}
+		context.closed[node] = 1;
+		++expanded;
+
+		for (const NavMesh::Edge& edge : mesh.getEdges(node)) {
+			if (edge.neighbor < 0) {
+				continue;
+			}
+			const uint32_t next = static_cast<uint32_t>(edge.neighbor);
+			if (context.stamp[next] != context.search) {
+				context.stamp[next] = context.search;
+				context.cost[next] = std::numeric_limits<float>::max();
+				context.closed[next] = 0;
+			}
+			const float cost = context.cost[node] + distance(mesh.getCenter(node), mesh.getCenter(next));
+			if (context.closed[next] || cost >= context.cost[next]) {
+				continue;
+			}
+			context.cost[next] = cost;
+			context.parent[next] = node;
+			context.open.push_back(OpenNode{ cost + distance(mesh.getCenter(next), goal), next });
+			std::push_heap(context.open.begin(), context.open.end(), std::greater<OpenNode>());
+		}
+	}
+	if (!found) {
+		return false;
+	}
+
+	// Portals crossed along the polygon corridor
+	std::vector<uint32_t> corridor;
+	for (uint32_t node = goalNode; node != NO_NODE; node = context.parent[node]) {
+		corridor.push_back(node);
+	}
+	std::reverse(corridor.begin(), corridor.end());
+
+	std::vector<std::pair<sf::Vector2f, sf::Vector2f>> portals; // left, right
+	portals.emplace_back(start, start);
+	for (size_t i = 0; i + 1 < corridor.size(); ++i) {
+		for (const NavMesh::Edge& edge : mesh.getEdges(corridor[i])) {
+			if (edge.neighbor == static_cast<int>(corridor[i + 1])) {
+				portals.emplace_back(edge.left, edge.right);
+				break;
+			}
+		}
+	}
+	portals.emplace_back(goal, goal);
+
+	// Funnel algorithm: keep the tightest left and right bounds seen from
+	// the apex; when one crosses the other, its corner becomes a waypoint
+	sf::Vector2f apex = start;
+	sf::Vector2f left = start;
+	sf::Vector2f right = start;
+	size_t apexIndex = 0;
+	size_t leftIndex = 0;
+	size_t rightIndex = 0;
+	for (size_t i = 1; i < portals.size(); ++i) {
+		const sf::Vector2f& portalLeft = portals[i].first;
+		const sf::Vector2f& portalRight = portals[i].second;
+
+		if (cross(right - apex, portalRight - apex) >= 0.f) {
+			if (apex == right || cross(left - apex, portalRight - apex) < 0.f) {
+				right = portalRight;
+				rightIndex = i;
+			}
+			else {
+				path.push_back(left);
+				apex = left;
+				apexIndex = leftIndex;
+				right = apex;
+				rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+
+		if (cross(left - apex, portalLeft - apex) <= 0.f) {
+			if (apex == left || cross(right - apex, portalLeft - apex) > 0.f) {
+				left = portalLeft;
+				leftIndex = i;
+			}
+			else {
+				path.push_back(right);
+				apex = right;
+				apexIndex = rightIndex;
+				left = apex;
+				leftIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+	}
+	if (path.empty() || path.back() != goal) {
+		path.push_back(goal);
+	}
+	return true;
+}
+
+void
+PathfindingService::beginSearch(SearchContext& context, size_t nodeCount) {
+	if (context.stamp.size() < nodeCount) {
+		context.cost.resize(nodeCount);
+		context.parent.resize(nodeCount);
+		context.stamp.resize(nodeCount, 0);
+		context.closed.resize(nodeCount);
+	}
+	context.open.clear();
+
+	// Stamps from older searches no longer match; clear only on wrap-around
+	if (++context.search == 0) {
+		std::fill(context.stamp.begin(), context.stamp.end(), 0);
+		context.search = 1;
+	}
+}
+
+PathfindingService::SearchContext*
+PathfindingService::acquireContext() {
+	std::lock_guard<std::mutex> lock(m_contextMutex);
+	if (m_freeContexts.empty()) {
+		m_contexts.push_back(std::make_unique<SearchContext>());
+		return m_contexts.back().get();
+	}
+	SearchContext* context = m_freeContexts.back();
+	m_freeContexts.pop_back();
+	return context;
+}
+
+void
+PathfindingService::releaseContext(SearchContext* context) {
+	std::lock_guard<std::mutex> lock(m_contextMutex);
+	m_freeContexts.push_back(context);
+}
+
+uint64_t
+PathfindingService::getCacheKey(const Request& request) const {
+	if (!m_grid || request.algorithm == PATH_NAVMESH) {
+		return 0;
+	}
+	const sf::Vector2i start = m_grid->worldToCell(request.start);
+	const sf::Vector2i goal = m_grid->worldToCell(request.goal);
+	if (!m_grid->isWalkable(start.x, start.y) || !m_grid->isWalkable(goal.x, goal.y)) {
+		return 0;
+	}
+	const uint64_t cells = m_grid->getCellCount();
+	const uint64_t startNode = static_cast<uint64_t>(start.y) * m_grid->getWidth() + start.x;
+	const uint64_t goalNode = static_cast<uint64_t>(goal.y) * m_grid->getWidth() + goal.x;
+	return ((startNode * cells + goalNode) << 1 | (request.algorithm == PATH_JUMP_POINT)) + 1;
+}
+
+bool
+PathfindingService::readCache(Request& request) {
+	const uint64_t key = m_cacheCapacity > 0 ? getCacheKey(request) : 0;
+	auto found = key != 0 ? m_cache.find(key) : m_cache.end();
+	if (found == m_cache.end()) {
+		return false;
+	}
+
+	++m_stats.cacheHits;
+	m_cacheOrder.splice(m_cacheOrder.begin(), m_cacheOrder, found->second.lruPosition);
+	request.path = found->second.path;
+	request.searched = false;
+	request.found = true;
+	request.expandedNodes = 0;
+	endAtGoal(request.path, request.goal);
+	return true;
+}
+
+void
+PathfindingService::writeCache(const Request& request) {
+	const uint64_t key = m_cacheCapacity > 0 ? getCacheKey(request) : 0;
+	if (key == 0 || m_cache.count(key) != 0) {
+		return;
+	}
+	if (m_cache.size() >= m_cacheCapacity) {
+		m_cache.erase(m_cacheOrder.back());
+		m_cacheOrder.pop_back();
+	}
+	m_cacheOrder.push_front(key);
+	CacheEntry& entry = m_cache[key];
+	entry.path = request.path;
+	entry.lruPosition = m_cacheOrder.begin();
+}
+
+void
+PathfindingService::validateCache() {
+	if (m_grid && m_grid->getVersion() != m_cacheGridVersion) {
+		m_cache.clear();
+		m_cacheOrder.clear();
+		m_cacheGridVersion = m_grid->getVersion();
+	}
+}
+
+void
+PathfindingService::deliver(World& world, Request& request) {
+	// Cache hits already end at the goal
+	if (request.searched) {
+		++m_stats.searches;
+		m_stats.expandedNodes += request.expandedNodes;
+		if (request.found && request.algorithm != PATH_NAVMESH) {
+			writeCache(request);
+			endAtGoal(request.path, request.goal);
+		}
+	}
+	if (!request.found) {
+		++m_stats.failures;
+	}
+
+	PathFollower* follower = world.getComponent<PathFollower>(request.entity);
+	if (!follower) {
+		return;
+	}
+	if (request.found) {
+		follower->setPath(std::move(request.path));
+	}
+	else {
+		follower->setPathFailed();
+	}
+}
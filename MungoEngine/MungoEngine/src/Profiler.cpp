@@ -0,0 +1,199 @@
+#include "Prerequisites.h"
+#include <algorithm>
+#include <iomanip>
+
+/**
+ * @brief Zones kept per thread (power of two). At 24 bytes per zone this
+ * holds a few seconds of a busy frame for the trace export.
+ */
+static const uint64_t s_ringCapacity = 1 << 16;
+
+/**
+ * @brief Durations kept per zone name for the rolling statistics.
+ */
+static const size_t s_statsWindow = 256;
+
+static thread_local void* t_buffer = nullptr;
+
+Profiler&
+Profiler::getInstance() {
+	static Profiler s_instance;
+	return s_instance;
+}
+
+Profiler::Profiler()
+	: m_epoch(now()) {}
+
+void
+Profiler::record(const char* name, int64_t start, int64_t end) {
+	ThreadBuffer* buffer = static_cast<ThreadBuffer*>(t_buffer);
+	if (!buffer) {
+		buffer = registerThread();
+	}
+
+	// Announce the slot before writing it so a reader can detect the overwrite
+	const uint64_t index = buffer->reserved.load(std::memory_order_relaxed);
+	buffer->reserved.store(index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Event& event = buffer->events[index & (s_ringCapacity - 1)];
+	event.name.store(name, std::memory_order_relaxed);
+	event.start.store(start, std::memory_order_relaxed);
+	event.end.store(end, std::memory_order_relaxed);
+
+	buffer->committed.store(index + 1, std::memory_order_release);
+}
+
+void
+Profiler::endFrame() {
+	std::vector<Sample> samples;
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (const auto& buffer : m_buffers) {
+		samples.clear();
+		buffer->statsRead = readEvents(*buffer, buffer->statsRead, samples);
+
+		for (const Sample& sample : samples) {
+			ZoneStats*& stats = m_statsByPointer[sample.name];
+			if (!stats) {
+				stats = &m_stats[sample.name];
+				stats->samples.reserve(s_statsWindow);
+			}
+
+			const float duration = static_cast<float>(sample.end - sample.start) / 1e6f;
+			if (stats->samples.size() < s_statsWindow) {
+				stats->samples.push_back(duration);
+			}
+			else {
+				stats->samples[stats->next] = duration;
+			}
+			stats->next = (stats->next + 1) % s_statsWindow;
+			++stats->count;
+		}
+	}
+}
+
+std::vector<Profiler::ZoneSummary>
+Profiler::getSummary() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<ZoneSummary> summary;
+	std::vector<float> sorted;
+	for (const auto& entry : m_stats) {
+		const ZoneStats& stats = entry.second;
+		if (stats.samples.empty()) {
+			continue;
+		}
+
+		sorted = stats.samples;
+		const size_t p99 = std::min(sorted.size() - 1, sorted.size() * 99 / 100);
+		std::nth_element(sorted.begin(), sorted.begin() + p99, sorted.end());
+
+		double total = 0.0;
+		float shortest = sorted[0];
+		for (float duration : sorted) {
+			total += duration;
+			shortest = std::min(shortest, duration);
+		}
+
+		summary.push_back({ entry.first, stats.count, shortest,
+			total / sorted.size(), sorted[p99] });
+	}
+	return summary;
+}
+
+void
+Profiler::printSummary() const {
+	// One log line per row; the logger formats them on its own thread
+	std::ostringstream os;
+	os << std::fixed << std::setprecision(3)
+		<< std::left << std::setw(28) << "Zone" << std::right
+		<< std::setw(10) << "Count" << std::setw(10) << "Min ms"
+		<< std::setw(10) << "Avg ms" << std::setw(10) << "P99 ms";
+	LOG_INFO("Profiler", "printSummary", os.str());
+
+	for (const ZoneSummary& zone : getSummary()) {
+		os.str("");
+		os << std::left << std::setw(28) << zone.name << std::right
+			<< std::setw(10) << zone.count << std::setw(10) << zone.minMs
+			<< std::setw(10) << zone.avgMs << std::setw(10) << zone.p99Ms;
+		LOG_INFO("Profiler", "printSummary", os.str());
+	}
+}
+
+bool
+Profiler::writeChromeTrace(const std::string& path) const {
+	std::ofstream file(path);
+	if (!file) {
+		return false;
+	}
+
+	std::vector<Sample> samples;
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Complete ("X") events, times in microseconds from startup
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (const auto& buffer : m_buffers) {
+		samples.clear();
+		readEvents(*buffer, 0, samples);
+
+		for (const Sample& sample : samples) {
+			std::string name;
+			for (const char* c = sample.name; *c; ++c) {
+				if (*c == '"' || *c == '\\') {
+					name += '\\';
+				}
+				name += *c;
+			}
+
+			file << (first ? "\n" : ",\n")
+				<< "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+				<< buffer->threadIndex
+				<< ",\"ts\":" << (sample.start - m_epoch) / 1000.0
+				<< ",\"dur\":" << (sample.end - sample.start) / 1000.0 << "}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
+
+Profiler::ThreadBuffer*
+Profiler::registerThread() {
+	auto buffer = std::make_unique<ThreadBuffer>();
+	buffer->events.reset(new Event[s_ringCapacity]);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	buffer->threadIndex = static_cast<uint32_t>(m_buffers.size());
+	m_buffers.push_back(std::move(buffer));
+	t_buffer = m_buffers.back().get();
+	return m_buffers.back().get();
+}
+
+uint64_t
+Profiler::readEvents(const ThreadBuffer& buffer, uint64_t first,
+	std::vector<Sample>& out) const {
+	const uint64_t committed = buffer.committed.load(std::memory_order_acquire);
+	if (committed > s_ringCapacity) {
+		first = std::max(first, committed - s_ringCapacity);
+	}
+
+	const size_t start = out.size();
+	for (uint64_t index = first; index < committed; ++index) {
+		const Event& event = buffer.events[index & (s_ringCapacity - 1)];
+		out.push_back({ event.name.load(std::memory_order_relaxed),
+			event.start.load(std::memory_order_relaxed),
+			event.end.load(std::memory_order_relaxed) });
+	}
+
+	// Drop the slots the owner started to overwrite while they were copied
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const uint64_t reserved = buffer.reserved.load(std::memory_order_relaxed);
+	if (reserved > s_ringCapacity && reserved - s_ringCapacity > first) {
+		const uint64_t overwritten = std::min(reserved - s_ringCapacity, committed) - first;
+		out.erase(out.begin() + start, out.begin() + start + static_cast<size_t>(overwritten));
+	}
+	return committed;
+}
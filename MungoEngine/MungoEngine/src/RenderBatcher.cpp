@@ -0,0 +1,167 @@
+#include "RenderBatcher.h"
+#include <cmath>
+#include <algorithm>
+
+/**
+ * @brief Unit normal of the edge p1 -> p2 (zero for degenerate edges).
+ */
+static sf::Vector2f
+computeNormal(const sf::Vector2f& p1, const sf::Vector2f& p2) {
+	sf::Vector2f normal(p1.y - p2.y, p2.x - p1.x);
+	float length = std::sqrt(normal.x * normal.x + normal.y * normal.y);
+	if (length != 0.f) {
+		normal /= length;
+	}
+	return normal;
+}
+
+void
+RenderBatcher::submit(const sf::Shape& shape, const sf::RenderStates& states) {
+	const std::size_t count = shape.getPointCount();
+	if (count < 3) {
+		return;
+	}
+
+	++m_shapeCount;
+	const sf::Transform transform = states.transform * shape.getTransform();
+
+	// Local points and their bounds, used for texture mapping like sf::Shape
+	m_points.resize(count);
+	m_points[0] = shape.getPoint(0);
+	sf::FloatRect bounds(m_points[0].x, m_points[0].y, 0.f, 0.f);
+	for (std::size_t i = 1; i < count; ++i) {
+		m_points[i] = shape.getPoint(i);
+		float right = std::max(bounds.left + bounds.width, m_points[i].x);
+		float bottom = std::max(bounds.top + bounds.height, m_points[i].y);
+		bounds.left = std::min(bounds.left, m_points[i].x);
+		bounds.top = std::min(bounds.top, m_points[i].y);
+		bounds.width = right - bounds.left;
+		bounds.height = bottom - bounds.top;
+	}
+	const sf::Vector2f center(bounds.left + bounds.width / 2.f, bounds.top + bounds.height / 2.f);
+
+	// Fill: triangle fan around the center, unrolled into a triangle list
+	const sf::Texture* texture = shape.getTexture();
+	const sf::IntRect& textureRect = shape.getTextureRect();
+	const sf::Color& fillColor = shape.getFillColor();
+
+	auto texCoords = [&](const sf::Vector2f& point) {
+		float xRatio = bounds.width > 0.f ? (point.x - bounds.left) / bounds.width : 0.f;
+		float yRatio = bounds.height > 0.f ? (point.y - bounds.top) / bounds.height : 0.f;
+		return sf::Vector2f(textureRect.left + textureRect.width * xRatio,
+			textureRect.top + textureRect.height * yRatio);
+	};
+
+	if (fillColor.a > 0) {
+		sf::VertexArray& fill = getBatch(texture, states).vertices;
+		const sf::Vertex centerVertex(transform.transformPoint(center), fillColor, texCoords(center));
+		for (std::size_t i = 0; i < count; ++i) {
+			const sf::Vector2f& a = m_points[i];
+			const sf::Vector2f& b = m_points[(i + 1) % count];
+			fill.append(centerVertex);
+			fill.append(sf::Vertex(transform.transformPoint(a), fillColor, texCoords(a)));
+			fill.append(sf::Vertex(transform.transformPoint(b), fillColor, texCoords(b)));
+		}
+	}
+
+	// Outline: extruded quads along the averaged edge normals (untextured)
+	const float thickness = shape.getOutlineThickness();
+	const sf::Color& outlineColor = shape.getOutlineColor();
+	if (thickness == 0.f || outlineColor.a == 0) {
+		return;
+	}
+
+	sf::VertexArray& outline = getBatch(nullptr, states).vertices;
+	auto outerPoint = [&](std::size_t i) {
+		const sf::Vector2f& p0 = m_points[(i + count - 1) % count];
+		const sf::Vector2f& p1 = m_points[i];
+		const sf::Vector2f& p2 = m_points[(i + 1) % count];
+
+		sf::Vector2f n1 = computeNormal(p0, p1);
+		sf::Vector2f n2 = computeNormal(p1, p2);
+
+		// Make sure that the normals point towards the outside of the shape
+		sf::Vector2f toCenter = center - p1;
+		if ((n1.x * toCenter.x + n1.y * toCenter.y) > 0.f) n1 = -n1;
+		if ((n2.x * toCenter.x + n2.y * toCenter.y) > 0.f) n2 = -n2;
+
+		float factor = 1.f + (n1.x * n2.x + n1.y * n2.y);
+		sf::Vector2f normal = (factor != 0.f) ? (n1 + n2) / factor : n1;
+		return p1 + normal * thickness;
+	};
+
+	for (std::size_t i = 0; i < count; ++i) {
+		std::size_t next = (i + 1) % count;
+		sf::Vertex innerA(transform.transformPoint(m_points[i]), outlineColor);
+		sf::Vertex outerA(transform.transformPoint(outerPoint(i)), outlineColor);
+		sf::Vertex innerB(transform.transformPoint(m_points[next]), outlineColor);
+		sf::Vertex outerB(transform.transformPoint(outerPoint(next)), outlineColor);
+
+		outline.append(innerA);
+		outline.append(outerA);
+		outline.append(innerB);
+		outline.append(innerB);
+		outline.append(outerA);
+		outline.append(outerB);
+	}
+}
+
+void
+RenderBatcher::flush(sf::RenderTarget& target) {
+	for (size_t i = 0; i < m_batchCount; ++i) {
+		Batch& batch = m_batches[i];
+		if (batch.vertices.getVertexCount() == 0) {
+			continue;
+		}
+
+		sf::RenderStates states(batch.blendMode);
+		states.texture = batch.texture;
+		states.shader = batch.shader;
+		target.draw(batch.vertices, states);
+		++m_drawCalls;
+		if (batch.texture != m_boundTexture) {
+			++m_textureBinds;
+			m_boundTexture = batch.texture;
+		}
+	}
+	clear();
+}
+
+void
+RenderBatcher::clear() {
+	for (size_t i = 0; i < m_batchCount; ++i) {
+		// sf::VertexArray::clear keeps the capacity for the next frame
+		m_batches[i].vertices.clear();
+	}
+	m_batchCount = 0;
+}
+
+void
+RenderBatcher::resetStats() {
+	m_drawCalls = 0;
+	m_shapeCount = 0;
+	m_textureBinds = 0;
+	m_boundTexture = nullptr;
+}
+
+RenderBatcher::Batch&
+RenderBatcher::getBatch(const sf::Texture* texture, const sf::RenderStates& states) {
+	if (m_batchCount > 0) {
+		Batch& last = m_batches[m_batchCount - 1];
+		if (last.texture == texture &&
+			last.shader == states.shader &&
+			last.blendMode == states.blendMode) {
+			return last;
+		}
+	}
+
+	if (m_batchCount == m_batches.size()) {
+		m_batches.emplace_back();
+	}
+
+	Batch& batch = m_batches[m_batchCount++];
+	batch.texture = texture;
+	batch.shader = states.shader;
+	batch.blendMode = states.blendMode;
+	return batch;
+}
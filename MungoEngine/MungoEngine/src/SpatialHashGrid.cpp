@@ -0,0 +1,222 @@
+#include "SpatialHashGrid.h"
+#include "ESC/Transform.h"
+#include <algorithm>
+#include <queue>
+
+SpatialHashGrid::SpatialHashGrid(float cellSize, size_t bucketCount) {
+	if (cellSize <= 0.f) {
+		ERROR("SpatialHashGrid", "SpatialHashGrid", "Cell size must be positive");
+	}
+
+	size_t buckets = 1;
+	while (buckets < bucketCount) {
+		buckets <<= 1;
+	}
+
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.f / cellSize;
+	m_bucketMask = buckets - 1;
+	m_bucketStart.assign(buckets + 1, 0);
+}
+
+void
+SpatialHashGrid::clear() {
+	m_pending.clear();
+	m_entries.clear();
+	std::fill(m_bucketStart.begin(), m_bucketStart.end(), 0);
+	m_maxCellX = m_minCellX - 1;
+	m_maxCellY = m_minCellY - 1;
+}
+
+void
+SpatialHashGrid::insert(EntityID entity, const sf::Vector2f& position) {
+	m_pending.push_back({ entity, position, cellCoord(position.x), cellCoord(position.y) });
+}
+
+void
+SpatialHashGrid::build() {
+	// Keep what was already built and add the new points
+	m_pending.insert(m_pending.end(), m_entries.begin(), m_entries.end());
+	m_entries.resize(m_pending.size());
+
+	// Counting sort by bucket: count, prefix sum, scatter
+	std::fill(m_bucketStart.begin(), m_bucketStart.end(), 0);
+	for (const Entry& entry : m_pending) {
+		++m_bucketStart[bucketOf(entry.cellX, entry.cellY) + 1];
+	}
+	for (size_t i = 1; i < m_bucketStart.size(); ++i) {
+		m_bucketStart[i] += m_bucketStart[i - 1];
+	}
+
+	std::vector<uint32_t> cursor(m_bucketStart.begin(), m_bucketStart.end() - 1);
+	for (const Entry& entry : m_pending) {
+		m_entries[cursor[bucketOf(entry.cellX, entry.cellY)]++] = entry;
+	}
+	m_pending.clear();
+
+	// Occupied cell range
+	if (m_entries.empty()) {
+		m_maxCellX = m_minCellX - 1;
+		m_maxCellY = m_minCellY - 1;
+		return;
+	}
+	m_minCellX = m_maxCellX = m_entries[0].cellX;
+	m_minCellY = m_maxCellY = m_entries[0].cellY;
+	for (const Entry& entry : m_entries) {
+		m_minCellX = std::min(m_minCellX, entry.cellX);
+		m_minCellY = std::min(m_minCellY, entry.cellY);
+		m_maxCellX = std::max(m_maxCellX, entry.cellX);
+		m_maxCellY = std::max(m_maxCellY, entry.cellY);
+	}
+}
+
+void
+SpatialHashGrid::rebuild(World& world) {
+	clear();
+	world.forEachEntity<Transform>([this](EntityID entity, Transform& transform) {
+		insert(entity, transform.getPosition());
+	});
+	build();
+}
+
+void
+SpatialHashGrid::queryRadius(const sf::Vector2f& center,
+	float radius,
+	std::vector<EntityID>& out) const {
+	const float radiusSquared = radius * radius;
+	auto test = [&](const Entry& entry) {
+		float dx = entry.position.x - center.x;
+		float dy = entry.position.y - center.y;
+		if (dx * dx + dy * dy <= radiusSquared) {
+			out.push_back(entry.entity);
+		}
+	};
+
+	const int minX = std::max(cellCoord(center.x - radius), m_minCellX);
+	const int maxX = std::min(cellCoord(center.x + radius), m_maxCellX);
+	const int minY = std::max(cellCoord(center.y - radius), m_minCellY);
+	const int maxY = std::min(cellCoord(center.y + radius), m_maxCellY);
+	if (minX > maxX || minY > maxY) {
+		return;
+	}
+
+	// Covering more cells than there are points: a linear scan is cheaper
+	const double cellCount = double(maxX - minX + 1) * double(maxY - minY + 1);
+	if (cellCount > double(m_entries.size())) {
+		for (const Entry& entry : m_entries) {
+			test(entry);
+		}
+		return;
+	}
+
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			visitCell(x, y, test);
+		}
+	}
+}
+
+void
+SpatialHashGrid::queryAABB(const sf::FloatRect& area, std::vector<EntityID>& out) const {
+	const float right = area.left + area.width;
+	const float bottom = area.top + area.height;
+	auto test = [&](const Entry& entry) {
+		if (entry.position.x >= area.left && entry.position.x <= right &&
+			entry.position.y >= area.top && entry.position.y <= bottom) {
+			out.push_back(entry.entity);
+		}
+	};
+
+	const int minX = std::max(cellCoord(area.left), m_minCellX);
+	const int maxX = std::min(cellCoord(right), m_maxCellX);
+	const int minY = std::max(cellCoord(area.top), m_minCellY);
+	const int maxY = std::min(cellCoord(bottom), m_maxCellY);
+	if (minX > maxX || minY > maxY) {
+		return;
+	}
+
+	const double cellCount = double(maxX - minX + 1) * double(maxY - minY + 1);
+	if (cellCount > double(m_entries.size())) {
+		for (const Entry& entry : m_entries) {
+			test(entry);
+		}
+		return;
+	}
+
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			visitCell(x, y, test);
+		}
+	}
+}
+
+void
+SpatialHashGrid::queryKNearest(const sf::Vector2f& position,
+	size_t k,
+	std::vector<EntityID>& out) const {
+	out.clear();
+	if (k == 0 || m_entries.empty()) {
+		return;
+	}
+
+	// Max-heap on distance holding the best k candidates so far
+	using Candidate = std::pair<float, EntityID>;
+	std::priority_queue<Candidate> best;
+	auto test = [&](const Entry& entry) {
+		float dx = entry.position.x - position.x;
+		float dy = entry.position.y - position.y;
+		float distanceSquared = dx * dx + dy * dy;
+		if (best.size() < k) {
+			best.push({ distanceSquared, entry.entity });
+		}
+		else if (distanceSquared < best.top().first) {
+			best.pop();
+			best.push({ distanceSquared, entry.entity });
+		}
+	};
+
+	const int centerX = cellCoord(position.x);
+	const int centerY = cellCoord(position.y);
+
+	// Rings needed to reach every occupied cell
+	const int maxRing = std::max(
+		std::max(std::abs(centerX - m_minCellX), std::abs(m_maxCellX - centerX)),
+		std::max(std::abs(centerY - m_minCellY), std::abs(m_maxCellY - centerY)));
+
+	for (int ring = 0; ring <= maxRing; ++ring) {
+		if (ring == 0) {
+			visitCell(centerX, centerY, test);
+		}
+		else {
+			for (int x = centerX - ring; x <= centerX + ring; ++x) {
+				visitCell(x, centerY - ring, test);
+				visitCell(x, centerY + ring, test);
+			}
+			for (int y = centerY - ring + 1; y <= centerY + ring - 1; ++y) {
+				visitCell(centerX - ring, y, test);
+				visitCell(centerX + ring, y, test);
+			}
+		}
+
+		// Cells beyond this ring are at least ring * cellSize away
+		if (best.size() == k) {
+			float reach = ring * m_cellSize;
+			if (best.top().first <= reach * reach) {
+				break;
+			}
+		}
+	}
+
+	out.resize(best.size());
+	for (size_t i = best.size(); i > 0; --i) {
+		out[i - 1] = best.top().second;
+		best.pop();
+	}
+}
+
+size_t
+SpatialHashGrid::bucketOf(int cellX, int cellY) const {
+	const uint32_t hash = (static_cast<uint32_t>(cellX) * 73856093u) ^
+		(static_cast<uint32_t>(cellY) * 19349663u);
+	return hash & m_bucketMask;
+}
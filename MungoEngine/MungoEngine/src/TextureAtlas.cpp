@@ -0,0 +1,319 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <climits>
+
+MaxRectsPacker::MaxRectsPacker(int width, int height)
+	: m_width(width), m_height(height) {
+	m_freeRects.push_back(sf::IntRect(0, 0, width, height));
+}
+
+bool
+MaxRectsPacker::insert(int width, int height, sf::IntRect& placed) {
+	if (width <= 0 || height <= 0) {
+		return false;
+	}
+
+	// Best Short Side Fit, ties broken by the long side
+	int bestShortSide = INT_MAX;
+	int bestLongSide = INT_MAX;
+	const sf::IntRect* best = nullptr;
+	for (const sf::IntRect& free : m_freeRects) {
+		if (free.width < width || free.height < height) {
+			continue;
+		}
+		const int leftoverX = free.width - width;
+		const int leftoverY = free.height - height;
+		const int shortSide = std::min(leftoverX, leftoverY);
+		const int longSide = std::max(leftoverX, leftoverY);
+		if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+			bestShortSide = shortSide;
+			bestLongSide = longSide;
+			best = &free;
+		}
+	}
+	if (!best) {
+		return false;
+	}
+
+	placed = sf::IntRect(best->left, best->top, width, height);
+	splitFreeRects(placed);
+	pruneFreeRects();
+	m_usedArea += static_cast<int64_t>(width) * height;
+	return true;
+}
+
+float
+MaxRectsPacker::getOccupancy() const {
+	const int64_t area = static_cast<int64_t>(m_width) * m_height;
+	return area > 0 ? static_cast<float>(m_usedArea) / area : 0.f;
+}
+
+void
+MaxRectsPacker::splitFreeRects(const sf::IntRect& used) {
+	const size_t count = m_freeRects.size();
+	for (size_t i = 0; i < count; ++i) {
+		const sf::IntRect free = m_freeRects[i];
+		if (!free.intersects(used)) {
+			continue;
+		}
+
+		// Up to four maximal rectangles around the used area
+		if (used.left > free.left) {
+			m_freeRects.push_back(sf::IntRect(free.left, free.top, used.left - free.left, free.height));
+		}
+		if (used.left + used.width < free.left + free.width) {
+			m_freeRects.push_back(sf::IntRect(used.left + used.width, free.top,
+				free.left + free.width - used.left - used.width, free.height));
+		}
+		if (used.top > free.top) {
+			m_freeRects.push_back(sf::IntRect(free.left, free.top, free.width, used.top - free.top));
+		}
+		if (used.top + used.height < free.top + free.height) {
+			m_freeRects.push_back(sf::IntRect(free.left, used.top + used.height,
+				free.width, free.top + free.height - used.top - used.height));
+		}
+		m_freeRects[i].width = 0; // Marked for removal
+	}
+	m_freeRects.erase(std::remove_if(m_freeRects.begin(), m_freeRects.end(),
+		[](const sf::IntRect& rect) { return rect.width == 0; }), m_freeRects.end());
+}
+
+void
+MaxRectsPacker::pruneFreeRects() {
+	auto contains = [](const sf::IntRect& outer, const sf::IntRect& inner) {
+		return inner.left >= outer.left && inner.top >= outer.top &&
+			inner.left + inner.width <= outer.left + outer.width &&
+			inner.top + inner.height <= outer.top + outer.height;
+	};
+
+	for (size_t i = 0; i < m_freeRects.size(); ++i) {
+		for (size_t j = i + 1; j < m_freeRects.size(); ++j) {
+			if (contains(m_freeRects[j], m_freeRects[i])) {
+				m_freeRects.erase(m_freeRects.begin() + i);
+				--i;
+				break;
+			}
+			if (contains(m_freeRects[i], m_freeRects[j])) {
+				m_freeRects.erase(m_freeRects.begin() + j);
+				--j;
+			}
+		}
+	}
+}
+
+void
+TextureAtlas::addImage(const std::string& name, const sf::Image& image) {
+	m_pending.push_back(PendingImage{ name, image });
+}
+
+bool
+TextureAtlas::addFile(const std::string& name, const std::string& path, const AssetArchive* archive) {
+	PendingImage pending;
+	pending.name = name;
+	AssetBlob blob = archive ? archive->find(path) : AssetBlob();
+	const bool decoded = blob
+		? pending.image.loadFromMemory(blob.data, blob.size)
+		: pending.image.loadFromFile(path);
+	if (!decoded) {
+		LOG_WARNING("TextureAtlas", "addFile", "Could not load " << path);
+		return false;
+	}
+	m_pending.push_back(std::move(pending));
+	return true;
+}
+
+bool
+TextureAtlas::build() {
+	if (m_pending.empty()) {
+		return true;
+	}
+
+	// Biggest first: MaxRects wastes less space that way
+	std::stable_sort(m_pending.begin(), m_pending.end(),
+		[](const PendingImage& a, const PendingImage& b) {
+			const sf::Vector2u sizeA = a.image.getSize();
+			const sf::Vector2u sizeB = b.image.getSize();
+			return std::max(sizeA.x, sizeA.y) > std::max(sizeB.x, sizeB.y);
+		});
+
+	const size_t firstPage = m_pages.size();
+	std::vector<MaxRectsPacker> packers;
+	std::vector<sf::Image> pageImages;
+	const int pageSize = static_cast<int>(m_pageSize);
+	const int border = static_cast<int>(m_padding);
+
+	for (const PendingImage& pending : m_pending) {
+		const sf::Vector2u size = pending.image.getSize();
+		const int width = static_cast<int>(size.x) + 2 * border;
+		const int height = static_cast<int>(size.y) + 2 * border;
+		if (size.x == 0 || size.y == 0 || width > pageSize || height > pageSize) {
+			LOG_WARNING("TextureAtlas", "build", pending.name << " does not fit in a "
+				<< m_pageSize << "x" << m_pageSize << " page");
+			continue;
+		}
+
+		// First page with room, else a new one
+		sf::IntRect placed;
+		size_t page = 0;
+		while (page < packers.size() && !packers[page].insert(width, height, placed)) {
+			++page;
+		}
+		if (page == packers.size()) {
+			packers.push_back(MaxRectsPacker(pageSize, pageSize));
+			pageImages.emplace_back();
+			pageImages.back().create(m_pageSize, m_pageSize, sf::Color::Transparent);
+			packers.back().insert(width, height, placed);
+		}
+
+		const unsigned int x = static_cast<unsigned int>(placed.left + border);
+		const unsigned int y = static_cast<unsigned int>(placed.top + border);
+		pageImages[page].copy(pending.image, x, y);
+		extrude(pageImages[page], pending.image, x, y);
+
+		AtlasRegion& region = m_regions[pending.name];
+		region.page = firstPage + page;
+		region.rect = sf::IntRect(static_cast<int>(x), static_cast<int>(y),
+			static_cast<int>(size.x), static_cast<int>(size.y));
+	}
+	m_pending.clear();
+
+	for (size_t i = 0; i < pageImages.size(); ++i) {
+		auto page = EngineUtilities::MakeShared<Texture>();
+		if (!page->loadFromImage(pageImages[i])) {
+			return false;
+		}
+		m_pages.push_back(page);
+		LOG_INFO("TextureAtlas", "build", "Page " << firstPage + i << ": "
+			<< static_cast<int>(packers[i].getOccupancy() * 100.f) << "% used");
+	}
+	for (auto& region : m_regions) {
+		if (region.second.page >= firstPage) {
+			region.second.texture = m_pages[region.second.page];
+		}
+	}
+	return true;
+}
+
+const AtlasRegion*
+TextureAtlas::findRegion(const std::string& name) const {
+	auto found = m_regions.find(name);
+	return found != m_regions.end() ? &found->second : nullptr;
+}
+
+bool
+TextureAtlas::save(const std::string& pathPrefix) const {
+	// Page files are named relative to the description file
+	const size_t slash = pathPrefix.find_last_of("/\\");
+	const std::string baseName = slash == std::string::npos ? pathPrefix : pathPrefix.substr(slash + 1);
+
+	std::ofstream description(pathPrefix + ".atlas");
+	if (!description) {
+		LOG_WARNING("TextureAtlas", "save", "Could not create " << pathPrefix << ".atlas");
+		return false;
+	}
+	description << "atlas 1\n";
+	for (size_t i = 0; i < m_pages.size(); ++i) {
+		const std::string pageName = baseName + "_" + std::to_string(i) + ".png";
+		if (!m_pages[i]->getTexture().copyToImage().saveToFile(pathPrefix + "_" + std::to_string(i) + ".png")) {
+			LOG_WARNING("TextureAtlas", "save", "Could not write page " << pageName);
+			return false;
+		}
+		description << "page " << pageName << "\n";
+	}
+
+	// Sorted, so the file does not change between runs
+	std::vector<const std::pair<const std::string, AtlasRegion>*> regions;
+	for (const auto& region : m_regions) {
+		regions.push_back(&region);
+	}
+	std::sort(regions.begin(), regions.end(),
+		[](const auto* a, const auto* b) { return a->first < b->first; });
+	for (const auto* region : regions) {
+		const sf::IntRect& rect = region->second.rect;
+		description << "region " << region->second.page << " " << rect.left << " " << rect.top
+			<< " " << rect.width << " " << rect.height << " " << region->first << "\n";
+	}
+	return static_cast<bool>(description);
+}
+
+bool
+TextureAtlas::load(const std::string& path, ResourceManager<Texture>& textures) {
+	std::string text;
+	const AssetArchive* archive = textures.getArchive();
+	AssetBlob blob = archive ? archive->find(path) : AssetBlob();
+	if (blob) {
+		text.assign(static_cast<const char*>(blob.data), blob.size);
+	}
+	else {
+		std::ifstream file(path);
+		if (!file) {
+			LOG_WARNING("TextureAtlas", "load", "Could not open " << path);
+			return false;
+		}
+		std::ostringstream contents;
+		contents << file.rdbuf();
+		text = contents.str();
+	}
+
+	m_pages.clear();
+	m_regions.clear();
+	const size_t slash = path.find_last_of("/\\");
+	const std::string directory = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+
+	std::istringstream lines(text);
+	std::string line;
+	while (std::getline(lines, line)) {
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		std::istringstream fields(line);
+		std::string kind;
+		fields >> kind;
+		if (kind == "page") {
+			std::string pageName;
+			fields >> pageName;
+			auto page = textures.load(directory + pageName);
+			if (page.isNull()) {
+				return false;
+			}
+			m_pages.push_back(page);
+		}
+		else if (kind == "region") {
+			AtlasRegion region;
+			std::string name;
+			fields >> region.page >> region.rect.left >> region.rect.top
+				>> region.rect.width >> region.rect.height >> std::ws;
+			if (!fields || !std::getline(fields, name) || region.page >= m_pages.size()) {
+				LOG_WARNING("TextureAtlas", "load", "Bad region in " << path << ": " << line);
+				continue;
+			}
+			region.texture = m_pages[region.page];
+			m_regions[name] = region;
+		}
+	}
+	LOG_INFO("TextureAtlas", "load", path << ": " << m_pages.size() << " pages, "
+		<< m_regions.size() << " regions");
+	return true;
+}
+
+void
+TextureAtlas::extrude(sf::Image& page, const sf::Image& image, unsigned int x, unsigned int y) const {
+	const sf::Vector2u size = image.getSize();
+	for (unsigned int k = 1; k <= m_padding; ++k) {
+		for (unsigned int i = 0; i < size.x; ++i) {
+			page.setPixel(x + i, y - k, image.getPixel(i, 0));
+			page.setPixel(x + i, y + size.y - 1 + k, image.getPixel(i, size.y - 1));
+		}
+		for (unsigned int j = 0; j < size.y; ++j) {
+			page.setPixel(x - k, y + j, image.getPixel(0, j));
+			page.setPixel(x + size.x - 1 + k, y + j, image.getPixel(size.x - 1, j));
+		}
+		// Corners
+		for (unsigned int l = 1; l <= m_padding; ++l) {
+			page.setPixel(x - k, y - l, image.getPixel(0, 0));
+			page.setPixel(x + size.x - 1 + k, y - l, image.getPixel(size.x - 1, 0));
+			page.setPixel(x - k, y + size.y - 1 + l, image.getPixel(0, size.y - 1));
+			page.setPixel(x + size.x - 1 + k, y + size.y - 1 + l, image.getPixel(size.x - 1, size.y - 1));
+		}
+	}
+}
@@ -0,0 +1,191 @@
+#include "TransformHierarchy.h"
+#include "ESC/Transform.h"
+#include <algorithm>
+#include <numeric>
+
+void
+TransformHierarchy::setParent(EntityID child, EntityID parent) {
+	if (child == INVALID_ENTITY || child == parent) {
+		ERROR("TransformHierarchy", "setParent", "An entity cannot be its own parent");
+	}
+
+	// Refuse links that would close a loop
+	for (EntityID ancestor = parent; ancestor != INVALID_ENTITY; ancestor = getParent(ancestor)) {
+		if (ancestor == child) {
+			ERROR("TransformHierarchy", "setParent", "Parent is a descendant of the child");
+		}
+	}
+
+	addNode(child);
+	if (parent != INVALID_ENTITY) {
+		addNode(parent);
+	}
+	m_parentOf[child] = parent;
+	m_relinked[child] = 1;
+	m_orderDirty = true;
+}
+
+EntityID
+TransformHierarchy::getParent(EntityID entity) const {
+	return entity < m_parentOf.size() ? m_parentOf[entity] : INVALID_ENTITY;
+}
+
+void
+TransformHierarchy::remove(EntityID entity) {
+	if (entity >= m_slotOf.size() || m_slotOf[entity] < 0) {
+		return;
+	}
+
+	for (EntityID node : m_entities) {
+		if (m_parentOf[node] == entity) {
+			m_parentOf[node] = INVALID_ENTITY;
+			m_relinked[node] = 1;
+		}
+	}
+
+	// Swap-remove; the order is sorted again on the next update
+	const size_t slot = static_cast<size_t>(m_slotOf[entity]);
+	const size_t last = m_entities.size() - 1;
+	if (slot != last) {
+		m_entities[slot] = m_entities[last];
+		m_worlds[slot] = m_worlds[last];
+		m_slotOf[m_entities[slot]] = static_cast<int32_t>(slot);
+	}
+	m_entities.pop_back();
+	m_parentSlots.pop_back();
+	m_versions.pop_back();
+	m_worlds.pop_back();
+	m_dirty.pop_back();
+
+	m_slotOf[entity] = -1;
+	m_parentOf[entity] = INVALID_ENTITY;
+	m_relinked[entity] = 0;
+	m_orderDirty = true;
+}
+
+void
+TransformHierarchy::update(World& world, float alpha) {
+	if (m_orderDirty) {
+		rebuildOrder();
+	}
+	m_changedChildren.clear();
+
+	// Parents come first, so their world matrix is final when a child reads it
+	const size_t count = m_entities.size();
+	for (size_t slot = 0; slot < count; ++slot) {
+		const EntityID entity = m_entities[slot];
+		const int32_t parentSlot = m_parentSlots[slot];
+		const bool parentDirty = parentSlot >= 0 && m_dirty[parentSlot];
+		const bool relinked = m_relinked[entity] != 0;
+		m_relinked[entity] = 0;
+
+		const Transform* transform = world.getComponent<Transform>(entity);
+		const bool localChanged = transform &&
+			(transform->getVersion() != m_versions[slot] || transform->isInterpolating());
+
+		if (!parentDirty && !localChanged && !relinked) {
+			m_dirty[slot] = 0;
+			continue;
+		}
+
+		const sf::Transform local = transform
+			? transform->getInterpolatedTransform(alpha)
+			: sf::Transform::Identity;
+		m_worlds[slot] = parentSlot >= 0 ? m_worlds[parentSlot] * local : local;
+		m_versions[slot] = transform ? transform->getVersion() : 0;
+		m_dirty[slot] = 1;
+
+		// Detached and orphaned roots are reported too, so their render
+		// components drop the old parent matrix
+		if (parentDirty || relinked) {
+			m_changedChildren.push_back(entity);
+		}
+	}
+}
+
+const sf::Transform&
+TransformHierarchy::getWorldTransform(EntityID entity) const {
+	if (entity >= m_slotOf.size() || m_slotOf[entity] < 0) {
+		return sf::Transform::Identity;
+	}
+	return m_worlds[m_slotOf[entity]];
+}
+
+const sf::Transform&
+TransformHierarchy::getParentWorldTransform(EntityID entity) const {
+	return getWorldTransform(getParent(entity));
+}
+
+void
+TransformHierarchy::addNode(EntityID entity) {
+	if (entity >= m_slotOf.size()) {
+		m_slotOf.resize(entity + 1, -1);
+		m_parentOf.resize(entity + 1, INVALID_ENTITY);
+		m_relinked.resize(entity + 1, 0);
+	}
+	if (m_slotOf[entity] >= 0) {
+		return;
+	}
+
+	m_slotOf[entity] = static_cast<int32_t>(m_entities.size());
+	m_entities.push_back(entity);
+	m_parentSlots.push_back(-1);
+	m_versions.push_back(0);
+	m_worlds.push_back(sf::Transform::Identity);
+	m_dirty.push_back(1);
+	m_orderDirty = true;
+}
+
+void
+TransformHierarchy::rebuildOrder() {
+	const size_t count = m_entities.size();
+
+	// Depth of every node, walking up only until a known depth is found
+	std::vector<int32_t> depth(count, -1);
+	std::vector<size_t> chain;
+	for (size_t slot = 0; slot < count; ++slot) {
+		size_t current = slot;
+		while (depth[current] < 0) {
+			chain.push_back(current);
+			EntityID parent = m_parentOf[m_entities[current]];
+			if (parent == INVALID_ENTITY) {
+				break;
+			}
+			current = static_cast<size_t>(m_slotOf[parent]);
+		}
+
+		int32_t base = depth[current] >= 0 ? depth[current] + 1 : 0;
+		while (!chain.empty()) {
+			depth[chain.back()] = base++;
+			chain.pop_back();
+		}
+	}
+
+	// Stable sort by depth keeps siblings in insertion order
+	std::vector<size_t> order(count);
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::stable_sort(order.begin(), order.end(),
+		[&depth](size_t a, size_t b) { return depth[a] < depth[b]; });
+
+	std::vector<EntityID> entities(count);
+	std::vector<sf::Transform> worlds(count);
+	for (size_t i = 0; i < count; ++i) {
+		entities[i] = m_entities[order[i]];
+		worlds[i] = m_worlds[order[i]];
+	}
+	m_entities.swap(entities);
+	m_worlds.swap(worlds);
+
+	for (size_t slot = 0; slot < count; ++slot) {
+		m_slotOf[m_entities[slot]] = static_cast<int32_t>(slot);
+	}
+	for (size_t slot = 0; slot < count; ++slot) {
+		EntityID parent = m_parentOf[m_entities[slot]];
+		m_parentSlots[slot] = parent == INVALID_ENTITY ? -1 : m_slotOf[parent];
+	}
+
+	// Links changed: recompute everything once
+	std::fill(m_versions.begin(), m_versions.end(), UINT32_MAX);
+	std::fill(m_dirty.begin(), m_dirty.end(), 1);
+	m_orderDirty = false;
+}
@@ -0,0 +1,512 @@
+#include "Utilities/VectorBatch.h"
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define VECTOR_BATCH_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define VECTOR_BATCH_AVX2
+#else
+#define VECTOR_BATCH_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace EngineUtilities {
+	namespace VectorBatch {
+		namespace {
+			// ========================
+			// Versin escalar
+			// ========================
+
+			void
+				addScalar(const float* ax, const float* ay, const float* bx, const float* by,
+					float* outX, float* outY, size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					outX[i] = ax[i] + bx[i];
+					outY[i] = ay[i] + by[i];
+				}
+			}
+
+			void
+				addScaledScalar(const float* ax, const float* ay, const float* bx, const float* by, float s,
+					float* outX, float* outY, size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					outX[i] = ax[i] + bx[i] * s;
+					outY[i] = ay[i] + by[i] * s;
+				}
+			}
+
+			void
+				scaleScalar(const float* x, const float* y, float s,
+					float* outX, float* outY, size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					outX[i] = x[i] * s;
+					outY[i] = y[i] * s;
+				}
+			}
+
+			void
+				lengthScalar(const float* x, const float* y, float* out, size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					out[i] = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+				}
+			}
+
+			void
+				distanceScalar(const float* ax, const float* ay, const float* bx, const float* by,
+					float* out, size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					float dx = ax[i] - bx[i];
+					float dy = ay[i] - by[i];
+					out[i] = std::sqrt(dx * dx + dy * dy);
+				}
+			}
+
+			void
+				normalizeScalar(const float* x, const float* y, float* outX, float* outY, size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					float len = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+					if (len != 0.f) {
+						outX[i] = x[i] / len;
+						outY[i] = y[i] / len;
+					}
+					else {
+						outX[i] = 0.f;
+						outY[i] = 0.f;
+					}
+				}
+			}
+
+			void
+				lerpScalar(const float* ax, const float* ay, const float* bx, const float* by, float t,
+					float* outX, float* outY, size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					outX[i] = ax[i] + (bx[i] - ax[i]) * t;
+					outY[i] = ay[i] + (by[i] - ay[i]) * t;
+				}
+			}
+
+			void
+				seekScalar(float* x, float* y, const float* targetX, const float* targetY,
+					float step, float range, uint8_t* moved, size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					float dx = targetX[i] - x[i];
+					float dy = targetY[i] - y[i];
+					float len = std::sqrt(dx * dx + dy * dy);
+					const bool move = len > range;
+					if (move) {
+						x[i] += dx / len * step;
+						y[i] += dy / len * step;
+					}
+					if (moved) {
+						moved[i] = move ? 1 : 0;
+					}
+				}
+			}
+
+#ifdef VECTOR_BATCH_X86
+			// ========================
+			// SSE2 (4 vectores por instruccin)
+			// ========================
+
+			/**
+			 * @brief 1 / sqrt(v): estimacin de rsqrtps (12 bits) ms un paso de
+			 * Newton-Raphson, con un error relativo por debajo de 5e-7.
+			 */
+			__m128
+				inverseSqrtSse2(__m128 v) {
+				const __m128 estimate = _mm_rsqrt_ps(v);
+				const __m128 half = _mm_mul_ps(_mm_set1_ps(0.5f), v);
+				const __m128 correction = _mm_sub_ps(_mm_set1_ps(1.5f),
+					_mm_mul_ps(half, _mm_mul_ps(estimate, estimate)));
+				return _mm_mul_ps(estimate, correction);
+			}
+
+			void
+				addSse2(const float* ax, const float* ay, const float* bx, const float* by,
+					float* outX, float* outY, size_t count) {
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					_mm_storeu_ps(outX + i, _mm_add_ps(_mm_loadu_ps(ax + i), _mm_loadu_ps(bx + i)));
+					_mm_storeu_ps(outY + i, _mm_add_ps(_mm_loadu_ps(ay + i), _mm_loadu_ps(by + i)));
+				}
+				addScalar(ax + i, ay + i, bx + i, by + i, outX + i, outY + i, count - i);
+			}
+
+			void
+				addScaledSse2(const float* ax, const float* ay, const float* bx, const float* by, float s,
+					float* outX, float* outY, size_t count) {
+				const __m128 factor = _mm_set1_ps(s);
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					_mm_storeu_ps(outX + i, _mm_add_ps(_mm_loadu_ps(ax + i), _mm_mul_ps(_mm_loadu_ps(bx + i), factor)));
+					_mm_storeu_ps(outY + i, _mm_add_ps(_mm_loadu_ps(ay + i), _mm_mul_ps(_mm_loadu_ps(by + i), factor)));
+				}
+				addScaledScalar(ax + i, ay + i, bx + i, by + i, s, outX + i, outY + i, count - i);
+			}
+
+			void
+				scaleSse2(const float* x, const float* y, float s,
+					float* outX, float* outY, size_t count) {
+				const __m128 factor = _mm_set1_ps(s);
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					_mm_storeu_ps(outX + i, _mm_mul_ps(_mm_loadu_ps(x + i), factor));
+					_mm_storeu_ps(outY + i, _mm_mul_ps(_mm_loadu_ps(y + i), factor));
+				}
+				scaleScalar(x + i, y + i, s, outX + i, outY + i, count - i);
+			}
+
+			void
+				lengthSse2(const float* x, const float* y, float* out, size_t count) {
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					__m128 vx = _mm_loadu_ps(x + i);
+					__m128 vy = _mm_loadu_ps(y + i);
+					__m128 squared = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+					_mm_storeu_ps(out + i, _mm_sqrt_ps(squared));
+				}
+				lengthScalar(x + i, y + i, out + i, count - i);
+			}
+
+			void
+				distanceSse2(const float* ax, const float* ay, const float* bx, const float* by,
+					float* out, size_t count) {
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					__m128 dx = _mm_sub_ps(_mm_loadu_ps(ax + i), _mm_loadu_ps(bx + i));
+					__m128 dy = _mm_sub_ps(_mm_loadu_ps(ay + i), _mm_loadu_ps(by + i));
+					__m128 squared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+					_mm_storeu_ps(out + i, _mm_sqrt_ps(squared));
+				}
+				distanceScalar(ax + i, ay + i, bx + i, by + i, out + i, count - i);
+			}
+
+			void
+				normalizeSse2(const float* x, const float* y, float* outX, float* outY, size_t count) {
+				const __m128 zero = _mm_setzero_ps();
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					__m128 vx = _mm_loadu_ps(x + i);
+					__m128 vy = _mm_loadu_ps(y + i);
+					__m128 squared = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+					__m128 inverse = inverseSqrtSse2(squared);
+
+					// Los vectores nulos daran 0 * inf: la mscara los deja en cero
+					__m128 valid = _mm_cmpneq_ps(squared, zero);
+					_mm_storeu_ps(outX + i, _mm_and_ps(valid, _mm_mul_ps(vx, inverse)));
+					_mm_storeu_ps(outY + i, _mm_and_ps(valid, _mm_mul_ps(vy, inverse)));
+				}
+				normalizeScalar(x + i, y + i, outX + i, outY + i, count - i);
+			}
+
+			void
+				lerpSse2(const float* ax, const float* ay, const float* bx, const float* by, float t,
+					float* outX, float* outY, size_t count) {
+				const __m128 factor = _mm_set1_ps(t);
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					__m128 vax = _mm_loadu_ps(ax + i);
+					__m128 vay = _mm_loadu_ps(ay + i);
+					__m128 dx = _mm_sub_ps(_mm_loadu_ps(bx + i), vax);
+					__m128 dy = _mm_sub_ps(_mm_loadu_ps(by + i), vay);
+					_mm_storeu_ps(outX + i, _mm_add_ps(vax, _mm_mul_ps(dx, factor)));
+					_mm_storeu_ps(outY + i, _mm_add_ps(vay, _mm_mul_ps(dy, factor)));
+				}
+				lerpScalar(ax + i, ay + i, bx + i, by + i, t, outX + i, outY + i, count - i);
+			}
+
+			void
+				seekSse2(float* x, float* y, const float* targetX, const float* targetY,
+					float step, float range, uint8_t* moved, size_t count) {
+				const __m128 vstep = _mm_set1_ps(step);
+				const __m128 vrangeSquared = _mm_set1_ps(range * range);
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					__m128 px = _mm_loadu_ps(x + i);
+					__m128 py = _mm_loadu_ps(y + i);
+					__m128 dx = _mm_sub_ps(_mm_loadu_ps(targetX + i), px);
+					__m128 dy = _mm_sub_ps(_mm_loadu_ps(targetY + i), py);
+					__m128 squared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+					// Solo avanzan las posiciones fuera del rango
+					__m128 move = _mm_cmpgt_ps(squared, vrangeSquared);
+					__m128 factor = _mm_mul_ps(inverseSqrtSse2(squared), vstep);
+					__m128 offsetX = _mm_and_ps(move, _mm_mul_ps(dx, factor));
+					__m128 offsetY = _mm_and_ps(move, _mm_mul_ps(dy, factor));
+					_mm_storeu_ps(x + i, _mm_add_ps(px, offsetX));
+					_mm_storeu_ps(y + i, _mm_add_ps(py, offsetY));
+
+					if (moved) {
+						int bits = _mm_movemask_ps(move);
+						for (int lane = 0; lane < 4; ++lane) {
+							moved[i + lane] = (bits >> lane) & 1;
+						}
+					}
+				}
+				seekScalar(x + i, y + i, targetX + i, targetY + i, step, range,
+					moved ? moved + i : nullptr, count - i);
+			}
+
+			// ========================
+			// AVX2 (8 vectores por instruccin)
+			// ========================
+
+			/**
+			 * @brief Igual que inverseSqrtSse2() con 8 valores.
+			 */
+			VECTOR_BATCH_AVX2 __m256
+				inverseSqrtAvx2(__m256 v) {
+				const __m256 estimate = _mm256_rsqrt_ps(v);
+				const __m256 half = _mm256_mul_ps(_mm256_set1_ps(0.5f), v);
+				const __m256 correction = _mm256_sub_ps(_mm256_set1_ps(1.5f),
+					_mm256_mul_ps(half, _mm256_mul_ps(estimate, estimate)));
+				return _mm256_mul_ps(estimate, correction);
+			}
+
+			VECTOR_BATCH_AVX2 void
+				addAvx2(const float* ax, const float* ay, const float* bx, const float* by,
+					float* outX, float* outY, size_t count) {
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					_mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_loadu_ps(ax + i), _mm256_loadu_ps(bx + i)));
+					_mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_loadu_ps(ay + i), _mm256_loadu_ps(by + i)));
+				}
+				addScalar(ax + i, ay + i, bx + i, by + i, outX + i, outY + i, count - i);
+			}
+
+			VECTOR_BATCH_AVX2 void
+				addScaledAvx2(const float* ax, const float* ay, const float* bx, const float* by, float s,
+					float* outX, float* outY, size_t count) {
+				const __m256 factor = _mm256_set1_ps(s);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					_mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_loadu_ps(ax + i), _mm256_mul_ps(_mm256_loadu_ps(bx + i), factor)));
+					_mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_loadu_ps(ay + i), _mm256_mul_ps(_mm256_loadu_ps(by + i), factor)));
+				}
+				addScaledScalar(ax + i, ay + i, bx + i, by + i, s, outX + i, outY + i, count - i);
+			}
+
+			VECTOR_BATCH_AVX2 void
+				scaleAvx2(const float* x, const float* y, float s,
+					float* outX, float* outY, size_t count) {
+				const __m256 factor = _mm256_set1_ps(s);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					_mm256_storeu_ps(outX + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), factor));
+					_mm256_storeu_ps(outY + i, _mm256_mul_ps(_mm256_loadu_ps(y + i), factor));
+				}
+				scaleScalar(x + i, y + i, s, outX + i, outY + i, count - i);
+			}
+
+			VECTOR_BATCH_AVX2 void
+				lengthAvx2(const float* x, const float* y, float* out, size_t count) {
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					__m256 vx = _mm256_loadu_ps(x + i);
+					__m256 vy = _mm256_loadu_ps(y + i);
+					__m256 squared = _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy));
+					_mm256_storeu_ps(out + i, _mm256_sqrt_ps(squared));
+				}
+				lengthScalar(x + i, y + i, out + i, count - i);
+			}
+
+			VECTOR_BATCH_AVX2 void
+				distanceAvx2(const float* ax, const float* ay, const float* bx, const float* by,
+					float* out, size_t count) {
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(ax + i), _mm256_loadu_ps(bx + i));
+					__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ay + i), _mm256_loadu_ps(by + i));
+					__m256 squared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+					_mm256_storeu_ps(out + i, _mm256_sqrt_ps(squared));
+				}
+				distanceScalar(ax + i, ay + i, bx + i, by + i, out + i, count - i);
+			}
+
+			VECTOR_BATCH_AVX2 void
+				normalizeAvx2(const float* x, const float* y, float* outX, float* outY, size_t count) {
+				const __m256 zero = _mm256_setzero_ps();
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					__m256 vx = _mm256_loadu_ps(x + i);
+					__m256 vy = _mm256_loadu_ps(y + i);
+					__m256 squared = _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy));
+					__m256 inverse = inverseSqrtAvx2(squared);
+					__m256 valid = _mm256_cmp_ps(squared, zero, _CMP_NEQ_UQ);
+					_mm256_storeu_ps(outX + i, _mm256_and_ps(valid, _mm256_mul_ps(vx, inverse)));
+					_mm256_storeu_ps(outY + i, _mm256_and_ps(valid, _mm256_mul_ps(vy, inverse)));
+				}
+				normalizeScalar(x + i, y + i, outX + i, outY + i, count - i);
+			}
+
+			VECTOR_BATCH_AVX2 void
+				lerpAvx2(const float* ax, const float* ay, const float* bx, const float* by, float t,
+					float* outX, float* outY, size_t count) {
+				const __m256 factor = _mm256_set1_ps(t);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					__m256 vax = _mm256_loadu_ps(ax + i);
+					__m256 vay = _mm256_loadu_ps(ay + i);
+					__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(bx + i), vax);
+					__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(by + i), vay);
+					_mm256_storeu_ps(outX + i, _mm256_add_ps(vax, _mm256_mul_ps(dx, factor)));
+					_mm256_storeu_ps(outY + i, _mm256_add_ps(vay, _mm256_mul_ps(dy, factor)));
+				}
+				lerpScalar(ax + i, ay + i, bx + i, by + i, t, outX + i, outY + i, count - i);
+			}
+
+			VECTOR_BATCH_AVX2 void
+				seekAvx2(float* x, float* y, const float* targetX, const float* targetY,
+					float step, float range, uint8_t* moved, size_t count) {
+				const __m256 vstep = _mm256_set1_ps(step);
+				const __m256 vrangeSquared = _mm256_set1_ps(range * range);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					__m256 px = _mm256_loadu_ps(x + i);
+					__m256 py = _mm256_loadu_ps(y + i);
+					__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(targetX + i), px);
+					__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(targetY + i), py);
+					__m256 squared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+					__m256 move = _mm256_cmp_ps(squared, vrangeSquared, _CMP_GT_OQ);
+					__m256 factor = _mm256_mul_ps(inverseSqrtAvx2(squared), vstep);
+					__m256 offsetX = _mm256_and_ps(move, _mm256_mul_ps(dx, factor));
+					__m256 offsetY = _mm256_and_ps(move, _mm256_mul_ps(dy, factor));
+					_mm256_storeu_ps(x + i, _mm256_add_ps(px, offsetX));
+					_mm256_storeu_ps(y + i, _mm256_add_ps(py, offsetY));
+
+					if (moved) {
+						int bits = _mm256_movemask_ps(move);
+						for (int lane = 0; lane < 8; ++lane) {
+							moved[i + lane] = (bits >> lane) & 1;
+						}
+					}
+				}
+				seekScalar(x + i, y + i, targetX + i, targetY + i, step, range,
+					moved ? moved + i : nullptr, count - i);
+			}
+
+			/**
+			 * @brief Comprueba que la CPU y el sistema operativo soportan AVX2.
+			 */
+			bool
+				hasAvx2() {
+#ifdef _MSC_VER
+				int info[4];
+				__cpuid(info, 0);
+				if (info[0] < 7) {
+					return false;
+				}
+
+				// AVX y OSXSAVE, y que el sistema guarda los registros YMM
+				__cpuid(info, 1);
+				const bool osxsave = (info[2] & (1 << 27)) != 0;
+				const bool avx = (info[2] & (1 << 28)) != 0;
+				if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+					return false;
+				}
+
+				__cpuidex(info, 7, 0);
+				return (info[1] & (1 << 5)) != 0;
+#else
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx2") != 0;
+#endif
+			}
+#endif
+
+			/**
+			 * @brief Tabla de funciones de la versin elegida.
+			 */
+			struct
+				Kernels {
+				const char* name;
+				decltype(&addScalar) add;
+				decltype(&addScaledScalar) addScaled;
+				decltype(&scaleScalar) scale;
+				decltype(&lengthScalar) length;
+				decltype(&distanceScalar) distance;
+				decltype(&normalizeScalar) normalize;
+				decltype(&lerpScalar) lerp;
+				decltype(&seekScalar) seek;
+			};
+
+			Kernels
+				selectKernels() {
+#ifdef VECTOR_BATCH_X86
+				if (hasAvx2()) {
+					return { "AVX2", addAvx2, addScaledAvx2, scaleAvx2, lengthAvx2, distanceAvx2,
+						normalizeAvx2, lerpAvx2, seekAvx2 };
+				}
+				return { "SSE2", addSse2, addScaledSse2, scaleSse2, lengthSse2, distanceSse2,
+					normalizeSse2, lerpSse2, seekSse2 };
+#else
+				return { "Scalar", addScalar, addScaledScalar, scaleScalar, lengthScalar, distanceScalar,
+					normalizeScalar, lerpScalar, seekScalar };
+#endif
+			}
+
+			/**
+			 * @brief Tabla elegida la primera vez que se usa (inicializacin segura entre hilos).
+			 */
+			const Kernels&
+				kernels() {
+				static const Kernels s_kernels = selectKernels();
+				return s_kernels;
+			}
+		}
+
+		const char*
+			getBackendName() {
+			return kernels().name;
+		}
+
+		void
+			add(const float* ax, const float* ay, const float* bx, const float* by,
+				float* outX, float* outY, size_t count) {
+			kernels().add(ax, ay, bx, by, outX, outY, count);
+		}
+
+		void
+			addScaled(const float* ax, const float* ay, const float* bx, const float* by, float scale,
+				float* outX, float* outY, size_t count) {
+			kernels().addScaled(ax, ay, bx, by, scale, outX, outY, count);
+		}
+
+		void
+			scale(const float* x, const float* y, float scale,
+				float* outX, float* outY, size_t count) {
+			kernels().scale(x, y, scale, outX, outY, count);
+		}
+
+		void
+			length(const float* x, const float* y, float* out, size_t count) {
+			kernels().length(x, y, out, count);
+		}
+
+		void
+			distance(const float* ax, const float* ay, const float* bx, const float* by,
+				float* out, size_t count) {
+			kernels().distance(ax, ay, bx, by, out, count);
+		}
+
+		void
+			normalize(const float* x, const float* y, float* outX, float* outY, size_t count) {
+			kernels().normalize(x, y, outX, outY, count);
+		}
+
+		void
+			lerp(const float* ax, const float* ay, const float* bx, const float* by, float t,
+				float* outX, float* outY, size_t count) {
+			kernels().lerp(ax, ay, bx, by, t, outX, outY, count);
+		}
+
+		void
+			seek(float* x, float* y, const float* targetX, const float* targetY,
+				float step, float range, uint8_t* moved, size_t count) {
+			kernels().seek(x, y, targetX, targetY, step, range, moved, count);
+		}
+	}
+}
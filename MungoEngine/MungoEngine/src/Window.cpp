@@ -42,6 +42,8 @@ Window::isOpen() const {
 void
 Window::clear(const sf::Color& color) {
 	if (!m_windowPtr.isNull()) {
+		m_batcher.clear();
+		m_batcher.resetStats();
 		m_windowPtr->clear(color);
 	}
 	else {
@@ -52,6 +54,9 @@ Window::clear(const sf::Color& color) {
 void
 Window::draw(const sf::Drawable& drawable, const sf::RenderStates& states) {
 	if (!m_windowPtr.isNull()) {
+		if (!m_batcher.isEmpty()) {
+			m_batcher.flush(*m_windowPtr);
+		}
 		m_windowPtr->draw(drawable, states);
 	}
 	else {
@@ -59,9 +64,16 @@ Window::draw(const sf::Drawable& drawable, const sf::RenderStates& states) {
 	}
 }
 
+void
+Window::drawBatched(const sf::Shape& shape, const sf::RenderStates& states) {
+	m_batcher.submit(shape, states);
+}
+
 void
 Window::display() {
+	PROFILE_SCOPE("Window::display");
 	if (!m_windowPtr.isNull()) {
+		m_batcher.flush(*m_windowPtr);
 		m_windowPtr->display();
 	}
 	else {
@@ -69,9 +81,55 @@ Window::display() {
 	}
 }
 
+void
+Window::setFramerateLimit(unsigned int limit) {
+	if (!m_windowPtr.isNull()) {
+		m_windowPtr->setFramerateLimit(limit);
+	}
+	else {
+		ERROR("Window", "setFramerateLimit", "Window is null");
+	}
+}
+
+void
+Window::setVerticalSyncEnabled(bool enabled) {
+	if (!m_windowPtr.isNull()) {
+		m_windowPtr->setVerticalSyncEnabled(enabled);
+	}
+	else {
+		ERROR("Window", "setVerticalSyncEnabled", "Window is null");
+	}
+}
+
+sf::FloatRect
+Window::getViewBounds() const {
+	if (m_windowPtr.isNull()) {
+		return sf::FloatRect();
+	}
+
+	const sf::View& view = m_windowPtr->getView();
+	sf::FloatRect local(view.getCenter() - view.getSize() / 2.f, view.getSize());
+	if (view.getRotation() == 0.f) {
+		return local;
+	}
+
+	sf::Transform rotation;
+	rotation.rotate(view.getRotation(), view.getCenter());
+	return rotation.transformRect(local);
+}
+
+sf::Vector2f
+Window::mapPixelToCoords(const sf::Vector2i& pixel) const {
+	if (m_windowPtr.isNull()) {
+		return sf::Vector2f(static_cast<float>(pixel.x), static_cast<float>(pixel.y));
+	}
+	return m_windowPtr->mapPixelToCoords(pixel);
+}
+
 void
 Window::update() {
 	deltaTime = m_clock.restart();
+	m_frameArena.reset();
 }
 
 void
@@ -1,7 +1,126 @@
 #include "BaseApp.h"
+#include "TextureAtlas.h"
+#include "Benchmark.h"
+#include <filesystem>
+
+/**
+ * @brief Writes a pack file from files and directories (--pack).
+ * @return Process exit code.
+ */
+static int
+	buildArchive(int argc, char* argv[], int first) {
+	AssetArchiveBuilder builder;
+	std::string archivePath;
+	for (int i = first; i < argc; ++i) {
+		const std::string argument = argv[i];
+		if (argument == "--compress") {
+			builder.setCompression(true);
+		}
+		else if (archivePath.empty()) {
+			archivePath = argument;
+		}
+		else if (std::filesystem::is_directory(argument)) {
+			builder.addDirectory(argument);
+		}
+		else {
+			builder.addFile(argument, argument);
+		}
+	}
+
+	const bool written = !archivePath.empty() && builder.write(archivePath);
+	Logger::getInstance().flush();
+	return written ? 0 : 1;
+}
+
+/**
+ * @brief Packs images into atlas pages plus a ".atlas" file (--atlas).
+ * @return Process exit code.
+ */
+static int
+	buildAtlas(int argc, char* argv[], int first) {
+	unsigned int pageSize = 2048;
+	std::string pathPrefix;
+	std::vector<std::string> images;
+	for (int i = first; i < argc; ++i) {
+		const std::string argument = argv[i];
+		if (argument == "--page-size" && i + 1 < argc) {
+			pageSize = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (pathPrefix.empty()) {
+			pathPrefix = argument;
+		}
+		else if (std::filesystem::is_directory(argument)) {
+			for (const auto& file : std::filesystem::recursive_directory_iterator(argument)) {
+				if (file.is_regular_file()) {
+					images.push_back(file.path().generic_string());
+				}
+			}
+		}
+		else {
+			images.push_back(argument);
+		}
+	}
+
+	// Regions are named by the image path, as the game would open it
+	TextureAtlas atlas(pageSize);
+	for (const std::string& image : images) {
+		atlas.addFile(image, image);
+	}
+	const bool written = !pathPrefix.empty() && atlas.build() && atlas.save(pathPrefix);
+	Logger::getInstance().flush();
+	return written ? 0 : 1;
+}
 
 int
-main() {
-	BaseApp app;
+main(int argc, char* argv[]) {
+	// --headless [frames] runs the simulation without a window
+	// --trace <file> writes the profiler zones as a Chrome trace on exit
+	// --archive <file> loads assets from a pack file
+	// --pack <file> [--compress] <files or directories...> writes a pack file and exits
+	// --atlas <prefix> [--page-size n] <images or directories...> writes an atlas and exits
+	// --bench <name|all|list> runs performance benchmarks and exits
+	AppBackend backend = WINDOWED;
+	uint64_t headlessFrames = 0;
+	std::string tracePath;
+	std::string archivePath;
+	for (int i = 1; i < argc; ++i) {
+		if (std::string(argv[i]) == "--headless") {
+			backend = HEADLESS;
+
+			// The frame count is optional: only a number is taken as one
+			if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+				char* end = nullptr;
+				const uint64_t frames = std::strtoull(argv[i + 1], &end, 10);
+				if (*end == '\0') {
+					headlessFrames = frames;
+					++i;
+				}
+			}
+		}
+		else if (std::string(argv[i]) == "--trace" && i + 1 < argc) {
+			tracePath = argv[++i];
+		}
+		else if (std::string(argv[i]) == "--archive" && i + 1 < argc) {
+			archivePath = argv[++i];
+		}
+		else if (std::string(argv[i]) == "--pack") {
+			return buildArchive(argc, argv, i + 1);
+		}
+		else if (std::string(argv[i]) == "--atlas") {
+			return buildAtlas(argc, argv, i + 1);
+		}
+		else if (std::string(argv[i]) == "--bench") {
+			return Benchmark::run(i + 1 < argc ? argv[i + 1] : "list");
+		}
+	}
+
+	BaseApp app(backend);
+	if (headlessFrames > 0) {
+		app.setHeadlessFrameCount(headlessFrames);
+	}
+	app.setTraceOutput(tracePath);
+	if (!archivePath.empty()) {
+		app.mountArchive(archivePath);
+	}
 	return app.run();
 }
\ No newline at end of file